@@ -11,561 +11,6353 @@
 
 //LOCAL LIBRARY VARIABLES/////////////////////////////////////
 //DEBUG RELATRED
+//TRACE POINTS ONLY WRITE BINARY RECORDS TO A RAM RING. A LOW PRIORITY TASK SENDS
+//THEM TO THE UART, SO NO CALLBACK EVER WAITS ON os_printf
 static uint8_t _esp8266_tcp_get_debug;
+#if ESP8266_TCP_GET_LOG_LEVEL > ESP8266_TCP_GET_LOG_LEVEL_NONE
+static ESP8266_TCP_GET_LOG _esp8266_tcp_get_log_ring;
+static os_event_t _esp8266_tcp_get_log_task_queue[ESP8266_TCP_GET_TASK_QUEUE_LENGTH];
+#endif
 
-//TCP RELATED
-static struct espconn _esp8266_tcp_get_espconn;
-static struct _esp_tcp _esp8266_tcp_get_user_tcp;
+//CONNECTION SCHEDULER RELATED
+//ALL INSTANCES SHARE THE LWIP TCP PCB BUDGET. CONNECTIONS BEYOND THE LIMIT
+//WAIT IN A FIFO UNTIL AN OPEN CONNECTION IS CLOSED
+static uint8_t _esp8266_tcp_get_max_connections = ESP8266_TCP_GET_MAX_CONCURRENT_CONNECTIONS;
+static uint8_t _esp8266_tcp_get_open_connections;
+static ESP8266_TCP_GET* _esp8266_tcp_get_waiting_head;
+static ESP8266_TCP_GET* _esp8266_tcp_get_waiting_tail;
 
-//IP / HOSTNAME RELATED
-static const char* _esp8266_tcp_get_host_name;
-static const char* _esp8266_tcp_get_host_ip;
-static ip_addr_t _esp8266_tcp_get_resolved_host_ip;
-static const char* _esp8266_tcp_get_host_path;
-static uint16_t _esp8266_tcp_get_host_port;
+//TLS RELATED
+//THE SDK SUPPORTS ONE SECURE CLIENT CONNECTION AT A TIME. SECURE INSTANCES
+//TAKE TURNS THROUGH THE SLOT QUEUE
+static ESP8266_TCP_GET* _esp8266_tcp_get_secure_owner;
+
+//DEFERRED PROCESSING RELATED
+//THE ESPCONN CALLBACKS ONLY QUEUE THEIR EVENTS. A system_os_task WORKER PARSES
+//THE DATA AND CALLS THE USER CALLBACKS OUTSIDE THE NETWORK STACK CALLBACK
+static uint8_t _esp8266_tcp_get_task_on;
+static uint8_t _esp8266_tcp_get_task_priority;
+static uint8_t _esp8266_tcp_get_task_posted;
+static os_event_t _esp8266_tcp_get_task_queue[ESP8266_TCP_GET_TASK_QUEUE_LENGTH];
+static ESP8266_TCP_GET_EVENT_QUEUE _esp8266_tcp_get_event_queue;
 
 //TIMER RELATED
-static volatile os_timer_t _esp8266_tcp_get_dns_timer;
-static volatile os_timer_t _esp8266_tcp_get_timer;
-static uint32_t _esp8266_tcp_get_timer_interval;
-static volatile os_timer_t _esp8266_tcp_reply_timeout_timer;
-
-//COUNTERS
-static uint16_t _esp8266_tcp_get_dns_retry_count;
-static uint32_t _esp8266_tcp_get_data_acquisition_count;
-
-//TCP OBJECT STATE
-static char* _esp8266_tcp_get_get_request_buffer;
-static ESP8266_TCP_GET_STATE _esp8266_tcp_get_state;
-
-//CALLBACK FUNCTION VARIABLES
-static void (*_esp8266_tcp_get_dns_cb_function)(ip_addr_t*);
-static void (*_esp8266_tcp_get_tcp_conn_cb)(void*);
-static void (*_esp8266_tcp_get_tcp_discon_cb)(void*);
-static void (*_esp8266_tcp_get_tcp_send_cb)(void*);
-static void (*_esp8266_tcp_get_tcp_recv_cb)(void*, char*, unsigned short);
-static void (*_esp8266_tcp_get_tcp_user_data_ready_cb)(ESP8266_TCP_GET_USER_DATA_CONTAINER*);
-
-//USER DATA RELATED
-static ESP8266_TCP_GET_USER_DATA_CONTAINER* _esp8266_user_data_container;
+//EVERY DEADLINE OF EVERY INSTANCE IS ON ONE TIMER WHEEL. A SINGLE os_timer WAKES
+//THE CPU FOR THE EARLIEST OF THEM
+static ESP8266_TCP_GET_WHEEL _esp8266_tcp_get_wheel;
+static volatile os_timer_t _esp8266_tcp_get_wheel_timer;
+
+//CONTENT DECODING RELATED
+//ORDER IN WHICH THE CODE LENGTH CODE LENGTHS ARE SENT (RFC 1951 3.2.7)
+static const uint8_t _esp8266_tcp_get_inflate_code_length_order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
 //END LOCAL LIBRARY VARIABLES/////////////////////////////////
 
 void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetDebug(uint8_t debug_on)
 {
-    //SET DEBUG PRINTF ON(1) OR OFF(0)
+    //SET DEBUG TRACE RECORDS ON(1) OR OFF(0). DEFAULT OFF
+    //THE RECORDS GO TO THE LOG RING (ESP8266_TCP_GET_SetLogDrain, ESP8266_TCP_GET_ReadLog)
+    //WHICH ONES EXIST AT ALL IS SET AT BUILD TIME BY ESP8266_TCP_GET_LOG_LEVEL
     
     _esp8266_tcp_get_debug = debug_on;
 }
 
-void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Initialize(const char* hostname,
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Initialize(ESP8266_TCP_GET* tcp_get, const char* hostname,
 													const char* host_ip,
 													uint16_t host_port,
 													const char* host_path,
 													uint32_t tcp_connection_interval_ms)
 {
-	//INITIALIZE TCP CONNECTION PARAMETERS
+	//INITIALIZE TCP CONNECTION PARAMETERS OF THE ESP8266_TCP_GET INSTANCE
 	//HOSTNAME (RESOLVED THROUGH DNS IF HOST IP = NULL)
 	//HOST IP
 	//HOST PORT
 	//HOST PATH
 	//TCP CONNECTION INTERVAL MS
+	//
+	//NOTE : MUST BE THE FIRST FUNCTION CALLED ON AN INSTANCE. THE INSTANCE
+	//MEMORY MUST STAY VALID (STATIC OR GLOBAL) FOR AS LONG AS IT IS USED
 
-	_esp8266_tcp_get_host_name = hostname;
-	_esp8266_tcp_get_host_ip = host_ip;
-	_esp8266_tcp_get_host_port = host_port;
-	_esp8266_tcp_get_host_path = host_path;
-	_esp8266_tcp_get_timer_interval = tcp_connection_interval_ms;
+	os_memset(tcp_get, 0, sizeof(ESP8266_TCP_GET));
 
-	_esp8266_tcp_get_data_acquisition_count = 0;
-	_esp8266_tcp_get_dns_retry_count = 0;
+	//ESPCONN CALLBACKS FIND THEIR INSTANCE THROUGH THE REVERSE POINTER
+	tcp_get->espconn.proto.tcp = &tcp_get->user_tcp;
+	tcp_get->espconn.reverse = tcp_get;
+	tcp_get->race_espconn.proto.tcp = &tcp_get->race_tcp;
+	tcp_get->race_espconn.reverse = tcp_get;
+	tcp_get->conn = &tcp_get->espconn;
 
-    //SET DEBUG ON
-    _esp8266_tcp_get_debug = 1;
-    
-	_esp8266_tcp_get_state = ESP8266_TCP_GET_STATE_OK;
-}
+	tcp_get->host_name = hostname;
+	tcp_get->host_ip = host_ip;
+	tcp_get->host_port = host_port;
+	tcp_get->host_path = host_path;
+	tcp_get->timer_interval = tcp_connection_interval_ms;
+	tcp_get->interval_min = tcp_connection_interval_ms;
+	tcp_get->interval_max = tcp_connection_interval_ms;
 
-void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Intialize_Request_Buffer(uint32_t buffer_size)
-{
-	//ALLOCATE THE ESP8266 TCP GET REQUEST BUFFER
+	tcp_get->data_acquisition_count = 0;
+	tcp_get->dns_retry_count = 0;
+	tcp_get->dns_cache.ttl_s = ESP8266_TCP_GET_DNS_CACHE_TTL_S;
+	tcp_get->conditional_get = 1;
+	tcp_get->inflate_window_size = ESP8266_TCP_GET_INFLATE_DEFAULT_WINDOW;
 
-	_esp8266_tcp_get_get_request_buffer = (char*)os_zalloc(buffer_size);
+	//ENTRY 0 OF THE CANDIDATE ADDRESSES IS THE HOST ADDRESS ONCE IT IS KNOWN
+	tcp_get->address_count = 1;
+	tcp_get->addresses[0].connect_ms = ESP8266_TCP_GET_ADDRESS_UNTRIED_MS;
+	tcp_get->connect_timeout_ms = ESP8266_TCP_GET_CONNECT_TIMEOUT_MS;
+	tcp_get->connect_stagger_ms = ESP8266_TCP_GET_CONNECT_STAGGER_MS;
 
-	//GENERATE THE GET STRING USING HOST-NAME & HOST-PATH
-	os_sprintf(_esp8266_tcp_get_get_request_buffer, ESP8266_TCP_GET_GET_REQUEST_STRING,
-			_esp8266_tcp_get_host_path, _esp8266_tcp_get_host_name);
+	//DEADLINES
+	_esp8266_tcp_get_timer_setup(&tcp_get->dns_timer, _esp8266_tcp_get_dns_timer_cb, tcp_get, ESP8266_TCP_GET_DEADLINE_DNS);
+	_esp8266_tcp_get_timer_setup(&tcp_get->timer, _esp8266_tcp_get_data_acquisition_timer_cb, tcp_get, ESP8266_TCP_GET_DEADLINE_CYCLE);
+	_esp8266_tcp_get_timer_setup(&tcp_get->reply_timeout_timer, _esp8266_tcp_get_receive_timeout_cb, tcp_get, ESP8266_TCP_GET_DEADLINE_REPLY);
+	_esp8266_tcp_get_timer_setup(&tcp_get->idle_timer, _esp8266_tcp_get_idle_timeout_cb, tcp_get, ESP8266_TCP_GET_DEADLINE_IDLE);
+	_esp8266_tcp_get_timer_setup(&tcp_get->connect_timer, _esp8266_tcp_get_connect_timer_cb, tcp_get, ESP8266_TCP_GET_DEADLINE_CONNECT);
 
-	if(_esp8266_tcp_get_debug)
-	{
-	    os_printf("GET STRING : %s\n", _esp8266_tcp_get_get_request_buffer);
-	}
+#if ESP8266_TCP_GET_LOG_LEVEL > ESP8266_TCP_GET_LOG_LEVEL_NONE
+	tcp_get->log_id = ++_esp8266_tcp_get_log_ring.instances;
+#endif
+
+	tcp_get->state = ESP8266_TCP_GET_STATE_OK;
 }
 
-void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Initialize_UserDataContainer(ESP8266_TCP_GET_USER_DATA_CONTAINER* container)
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Initialize_Arena(ESP8266_TCP_GET* tcp_get, uint32_t arena_size)
 {
-	//SET A LOCAL VARIABLE TO THE USER DATA CONTAINER STRUCTURE
+	//RESERVE THE INSTANCE MEMORY ARENA (BYTES)
+	//THE REQUEST BUFFER, THE DATA EXTRACTOR TABLES AND ALL PER-CYCLE SCRATCH SPACE
+	//ARE TAKEN FROM THIS SINGLE HEAP BLOCK. NOTHING IS ALLOCATED ON THE HEAP AFTER
+	//INITIALIZATION
 	//
-	//NOTE : THE EXTRACTED DATA ENDING CHAR IN DATA CONTAINER NEEDS TO BE NULL(\0) TERMINATED!
-	//NOTE : THE PACKET TERMINATING CHARS SEQUENCE IN DATA CONTAINER NEEDS TO BE NULL(\0) TERMINATED!
-
-	_esp8266_user_data_container = container;
+	//NOTE : OPTIONAL. MUST BE CALLED BEFORE ESP8266_TCP_GET_Intialize_Request_Buffer
+	//AND ESP8266_TCP_GET_Initialize_UserDataContainer. IF NOT CALLED, AN ARENA OF
+	//ESP8266_TCP_GET_ARENA_DEFAULT_SIZE IS RESERVED BY THE FIRST OF THEM
+	//USE ESP8266_TCP_GET_GetArenaHighWaterMark TO SIZE IT FOR THE APPLICATION
 
-	//SET THE DATA_FOUND FIELD OF ALL THE EXTRACTED_DATA STRUCTURES IN ESP8266_TCP_USER_DATA_CONTAINER TO
-	//DEFAULT VALUE 0 (NOT FOUND). ONLY THE FOUND DATA IN TCP REPLY WOULD BE SET TO 1 (DATA FOUND), REST
-	//WILL REMAIN 0 (NOT FOUND)
-	uint8_t i=0;
-	while(i < _esp8266_user_data_container->tcp_reply_extracted_data_count)
+	if(!_esp8266_tcp_get_arena_reserve(tcp_get, arena_size))
 	{
-		_esp8266_user_data_container->tcp_reply_extracted_data[i].data_found = 0;
-		i++;
+		tcp_get->state = ESP8266_TCP_GET_STATE_ERROR;
 	}
 }
 
-void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetDnsServer(char num_dns, ip_addr_t* dns)
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Intialize_Request_Buffer(ESP8266_TCP_GET* tcp_get, uint32_t buffer_size)
 {
-	//SET DNS SERVER RESOLVE HOSTNAME TO IP ADDRESS
-	//MAX OF 2 DNS SERVER SUPPORTED (num_dns)
+	//TAKE THE ESP8266 TCP GET REQUEST BUFFER FROM THE INSTANCE ARENA
+	//THE REQUEST IS BUILT ONCE HERE AND SENT AS IS EVERY CYCLE
 
-	if(num_dns == 1 || num_dns == 2)
+	if(tcp_get->get_request_buffer == NULL || buffer_size > tcp_get->get_request_buffer_size)
 	{
-		espconn_dns_setserver(num_dns, dns);
+		tcp_get->get_request_buffer = (char*)_esp8266_tcp_get_arena_alloc(tcp_get, buffer_size, 1);
+		if(tcp_get->get_request_buffer == NULL)
+		{
+			tcp_get->get_request_buffer_size = 0;
+			tcp_get->state = ESP8266_TCP_GET_STATE_ERROR;
+			return;
+		}
+		tcp_get->get_request_buffer_size = buffer_size;
 	}
-	return;
+
+	//GENERATE THE GET STRING USING HOST-NAME & HOST-PATH
+	_esp8266_tcp_get_build_request(tcp_get);
 }
 
-void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetCallbackFunctions(void (*tcp_con_cb)(void*),
-															void (*tcp_discon_cb)(void*),
-															void (tcp_send_cb)(void*),
-															void (tcp_recv_cb)(void*, char*, unsigned short),
-															void (user_data_ready_cb)(ESP8266_TCP_GET_USER_DATA_CONTAINER*))
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetIntervalBounds(ESP8266_TCP_GET* tcp_get, uint32_t min_interval_ms, uint32_t max_interval_ms)
 {
-	//HOOK FOR THE USER TO PROVIDE CALLBACK FUNCTIONS FOR
-	//VARIOUS INTERNAL TCP OPERATION
-	//SET THE CALLBACK FUNCTIONS FOR THE EVENTS:
-	//	(1) TCP CONNECT
-	//	(2) TCP DISCONNECT
-	//	(3) TCP RECONNECT
-	//	(4) TCP SEND
-	//	(5) TCP RECEIVE
-	//	(6) USER DATA READY
-	//IF A NULL FUNCTION POINTER IS PASSED FOR THE CB OF A PARTICULAR
-	//EVENT, THE DEFAULT CALLBACK FUNCTION IS CALLED FOR THAT EVENT
+	//LET THE DATA ACQUISITION INTERVAL ADAPT BETWEEN min_interval_ms AND max_interval_ms
+	//AFTER A REPLY WHOSE EXTRACTED DATA CHANGED THE INTERVAL IS HALVED (NOT BELOW MIN)
+	//AFTER AN UNCHANGED REPLY (OR 304) IT IS STRETCHED BY 1/4 (NOT ABOVE MAX)
+	//DEFAULT MIN = MAX = THE INTERVAL PASSED TO ESP8266_TCP_GET_Initialize (FIXED INTERVAL)
+	//FAILED CYCLES AND REPLIES WITHOUT DATA (3XX, 4XX, 5XX) BACK OFF EXPONENTIALLY INSTEAD
+	//
+	//NOTE : INTERVALS ARE MEASURED FROM THE END OF ONE CYCLE TO THE START OF THE NEXT
+	//NOTE : REDIRECTS ARE NOT FOLLOWED. A URL THAT MOVED KEEPS BACKING OFF UNTIL IT IS FIXED
 
-	/* TEMPORARY !!!!
-	if(user_data_ready_cb == NULL)
+	if(min_interval_ms == 0 || max_interval_ms < min_interval_ms)
 	{
-		//DO NOT PROCEED. NEED A USER DATA READY CALLBACK
-		//THROW ERROR
-
-		_esp8266_tcp_state = ESP8266_TCP_STATE_ERROR;
 		return;
 	}
-	*/
-	//TCP DATA READY USER CB
-	_esp8266_tcp_get_tcp_user_data_ready_cb = user_data_ready_cb;
-
-	//TCP CONNECT CB
-	_esp8266_tcp_get_tcp_conn_cb = tcp_con_cb;
-
-	//TCP DISCONNECT CB
-	_esp8266_tcp_get_tcp_discon_cb = tcp_discon_cb;
-
-	//TCP SEND CB
-	_esp8266_tcp_get_tcp_send_cb = tcp_send_cb;
-
-	//TCP RECEIVE CB
-	_esp8266_tcp_get_tcp_recv_cb = tcp_recv_cb;
+	tcp_get->interval_min = min_interval_ms;
+	tcp_get->interval_max = max_interval_ms;
 }
 
-uint32_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetDataAcquisitionInterval(void)
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetKeepAlive(ESP8266_TCP_GET* tcp_get, uint8_t keep_alive_on, uint32_t idle_timeout_ms)
 {
-	//RETURN ESP8266 TCP TIMER DATA ACQUISITION INTERVAL (MS)
+	//PERSISTENT CONNECTION MODE ON(1) OR OFF(0). DEFAULT OFF
+	//WHEN ON, THE GET REQUEST ASKS FOR "Connection: keep-alive" AND THE TCP CONNECTION
+	//IS KEPT OPEN AND REUSED FOR THE NEXT DATA ACQUISITION CYCLE. THE LIBRARY RECONNECTS
+	//ONLY WHEN THE SERVER CLOSES THE CONNECTION, OR WHEN THE CONNECTION HAS BEEN IDLE
+	//FOR idle_timeout_ms (0 = DEFAULT ESP8266_TCP_GET_KEEP_ALIVE_IDLE_TIMEOUT_MS)
+	//
+	//IDLE TIMEOUT SHOULD BE LONGER THAN THE DATA ACQUISITION INTERVAL
 
-	return _esp8266_tcp_get_timer_interval;
+	tcp_get->keep_alive = keep_alive_on;
+	tcp_get->keep_alive_idle_timeout_ms = (idle_timeout_ms != 0) ? idle_timeout_ms : ESP8266_TCP_GET_KEEP_ALIVE_IDLE_TIMEOUT_MS;
+
+	//REBUILD THE GET STRING IF IT HAS ALREADY BEEN GENERATED
+	if(tcp_get->get_request_buffer != NULL)
+	{
+		_esp8266_tcp_get_build_request(tcp_get);
+	}
 }
 
-const char* ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetSourceHost(void)
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetConditionalGet(ESP8266_TCP_GET* tcp_get, uint8_t conditional_on)
 {
-	//RETURN HOST NAME STRING
+	//CONDITIONAL GET ON(1) OR OFF(0). DEFAULT ON
+	//WHEN ON, THE ETag / Last-Modified OF THE LAST SUCCESSFUL REPLY ARE SENT BACK AS
+	//If-None-Match / If-Modified-Since. IF THE SOURCE HAS NOT CHANGED THE SERVER
+	//REPLIES 304 WITHOUT A BODY, EXTRACTION IS SKIPPED AND THE DATA READY CALLBACK
+	//GETS THE CONTAINER WITH tcp_reply_status = ESP8266_TCP_GET_REPLY_UNCHANGED
+
+	tcp_get->conditional_get = conditional_on;
+	if(!conditional_on)
+	{
+		tcp_get->etag[0] = '\0';
+		tcp_get->last_modified[0] = '\0';
+	}
 
-	return _esp8266_tcp_get_host_name;
+	//REBUILD THE CONDITIONAL PART OF THE GET STRING IF IT HAS ALREADY BEEN GENERATED
+	if(tcp_get->get_request_length != 0)
+	{
+		_esp8266_tcp_get_build_conditional(tcp_get);
+	}
 }
 
-const char* ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetSourcePath(void)
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetCompression(ESP8266_TCP_GET* tcp_get, uint8_t compression_on, uint32_t window_size)
 {
-	//RETURN HOST PATH STRING
+	//COMPRESSED REPLIES ON(1) OR OFF(0). DEFAULT OFF
+	//WHEN ON, THE GET REQUEST ADVERTISES "Accept-Encoding: gzip, deflate" AND A COMPRESSED
+	//BODY IS INFLATED SEGMENT BY SEGMENT ON ITS WAY TO THE DATA EXTRACTOR
+	//window_size = DECODER WINDOW IN BYTES (0 = DEFAULT ESP8266_TCP_GET_INFLATE_DEFAULT_WINDOW)
+	//ROUNDED DOWN TO A POWER OF 2 BETWEEN ESP8266_TCP_GET_INFLATE_MIN_WINDOW AND
+	//ESP8266_TCP_GET_INFLATE_MAX_WINDOW
+	//
+	//NOTE : THE WINDOW AND THE DECODER STATE (sizeof(ESP8266_TCP_GET_INFLATE)) ARE TAKEN
+	//FROM THE ARENA SCRATCH SPACE FOR EVERY COMPRESSED REPLY. SIZE THE ARENA FOR THEM
+	//NOTE : THE WINDOW MUST REACH AS FAR BACK AS THE SERVER'S COMPRESSOR REFERS. A WINDOW
+	//AT LEAST AS LARGE AS THE UNCOMPRESSED BODY ALWAYS DOES. IF A REPLY REFERS FURTHER
+	//BACK, THAT CYCLE FAILS AND COMPRESSION IS TURNED OFF FOR THE INSTANCE
 
-	return _esp8266_tcp_get_host_path;
-}
+	uint32_t size = ESP8266_TCP_GET_INFLATE_MAX_WINDOW;
 
-ESP8266_TCP_GET_STATE ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetState(void)
-{
-	//RETURN THE INTERNAL ESP8266 TCP STATE VARIABLE VALUE
+	if(window_size == 0)
+	{
+		window_size = ESP8266_TCP_GET_INFLATE_DEFAULT_WINDOW;
+	}
+	while(size > ESP8266_TCP_GET_INFLATE_MIN_WINDOW && size > window_size)
+	{
+		size >>= 1;
+	}
+	tcp_get->compression = compression_on;
+	tcp_get->inflate_window_size = size;
 
-	return _esp8266_tcp_get_state;
+	//REBUILD THE GET STRING IF IT HAS ALREADY BEEN GENERATED
+	if(tcp_get->get_request_buffer != NULL)
+	{
+		_esp8266_tcp_get_build_request(tcp_get);
+	}
 }
 
-void ICACHE_FLASH_ATTR ESP8266_TCP_GET_ResolveHostName(void (*user_dns_cb_fn)(ip_addr_t*))
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetSecure(ESP8266_TCP_GET* tcp_get, uint8_t secure_on, uint16_t buffer_size)
 {
-	//RESOLVE PROVIDED HOSTNAME USING THE SUPPLIED DNS SERVER
-	//AND CALL THE USER PROVIDED DNS DONE CB FUNCTION WHEN DONE
-
-	//DONE ONLY IF THE HOSTNAME SUPPLIED IN INITIALIZATION FUNCTION
-	//IS NOT NULL. IF NULL, USER SUPPLIED IP ADDRESS IS USED INSTEAD
-	//AND NO DNS REOSLUTION IS DONE
-
-	//SET USER DNS RESOLVE CB FUNCTION
-	_esp8266_tcp_get_dns_cb_function = user_dns_cb_fn;
-
-	//SET DNS RETRY COUNTER TO ZERO
-	_esp8266_tcp_get_dns_retry_count = 0;
+	//TLS (HTTPS) MODE ON(1) OR OFF(0). DEFAULT OFF
+	//WHEN ON, THE INSTANCE CONNECTS THROUGH THE SDK SECURE ESPCONN. SET THE PORT
+	//(USUALLY 443) IN ESP8266_TCP_GET_Initialize
+	//buffer_size = SSL BUFFER OF THE SDK IN BYTES (0 = DEFAULT ESP8266_TCP_GET_SECURE_DEFAULT_BUFFER)
+	//IT MUST HOLD THE LARGEST TLS RECORD THE SERVER SENDS
+	//
+	//NOTE : THE SDK DOES NOT EXPOSE TLS SESSION IDS / TICKETS, SO A NEW CONNECTION ALWAYS
+	//DOES A FULL HANDSHAKE. TURNING TLS ON THEREFORE ALSO TURNS KEEP-ALIVE ON (IF NOT
+	//ALREADY ON, WITH THE DEFAULT IDLE TIMEOUT) SO CYCLES REUSE THE OPEN TLS CONNECTION
+	//AND SKIP THE HANDSHAKE. THIS IS LOGGED AS ESP8266_TCP_GET_LOG_EVENT_SECURE_KEEP_ALIVE.
+	//CALL ESP8266_TCP_GET_SetKeepAlive AFTER THIS TO SET THE IDLE TIMEOUT (KEEP IT LONGER
+	//THAN THE DATA ACQUISITION INTERVAL), OR TO TURN KEEP-ALIVE OFF AGAIN AND DO A FULL
+	//HANDSHAKE EVERY CYCLE. stats.tls_full_handshakes AND stats.tls_cycles_on_open_connection
+	//COUNT BOTH CASES
+	//NOTE : ONLY ONE SECURE CONNECTION CAN BE OPEN AT A TIME. OTHER SECURE INSTANCES WAIT
+	//IN THE CONNECTION SLOT QUEUE UNTIL IT IS CLOSED
 
-	if(_esp8266_tcp_get_host_name != NULL)
+	if(tcp_get->connected)
 	{
-		//NEED TO DO DNS RESOLUTION
-
-		//START THE DNS RESOLVING PROCESS AND TIMER
-		struct espconn temp;
-		_esp8266_tcp_get_resolved_host_ip.addr = 0;
-		espconn_gethostbyname(&temp, _esp8266_tcp_get_host_name, &_esp8266_tcp_get_resolved_host_ip, _esp8266_tcp_get_dns_found_cb);
-		os_timer_setfn(&_esp8266_tcp_get_dns_timer, (os_timer_func_t*)_esp8266_tcp_get_dns_timer_cb, &temp);
-		os_timer_arm(&_esp8266_tcp_get_dns_timer, 1000, 0);
+		//NEVER SWITCH THE TRANSPORT UNDER AN OPEN CONNECTION
 		return;
 	}
 
-	//NO NEED TO DO DNS RESOLUTION. USE USER SUPPLIED IP ADDRESS STRING
-	_esp8266_tcp_get_resolved_host_ip.addr = ipaddr_addr(_esp8266_tcp_get_host_ip);
+	tcp_get->secure = secure_on;
+	if(!secure_on)
+	{
+		return;
+	}
 
-	_esp8266_tcp_get_state = ESP8266_TCP_GET_STATE_DNS_RESOLVED;
-	//CALL USER SUPPLIED DNS RESOLVE CB FUNCTION
-	(*_esp8266_tcp_get_dns_cb_function)(&_esp8266_tcp_get_resolved_host_ip);
+	espconn_secure_set_size(ESPCONN_CLIENT, (buffer_size != 0) ? buffer_size : ESP8266_TCP_GET_SECURE_DEFAULT_BUFFER);
+	if(!tcp_get->keep_alive)
+	{
+		ESP8266_TCP_GET_SetKeepAlive(tcp_get, 1, 0);
+		ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_SECURE_KEEP_ALIVE, 0, tcp_get->keep_alive_idle_timeout_ms);
+	}
 }
 
-uint16_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetSourcePort(void)
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetStreamMode(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_STREAM_MODE mode, uint32_t idle_timeout_ms)
 {
-	//RETURN HOST REMOTE PORT NUMBER
-
-	return _esp8266_tcp_get_host_port;
-}
+	//STREAMING MODE. DEFAULT ESP8266_TCP_GET_STREAM_OFF (INTERVAL POLLING)
+	//
+	//ESP8266_TCP_GET_STREAM_SSE : THE GET ASKS FOR text/event-stream AND THE REPLY IS KEPT
+	//OPEN. EVERY EVENT IS EXTRACTED ON ITS OWN (THE data LINES ARE THE TEXT THE USER DATA
+	//RULES / JSON PATHS RUN ON) AND THE DATA READY CALLBACK IS CALLED ONCE PER EVENT.
+	//WHEN THE STREAM ENDS THE INSTANCE RECONNECTS AFTER THE retry DELAY OF THE SERVER
+	//(DEFAULT ESP8266_TCP_GET_STREAM_RETRY_MS), SENDING THE id OF THE LAST EVENT AS
+	//Last-Event-ID SO THE SERVER CAN RESUME FROM THERE
+	//
+	//ESP8266_TCP_GET_STREAM_LONG_POLL : EVERY REPLY IS HANDLED AS USUAL, BUT THE NEXT
+	//REQUEST GOES OUT RIGHT AFTER IT INSTEAD OF AFTER THE INTERVAL
+	//
+	//idle_timeout_ms = LONGEST SILENCE FROM THE SERVER BEFORE THE CONNECTION IS TAKEN AS
+	//DEAD (0 = DEFAULT ESP8266_TCP_GET_STREAM_IDLE_TIMEOUT_MS). IT REPLACES THE REPLY
+	//TIMEOUT AND STARTS AGAIN WITH EVERY SEGMENT. KEEP IT LONGER THAN THE HEARTBEAT
+	//(COMMENT LINES) OF AN SSE SERVER, OR THE HOLD TIME OF A LONG-POLL SERVER
+	//
+	//FAILED CONNECTS AND ERROR REPLIES BACK OFF FROM THE RECONNECT DELAY. ONLY GET
+	//REQUESTS ARE STREAMED. NOTE : AN SSE STREAM HOLDS A CONNECTION SLOT FOR AS LONG
+	//AS IT IS OPEN
 
-void ICACHE_FLASH_ATTR ESP8266_TCP_GET_StartDataAcqusition(void)
-{
-	//START TCP DATA AQUISITION CYCLE
-	if(_esp8266_tcp_get_debug)
+	if(tcp_get->reply_pending)
 	{
-	    os_printf("ESP8266 TCP : DATA AQUISITION CYCLE START\n");
+		//NEVER SWITCH MODE UNDER A REPLY IN PROGRESS
+		return;
 	}
 
-	_esp8266_tcp_get_data_acquisition_count = 0;
+	tcp_get->stream_mode = mode;
+	tcp_get->stream_idle_timeout_ms = (idle_timeout_ms != 0) ? idle_timeout_ms : ESP8266_TCP_GET_STREAM_IDLE_TIMEOUT_MS;
+	tcp_get->stream_retry_ms = ESP8266_TCP_GET_STREAM_RETRY_MS;
+	tcp_get->last_event_id[0] = '\0';
 
-	//CREATE THE BASIC TCP GET REQUEST STRUCTURE AND OBJECTS
-	_esp8266_tcp_get_espconn.proto.tcp = &_esp8266_tcp_get_user_tcp;
-	_esp8266_tcp_get_espconn.type = ESPCONN_TCP;
-	_esp8266_tcp_get_espconn.state = ESPCONN_NONE;
+	//REBUILD THE GET STRING IF IT HAS ALREADY BEEN GENERATED
+	if(tcp_get->get_request_buffer != NULL)
+	{
+		_esp8266_tcp_get_build_request(tcp_get);
+	}
+}
 
-	os_memcpy(_esp8266_tcp_get_espconn.proto.tcp->remote_ip, (uint8_t*)(&_esp8266_tcp_get_resolved_host_ip.addr), 4);
-	_esp8266_tcp_get_espconn.proto.tcp->remote_port = _esp8266_tcp_get_host_port;
-	_esp8266_tcp_get_espconn.proto.tcp->local_port = espconn_port();
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetRequestMethod(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_METHOD method,
+														const char* content_type,
+														uint16_t (*producer_cb)(ESP8266_TCP_GET*, char*, uint16_t))
+{
+	//REQUEST METHOD. DEFAULT ESP8266_TCP_GET_METHOD_GET
+	//POST / PUT SEND A BODY WITH "Transfer-Encoding: chunked", SO ITS LENGTH NEED NOT BE
+	//KNOWN UP FRONT. content_type = Content-Type OF THE BODY (NULL = "text/plain")
+	//
+	//THE BODY IS STREAMED FROM producer_cb, ONE CHUNK EACH TIME THE PREVIOUS ONE HAS BEEN
+	//SENT. IT WRITES UP TO size BYTES TO buffer AND RETURNS THE COUNT. RETURNING 0 ENDS THE
+	//BODY. producer_cb = NULL SENDS THE READINGS OF THE UPLOAD QUEUE (ONE PER LINE)
+	//(ESP8266_TCP_GET_Initialize_UploadQueue)
+	//
+	//THE REPLY IS PARSED AND EXTRACTED LIKE THE REPLY OF A GET, SO ONE CYCLE CAN UPLOAD
+	//READINGS AND FETCH DATA ON THE SAME CONNECTION. CONDITIONAL HEADERS ARE NOT SENT
+	//
+	//NOTE : THE CHUNK BUFFER (ESP8266_TCP_GET_UPLOAD_CHUNK_SIZE) IS TAKEN FROM THE
+	//ARENA SCRATCH SPACE FOR EVERY REQUEST. SIZE THE ARENA FOR IT
+	//NOTE : CALL WHILE NO REPLY IS PENDING
 
-	espconn_regist_connectcb(&_esp8266_tcp_get_espconn, _esp8266_tcp_get_connect_cb);
-	espconn_regist_disconcb(&_esp8266_tcp_get_espconn, _esp8266_tcp_get_disconnect_cb);
+	tcp_get->method = method;
+	tcp_get->content_type = (content_type != NULL) ? content_type : ESP8266_TCP_GET_UPLOAD_DEFAULT_CONTENT_TYPE;
+	tcp_get->upload_producer_cb = producer_cb;
 
-	if(_esp8266_tcp_get_debug)
+	//REBUILD THE REQUEST STRING IF IT HAS ALREADY BEEN GENERATED
+	if(tcp_get->get_request_buffer != NULL)
 	{
-	    os_printf("ESP8266 TCP : SETUP TCP OBJECT. STARTING ACQUISITION TIMER WITH INTERVAL = %dms\n", _esp8266_tcp_get_timer_interval);
+		_esp8266_tcp_get_build_request(tcp_get);
 	}
+}
+
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Initialize_UploadQueue(ESP8266_TCP_GET* tcp_get, uint16_t queue_bytes,
+																uint16_t batch_count,
+																uint32_t batch_ms)
+{
+	//TAKE A QUEUE OF queue_bytes FROM THE INSTANCE ARENA FOR READINGS WAITING TO BE
+	//UPLOADED (ESP8266_TCP_GET_QueueReading). EACH READING NEEDS ITS LENGTH + 1 BYTES
+	//
+	//EVERY CYCLE SENDS ALL THE QUEUED READINGS IN ONE REQUEST. A CYCLE WITH NOTHING TO
+	//UPLOAD (AND NO SUBSCRIBER DUE) DOES NOT CONNECT AT ALL. THE NEXT CYCLE IS BROUGHT
+	//FORWARD WHEN batch_count READINGS ARE QUEUED OR THE OLDEST HAS WAITED batch_ms
+	//(0 = NO LIMIT), SO SET THE INTERVAL LONG AND LET THE BATCH DECIDE WHEN THE RADIO
+	//WAKES. NOT WHILE BACKING OFF AFTER A FAILED CYCLE
+	//
+	//READINGS ARE REMOVED ONLY WHEN THE SERVER REPLIES 2XX (4XX DISCARDS THEM AS
+	//REJECTED). AFTER A FAILED, 3XX OR 5XX CYCLE THEY ARE SENT AGAIN BY THE NEXT ONE
 
-	//START THE ACQUISITION TIMER
-	os_timer_setfn(&_esp8266_tcp_get_timer, (os_timer_func_t*)_esp8266_tcp_get_data_acquisition_timer_cb, NULL);
-	os_timer_arm(&_esp8266_tcp_get_timer, _esp8266_tcp_get_timer_interval, 1);
+	ESP8266_TCP_GET_UPLOAD_QUEUE* queue = &tcp_get->upload_queue;
 
-	if(_esp8266_tcp_get_debug)
+	if(queue->buffer == NULL || queue_bytes > queue->size)
 	{
-	    os_printf("ESP8266 TCP : STARTING DATA ACQUISITION CYCLE = %d\n", _esp8266_tcp_get_data_acquisition_count++);
+		queue->buffer = (char*)_esp8266_tcp_get_arena_alloc(tcp_get, queue_bytes, 1);
+		if(queue->buffer == NULL)
+		{
+			queue->size = 0;
+			tcp_get->state = ESP8266_TCP_GET_STATE_ERROR;
+			return;
+		}
+		queue->size = queue_bytes;
+		queue->length = 0;
+		queue->count = 0;
 	}
-
-	espconn_connect(&_esp8266_tcp_get_espconn);
+	queue->batch_count = batch_count;
+	queue->batch_ms = batch_ms;
 }
 
-void ICACHE_FLASH_ATTR ESP8266_TCP_GET_StopDataAcquisition(void)
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Initialize_UserDataContainer(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_USER_DATA_CONTAINER* container)
 {
-	//STOP TCP DATA AQUISITION CYCLE
+	//SET A LOCAL VARIABLE TO THE USER DATA CONTAINER STRUCTURE
+	//
+	//NOTE : THE EXTRACTED DATA ENDING CHAR IN DATA CONTAINER NEEDS TO BE NULL(\0) TERMINATED!
+	//NOTE : THE PACKET TERMINATING CHARS SEQUENCE IN DATA CONTAINER NEEDS TO BE NULL(\0) TERMINATED!
 
-	if(_esp8266_tcp_get_debug)
+	tcp_get->user_data_container = container;
+
+	//SET THE DATA_FOUND FIELD OF ALL THE EXTRACTED_DATA STRUCTURES IN ESP8266_TCP_USER_DATA_CONTAINER TO
+	//DEFAULT VALUE 0 (NOT FOUND). ONLY THE FOUND DATA IN TCP REPLY WOULD BE SET TO 1 (DATA FOUND), REST
+	//WILL REMAIN 0 (NOT FOUND)
+	uint8_t i=0;
+	while(i < tcp_get->user_data_container->tcp_reply_extracted_data_count)
 	{
-	    os_printf("data acquisition stopped at cycle %d\n", _esp8266_tcp_get_data_acquisition_count);
+		tcp_get->user_data_container->tcp_reply_extracted_data[i].data_found = 0;
+		i++;
 	}
 
-	_esp8266_tcp_get_data_acquisition_count = 0;
-
-	//DISARM THE TIMER
-	os_timer_disarm(&_esp8266_tcp_get_timer);
+	//COMPILE ALL THE MATCH STRINGS (AND THE PACKET TERMINATING CHARS) INTO THE
+	//EXTRACTOR AUTOMATON SO EACH REPLY BYTE IS SCANNED EXACTLY ONCE
+	if(!_esp8266_tcp_get_extractor_compile(tcp_get))
+	{
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_EXTRACTOR_NOT_SET_UP, 0, 0);
+		tcp_get->state = ESP8266_TCP_GET_STATE_ERROR;
+	}
 }
 
-void ICACHE_FLASH_ATTR _esp8266_tcp_get_dns_timer_cb(void* arg)
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Subscribe(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_SUBSCRIBER* subscriber,
+													ESP8266_TCP_GET_USER_DATA_CONTAINER* container,
+													uint32_t max_staleness_ms,
+													void (*data_ready_cb)(ESP8266_TCP_GET*, ESP8266_TCP_GET_USER_DATA_CONTAINER*))
 {
-	//ESP8266 DNS CHECK TIMER CALLBACK FUNCTIONS
-	//TIME PERIOD = 1 SEC
+	//ADD A SUBSCRIBER TO THE DATA OF THIS INSTANCE (SAME URL)
+	//EACH SUBSCRIBER HAS ITS OWN CONTAINER AND CALLBACK AND WANTS DATA NO OLDER THAN
+	//max_staleness_ms (UP TO ESP8266_TCP_GET_SUBSCRIBER_MAX_STALENESS_MS). ONE FETCH
+	//SERVES EVERY SUBSCRIBER WHOSE DATA IS AT LEAST HALF WAY TO STALE, SO SUBSCRIBERS
+	//WITH DIFFERENT RATES SHARE FETCHES INSTEAD OF EACH RUNNING ITS OWN. THE MATCH
+	//STRINGS OF ALL OF THEM ARE EXTRACTED IN ONE PASS OVER THE REPLY
+	//
+	//THE CALLBACK IS CALLED AFTER EACH FETCH MADE FOR THE SUBSCRIBER, WITH THE CONTAINER
+	//(tcp_reply_status SET AS FOR THE MAIN CONTAINER) OR NULL IF THE FETCH FAILED.
+	//SUBSCRIBERS THE FETCH WAS NOT FOR KEEP THEIR DATA AND ARE NOT CALLED
+	//
+	//NOTE : THE SUBSCRIBER AND CONTAINER MEMORY MUST STAY VALID UNTIL UNSUBSCRIBED.
+	//THE MAIN CONTAINER (IF ANY) IS STILL FETCHED EVERY CYCLE AT THE INSTANCE INTERVAL
+	//NOTE : THE EXTRACTOR IS REBUILT IN THE ARENA, IN THE SAME SPACE AT ITS TOP, SO
+	//SUBSCRIBING AND UNSUBSCRIBING DO NOT USE UP THE ARENA. SIZE IT FOR ALL SUBSCRIBERS
 
-	//DNS TIMER CB CALLED IE. DNS RESOLUTION DID NOT WORK
-	//DO ANOTHER DNS CALL AND RE-ARM THE TIMER
+	ESP8266_TCP_GET_SUBSCRIBER** link = &tcp_get->subscribers;
+	uint8_t i;
 
-	_esp8266_tcp_get_dns_retry_count++;
-	if(_esp8266_tcp_get_dns_retry_count == ESP8266_TCP_GET_DNS_MAX_TRIES)
+	//FIND THE END OF THE LIST. SUBSCRIBING AGAIN REPLACES THE EARLIER SUBSCRIPTION
+	while(*link != NULL)
 	{
-		//NO MORE DNS TRIES TO BE DONE
-		//STOP THE DNS TIMER
-		os_timer_disarm(&_esp8266_tcp_get_dns_timer);
-
-		if(_esp8266_tcp_get_debug)
+		if(*link == subscriber)
 		{
-		    os_printf("DNS Max retry exceeded. DNS unsuccessfull\n");
+			*link = subscriber->next;
+			continue;
 		}
-
-		_esp8266_tcp_get_state = ESP8266_TCP_GET_STATE_ERROR;
-		//CALL USER DNS CB FUNCTION WILL NULL ARGUMENT)
-		if(*_esp8266_tcp_get_dns_cb_function != NULL)
-		{
-			(*_esp8266_tcp_get_dns_cb_function)(NULL);
-		}
-		return;
+		link = &(*link)->next;
 	}
 
-	if(_esp8266_tcp_get_debug)
+	os_memset(subscriber, 0, sizeof(ESP8266_TCP_GET_SUBSCRIBER));
+	subscriber->container = container;
+	subscriber->data_ready_cb = data_ready_cb;
+	subscriber->max_staleness_ms = (max_staleness_ms < ESP8266_TCP_GET_SUBSCRIBER_MAX_STALENESS_MS) ?
+										max_staleness_ms : ESP8266_TCP_GET_SUBSCRIBER_MAX_STALENESS_MS;
+	for(i = 0; i < container->tcp_reply_extracted_data_count; i++)
 	{
-	    os_printf("DNS resolve timer expired. Starting another timer of 1 second...\n");
+		container->tcp_reply_extracted_data[i].data_found = 0;
 	}
 
-	struct espconn *pespconn = arg;
-	espconn_gethostbyname(pespconn, _esp8266_tcp_get_host_name, &_esp8266_tcp_get_resolved_host_ip, _esp8266_tcp_get_dns_found_cb);
-	os_timer_arm(&_esp8266_tcp_get_dns_timer, 1000, 0);
+	//APPEND, SO THE FIELDS OF EARLIER SUBSCRIBERS KEEP THEIR PLACE
+	*link = subscriber;
+	_esp8266_tcp_get_subscribers_changed(tcp_get);
+
+	//A NEW SUBSCRIBER HAS NO DATA YET. FETCH RIGHT AWAY
+	if(tcp_get->acquisition_running && !tcp_get->cycle_active)
+	{
+		_esp8266_tcp_get_timer_arm(&tcp_get->timer, 1);
+	}
 }
 
-void ICACHE_FLASH_ATTR _esp8266_tcp_get_dns_found_cb(const char* name, ip_addr_t* ipAddr, void* arg)
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Unsubscribe(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_SUBSCRIBER* subscriber)
 {
-	//ESP8266 TCP DNS RESOLVING DONE CALLBACK FUNCTION
+	//REMOVE A SUBSCRIBER. ITS CALLBACK IS NOT CALLED AGAIN
+	//
+	//NOTE : IF A REPLY IS IN PROGRESS, ITS CONTAINER MAY STILL BE WRITTEN UNTIL THAT REPLY ENDS
 
-	//DISABLE THE DNS TIMER
-	os_timer_disarm(&_esp8266_tcp_get_dns_timer);
+	ESP8266_TCP_GET_SUBSCRIBER** link = &tcp_get->subscribers;
 
-	if(ipAddr == NULL)
+	while(*link != NULL && *link != subscriber)
 	{
-		//HOST NAME COULD NOT BE RESOLVED
-		if(_esp8266_tcp_get_debug)
-		{
-		    os_printf("hostname : %s, could not be resolved\n", _esp8266_tcp_get_host_name);
-		}
-
-		_esp8266_tcp_get_state = ESP8266_TCP_GET_STATE_ERROR;
-		//CALL USER PROVIDED DNS CB FUNCTION WITH NULL PARAMETER
-		if(*_esp8266_tcp_get_dns_cb_function != NULL)
-		{
-			(*_esp8266_tcp_get_dns_cb_function)(NULL);
-		}
-		return;
+		link = &(*link)->next;
 	}
-
-	//DNS GOT IP
-	_esp8266_tcp_get_resolved_host_ip.addr = ipAddr->addr;
-	if(_esp8266_tcp_get_debug)
+	if(*link == NULL)
 	{
-	    os_printf("hostname : %s, resolved. IP = %d.%d.%d.%d\n", _esp8266_tcp_get_host_name,
-																    *((uint8_t*)&_esp8266_tcp_get_resolved_host_ip.addr),
-																    *((uint8_t*)&_esp8266_tcp_get_resolved_host_ip.addr + 1),
-																    *((uint8_t*)&_esp8266_tcp_get_resolved_host_ip.addr + 2),
-																    *((uint8_t*)&_esp8266_tcp_get_resolved_host_ip.addr + 3));
+		return;
 	}
+	*link = subscriber->next;
+	subscriber->due = 0;
+	_esp8266_tcp_get_subscribers_changed(tcp_get);
+}
 
-	_esp8266_tcp_get_state = ESP8266_TCP_GET_STATE_DNS_RESOLVED;
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetDoubleBuffer(ESP8266_TCP_GET_USER_DATA_CONTAINER* container, ESP8266_TCP_GET_EXTRACTED_DATA* back_data)
+{
+	//DOUBLE BUFFER THE EXTRACTED DATA OF A USER DATA CONTAINER (MAIN OR SUBSCRIBER)
+	//back_data = SECOND ARRAY OF tcp_reply_extracted_data_count ENTRIES (STATIC OR GLOBAL)
+	//THE FIELD DEFINITIONS ARE COPIED INTO IT. NULL = SINGLE BUFFER (DEFAULT)
+	//
+	//A REPLY IS EXTRACTED INTO THE BACK BUFFER. WHEN IT COMPLETES THE TWO ARE SWAPPED,
+	//tcp_reply_extracted_data POINTS AT THE NEW DATA AND tcp_reply_sequence IS INCREMENTED.
+	//PUBLISHED DATA IS NOT WRITTEN UNTIL THE REPLY AFTER THE NEXT ONE STARTS, AND A FAILED
+	//REPLY (OR ONE WITH A STATUS OTHER THAN 2XX / 304) LEAVES IT AS IT WAS, SO READERS NEED NO COPY
+	//
+	//NOTE : ALWAYS READ THROUGH container->tcp_reply_extracted_data. COMPARE
+	//tcp_reply_sequence BEFORE AND AFTER READING TO DETECT A PUBLISH IN BETWEEN
+	//NOTE : CALL WHILE NO REPLY IS PENDING
 
-	//CALL USER PROVIDED DNS CB FUNCTION
-	if(*_esp8266_tcp_get_dns_cb_function != NULL)
+	if(back_data != NULL)
 	{
-		(*_esp8266_tcp_get_dns_cb_function)(&_esp8266_tcp_get_resolved_host_ip);
+		os_memcpy(back_data, container->tcp_reply_extracted_data,
+					container->tcp_reply_extracted_data_count * sizeof(ESP8266_TCP_GET_EXTRACTED_DATA));
 	}
+	container->tcp_reply_back_data = back_data;
 }
 
-void ICACHE_FLASH_ATTR _esp8266_tcp_get_connect_cb(void* arg)
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetRuleTable(ESP8266_TCP_GET* tcp_get, const ESP8266_TCP_GET_RULE_TABLE* rule_table)
 {
-	//TCP CONNECT CALLBACK
+	//TAKE THE USER DATA RULES FROM A FLASH TABLE GENERATED BY tools/esp8266_tcp_get_rules.py
+	//INSTEAD OF COMPILING THE MATCH STRINGS OF THE CONTAINERS AT RUNTIME. NULL = RUNTIME (DEFAULT)
+	//
+	//THE AUTOMATON, MATCH STRINGS AND FIELD RULES ARE READ FROM FLASH IN PLACE. THE TABLE
+	//FIELDS MAP IN ORDER TO THE MAIN CONTAINER FIELDS AND THEN TO THE FIELDS OF EACH
+	//SUBSCRIBER IN SUBSCRIPTION ORDER. THE PACKET TERMINATING CHARS ALSO COME FROM THE TABLE
+	//
+	//NOTE : CALL BEFORE ESP8266_TCP_GET_Initialize_UserDataContainer. NOTHING IS EXTRACTED
+	//WHILE THE FIELD COUNT OF THE CONTAINERS DOES NOT MATCH THE TABLE
 
-	if(_esp8266_tcp_get_debug)
+	tcp_get->rule_table = rule_table;
+	if(tcp_get->user_data_container != NULL || tcp_get->subscribers != NULL)
 	{
-	    os_printf("ESP8266 TCP : TCP CONNECTED\n");
+		_esp8266_tcp_get_subscribers_changed(tcp_get);
 	}
+}
 
-	//GET THE NEW USER TCP CONNECTION
-	struct espconn *pespconn = arg;
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetStopWhenAllDataFound(ESP8266_TCP_GET* tcp_get, uint8_t stop_on)
+{
+	//END THE REPLY (AND DISCONNECT) AS SOON AS ALL THE USER DATA IN THE DATA
+	//CONTAINER HAS BEEN FOUND, WITHOUT WAITING FOR THE REST OF THE REPLY
+	//ON(1) OR OFF(0). DEFAULT OFF
 
-	//REGISTER SEND AND RECEIVE CALLBACKS
-	espconn_regist_sentcb(pespconn, _esp8266_tcp_get_send_cb);
-	espconn_regist_recvcb(pespconn, _esp8266_tcp_get_receive_cb);
+	tcp_get->stop_when_all_found = stop_on;
+}
 
-	//SEND USER DATA (GET REQUEST)
-	char* pbuf = (char*)os_zalloc(2*2048);
-	os_sprintf(pbuf, _esp8266_tcp_get_get_request_buffer,
-						pespconn->proto.tcp->remote_ip[0], pespconn->proto.tcp->remote_ip[1],
-						pespconn->proto.tcp->remote_ip[2], pespconn->proto.tcp->remote_ip[3]);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetJsonMode(ESP8266_TCP_GET* tcp_get, uint8_t json_on)
+{
+	//JSON EXTRACTION MODE ON(1) OR OFF(0). DEFAULT OFF
+	//WHEN ON, THE REPLY BODY IS PARSED AS JSON AND THE extracted_data_start_match_string
+	//OF EACH FIELD IS A KEY PATH, FOR EXAMPLE "main.temp" OR "list[0].dt" ("" = THE
+	//WHOLE BODY). THE FIRST VALUE AT THAT PATH IS EXTRACTED, WHEREVER IT IS IN THE
+	//DOCUMENT AND HOWEVER IT IS FORMATTED
+	//
+	//STRING VALUES ARE COPIED WITHOUT QUOTES, OTHER VALUES AS SENT. NUMBERS ARE ALSO
+	//CONVERTED TO extracted_value WITH extracted_value_decimals FIXED POINT DECIMALS
+	//(12.345 WITH 2 DECIMALS = 1234). extracted_data_char_len (IF NOT 0) LIMITS THE
+	//COPIED TEXT. OFFSET AND TERMINATING CHAR ARE NOT USED
+	//
+	//NOTE : KEYS CONTAINING '.' OR '[' CAN NOT BE ADDRESSED. ONLY THE FIRST
+	//ESP8266_TCP_GET_JSON_MAX_DEPTH NESTING LEVELS CAN BE MATCHED
 
-	//SEND DATA AND DEALLOCATE BUFFER
-	espconn_sent(pespconn, pbuf, os_strlen(pbuf));
-	os_free(pbuf);
+	tcp_get->json_mode = json_on;
+}
 
-	//CALL USER CALLBACK IF NOT NULL
-	if(_esp8266_tcp_get_tcp_conn_cb != NULL)
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetDnsServer(char num_dns, ip_addr_t* dns)
+{
+	//SET DNS SERVER RESOLVE HOSTNAME TO IP ADDRESS
+	//MAX OF 2 DNS SERVER SUPPORTED (num_dns)
+	//DNS SERVERS ARE SHARED BY ALL INSTANCES
+
+	if(num_dns == 1 || num_dns == 2)
 	{
-		(*_esp8266_tcp_get_tcp_conn_cb)(arg);
+		espconn_dns_setserver(num_dns, dns);
 	}
+	return;
 }
 
-void ICACHE_FLASH_ATTR _esp8266_tcp_get_disconnect_cb(void* arg)
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetDnsCacheTtl(ESP8266_TCP_GET* tcp_get, uint32_t ttl_s)
 {
-	//TCP DISCONNECT CALLBACK
+	//SET HOW LONG (SECONDS) A RESOLVED ADDRESS IS USED BEFORE IT IS REFRESHED
+	//IN THE BACKGROUND. DEFAULT ESP8266_TCP_GET_DNS_CACHE_TTL_S
+	//
+	//NOTE : ESPCONN DOES NOT EXPOSE THE RECORD TTL. LWIP KEEPS ITS OWN TABLE BY THE
+	//RECORD TTL, SO A REFRESH BEFORE THAT EXPIRES IS ANSWERED LOCALLY AND ONE AFTER
+	//IT GOES TO THE SERVER. SET THIS CLOSE TO THE RECORD TTL OF THE HOST
 
-	if(_esp8266_tcp_get_debug)
+	if(ttl_s == 0)
 	{
-	    os_printf("ESP8266 TCP : TCP DISCONNECTED\n");
+		ttl_s = ESP8266_TCP_GET_DNS_CACHE_TTL_S;
 	}
-
-	//CALL USER CALLBACK IF NOT NULL
-	if(_esp8266_tcp_get_tcp_discon_cb != NULL)
+	if(ttl_s > ESP8266_TCP_GET_DNS_CACHE_MAX_TTL_S)
 	{
-		(*_esp8266_tcp_get_tcp_discon_cb)(arg);
+		//A HOST THAT MOVES IS STILL REACHED AT ITS OLD ADDRESS UNTIL THE NEXT REFRESH.
+		//REFRESHING AT LEAST HOURLY BOUNDS THAT, AND COSTS LITTLE WHILE LWIP STILL HAS
+		//THE RECORD. IT ALSO KEEPS ttl_s * 1000 WELL INSIDE THE uint32_t ms OF A DEADLINE
+		ttl_s = ESP8266_TCP_GET_DNS_CACHE_MAX_TTL_S;
 	}
+	tcp_get->dns_cache.ttl_s = ttl_s;
 }
 
-void ICACHE_FLASH_ATTR _esp8266_tcp_get_send_cb(void* arg)
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SeedDnsCache(ESP8266_TCP_GET* tcp_get, ip_addr_t* ip)
 {
-	//TCP SENT DATA SUCCESSFULLY CALLBACK
+	//SEED THE RESOLVED ADDRESS CACHE WITH A PERSISTED ENTRY (FROM
+	//ESP8266_TCP_GET_GetDnsCacheEntry BEFORE THE LAST RESET)
+	//ESP8266_TCP_GET_ResolveHostName THEN COMPLETES IMMEDIATELY WITH THIS ADDRESS
+	//AND CONFIRMS IT WITH A BACKGROUND LOOKUP
+	//
+	//NOTE : CALL AFTER ESP8266_TCP_GET_Initialize AND BEFORE ESP8266_TCP_GET_ResolveHostName
 
-	if(_esp8266_tcp_get_debug)
+	if(ip == NULL || ip->addr == 0)
 	{
-	    os_printf("ESP8266 TCP : TCP DATA SENT\n");
+		return;
 	}
+	tcp_get->dns_cache.ip.addr = ip->addr;
+	tcp_get->dns_cache.state = ESP8266_TCP_GET_DNS_CACHE_STALE;
+}
+
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetConnectTimeout(ESP8266_TCP_GET* tcp_get, uint32_t timeout_ms, uint32_t stagger_ms)
+{
+	//SET THE CONNECT DEADLINE (ms) OF A CYCLE. IF NO CANDIDATE ADDRESS HAS CONNECTED BY
+	//THEN THE CYCLE FAILS. DEFAULT ESP8266_TCP_GET_CONNECT_TIMEOUT_MS (0 = DEFAULT)
+	//stagger_ms = HOW LONG AN ATTEMPT MAY STALL BEFORE THE NEXT ADDRESS IS TRIED ALONGSIDE
+	//IT. THE FIRST ONE TO CONNECT IS KEPT. DEFAULT ESP8266_TCP_GET_CONNECT_STAGGER_MS
+	//0 = NEXT ADDRESS ONLY AFTER AN ATTEMPT FAILS
+	//
+	//NOTE : A RACE TAKES A SECOND TCP PCB FOR UP TO stagger_ms. IT STILL COUNTS AS ONE
+	//CONNECTION SLOT. A SECURE INSTANCE NEVER RACES (ONE TLS CONNECTION AT A TIME). ITS
+	//STALLED ATTEMPT IS GIVEN UP BEFORE THE NEXT ADDRESS IS TRIED
 
-	//SET AND THE TCP GET REPLY TIMEOUT TIMER
-	os_timer_setfn(&_esp8266_tcp_reply_timeout_timer, (os_timer_func_t*)_esp8266_tcp_get_receive_timeout_cb, NULL);
-	os_timer_arm(&_esp8266_tcp_reply_timeout_timer, ESP8266_TCP_GET_REPLY_TIMEOUT_MS, 0);
-	if(_esp8266_tcp_get_debug)
+	if(timeout_ms == 0)
 	{
-		os_printf("ESP8266 TCP : Started 5 second reply timeout timer\n");
+		timeout_ms = ESP8266_TCP_GET_CONNECT_TIMEOUT_MS;
 	}
-
-	//CALL USER CALLBACK IF NOT NULL
-	if(_esp8266_tcp_get_tcp_send_cb != NULL)
+	if(timeout_ms > ESP8266_TCP_GET_BACKOFF_MAX_MS)
 	{
-		(*_esp8266_tcp_get_tcp_send_cb)(arg);
+		timeout_ms = ESP8266_TCP_GET_BACKOFF_MAX_MS;
 	}
+	tcp_get->connect_timeout_ms = timeout_ms;
+	tcp_get->connect_stagger_ms = stagger_ms;
 }
 
-void ICACHE_FLASH_ATTR _esp8266_tcp_get_receive_cb(void* arg, char* pusrdata, unsigned short length)
+uint8_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_AddServerAddress(ESP8266_TCP_GET* tcp_get, ip_addr_t* ip)
 {
-	//TCP RECEIVED DATA CALLBACK
+	//ADD A FAILOVER ADDRESS OF THE SERVER (SAME PORT, PATH AND HOST HEADER)
+	//THE RESOLVED (OR USER SUPPLIED) HOST ADDRESS IS ALWAYS A CANDIDATE TOO
+	//RETURN 0 IF ip IS NOT VALID OR ALL ESP8266_TCP_GET_MAX_ADDRESSES ENTRIES ARE TAKEN
+
+	ESP8266_TCP_GET_ADDRESS* address;
+	uint8_t i;
 
-	if(_esp8266_tcp_get_debug)
+	if(ip == NULL || ip->addr == 0)
 	{
-	    os_printf("ESP8266 TCP : TCP DATA RECEIVED\n");
+		return 0;
 	}
-
-	//PROCESS INCOMING TCP DATA
-
-	//CHECK FOR USER DATA IN THE REPLY
-	char* ptr;
-	uint8_t counter = 0;
-
-	while(counter < _esp8266_user_data_container->tcp_reply_extracted_data_count)
+	for(i = 1; i < tcp_get->address_count; i++)
 	{
-		if((ptr = strstr(pusrdata, (_esp8266_user_data_container->tcp_reply_extracted_data[counter]).extracted_data_start_match_string)) != NULL)
+		if(tcp_get->addresses[i].ip.addr == ip->addr)
 		{
-			//DATA FOUND
-			char* data = (char*)os_zalloc(256);
-
-			//ADVANCE THE POINTER TO DATA LOCATION
-			ptr += (_esp8266_user_data_container->tcp_reply_extracted_data[counter]).extracted_data_offset_from_match_string;
-
-			//LOOP TO GET DATA
-			if((_esp8266_user_data_container->tcp_reply_extracted_data[counter]).extracted_data_char_len == 0)
-			{
-				//NEED TO LOOP TILL WE FIND DATA TERMINATING CHARACTER
-				uint8_t i=0;
-				while(ptr[i] != (_esp8266_user_data_container->tcp_reply_extracted_data[counter]).extracted_data_terminating_char)
-				{
-					data[i] = ptr[i];
-					i++;
-				}
-			}
-			else
-			{
-				//NEED TO LOOP A FIXED NUMBER OF TIMER
-				uint8_t i;
-				for(i=0; i<(_esp8266_user_data_container->tcp_reply_extracted_data[counter]).extracted_data_char_len; i++)
-				{
-					data[i] = ptr[i];
-				}
-			}
-			//ASSIGN THE DATA POINTER
-			strcpy((_esp8266_user_data_container->tcp_reply_extracted_data[counter]).extracted_data, data);
-			(_esp8266_user_data_container->tcp_reply_extracted_data[counter]).data_found = 1;
-
-			//FREE THE DATA BUFFER
-			os_free(data);
-			if(_esp8266_tcp_get_debug)
-			{
-			    os_printf("data found = %s\n", (_esp8266_user_data_container->tcp_reply_extracted_data[counter]).extracted_data);
-			}
+			return 1;
 		}
-		counter++;
 	}
-
-	//CALL USER CALLBACK IF NOT NULL
-	if(_esp8266_tcp_get_tcp_recv_cb != NULL)
+	if(tcp_get->address_count >= ESP8266_TCP_GET_MAX_ADDRESSES)
 	{
-		(*_esp8266_tcp_get_tcp_recv_cb)(arg, pusrdata, length);
+		return 0;
 	}
 
-	//CHECK FOR PACKET ENDING CONDITION
-	if(strstr(pusrdata, _esp8266_user_data_container->tcp_reply_packet_terminating_chars) != NULL)
-	{
-		//END OF PACKET
-		//DISCONNECT TCP CONNECTION
-		espconn_disconnect(&_esp8266_tcp_get_espconn);
+	address = &tcp_get->addresses[tcp_get->address_count++];
+	os_memset(address, 0, sizeof(ESP8266_TCP_GET_ADDRESS));
+	address->ip.addr = ip->addr;
+	address->connect_ms = ESP8266_TCP_GET_ADDRESS_UNTRIED_MS;
+	return 1;
+}
 
-		//STOP TCP GET REPLY TIMEOUT TIMER
-		os_timer_disarm(&_esp8266_tcp_reply_timeout_timer);
-		if(_esp8266_tcp_get_debug)
-		{
-			os_printf("ESP8266 TCP : TCP get reply timeout timer stopped\n");
-		}
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetMaxConcurrentConnections(uint8_t max_connections)
+{
+	//SET THE MAXIMUM NUMBER OF TCP CONNECTIONS ALL INSTANCES TOGETHER MAY HAVE OPEN AT
+	//ONCE. KEEP BELOW THE LWIP TCP PCB BUDGET (MEMP_NUM_TCP_PCB) LESS ANY CONNECTIONS
+	//THE APPLICATION OPENS ITSELF. INSTANCES OVER THE LIMIT WAIT FOR A FREE SLOT
+	//DEFAULT = ESP8266_TCP_GET_MAX_CONCURRENT_CONNECTIONS
 
-		//CALL USER SPECIFIED DATA READY CALLBACK
-		(*_esp8266_tcp_get_tcp_user_data_ready_cb)(_esp8266_user_data_container);
-	}
+	_esp8266_tcp_get_max_connections = (max_connections != 0) ? max_connections : 1;
 }
 
-void ICACHE_FLASH_ATTR _esp8266_tcp_get_receive_timeout_cb(void)
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetDeferredProcessing(uint8_t task_priority, uint16_t queue_depth, uint16_t queue_bytes)
 {
-	//CALLBACK FOR TCP GET REPLY TIMEOUT TIMER
-	//IF CALLED => TCP GET REPLY NOT RECEIVED IN SET TIME
-	if(_esp8266_tcp_get_debug)
+	//TURN ON DEFERRED PROCESSING FOR ALL INSTANCES. DEFAULT OFF
+	//THE ESPCONN CALLBACKS THEN ONLY COPY EACH RECEIVED SEGMENT INTO A FIXED RING AND
+	//QUEUE IT. A system_os_task WORKER AT task_priority (USER_TASK_PRIO_0 TO 2) DOES THE
+	//PARSING, DATA EXTRACTION AND ALL USER CALLBACKS (EXCEPT THE CONNECT / SENT ONES)
+	//queue_depth = EVENTS (0 = DEFAULT ESP8266_TCP_GET_DEFERRED_DEFAULT_DEPTH)
+	//queue_bytes = BYTE RING FOR THE SEGMENT DATA (0 = DEFAULT ESP8266_TCP_GET_DEFERRED_DEFAULT_BYTES)
+	//
+	//NOTE : CALL ONCE, BEFORE ANY INSTANCE CONNECTS. THE TASK PRIORITY MUST NOT BE USED
+	//BY ANOTHER system_os_task OF THE APPLICATION
+	//NOTE : A SEGMENT THAT DOES NOT FIT IS DROPPED AND ITS REPLY FAILS. SIZE THE RING FOR
+	//A FEW TCP SEGMENTS (MSS 1460) PER INSTANCE. WATCH ESP8266_TCP_GET_GetQueueStats
+	//NOTE : SEGMENTS ALREADY QUEUED ARE STILL PASSED TO A BUSY BODY SINK
+
+	ESP8266_TCP_GET_EVENT_QUEUE* queue = &_esp8266_tcp_get_event_queue;
+
+	if(_esp8266_tcp_get_task_on)
 	{
-		os_printf("ESP8266 TCP : TCP get reply timeout !\n");
+		return;
 	}
 
-	//DISCONNECT THE TCP CONNECTION TO END THE CURRENT TRANSACTION
-	espconn_disconnect(&_esp8266_tcp_get_espconn);
-
-	////CALL USER SPECIFIED DATA READY CALLBACK WITH NULL ARGUMENT
-	(*_esp8266_tcp_get_tcp_user_data_ready_cb)(NULL);
-}
+	queue_depth = (queue_depth != 0) ? queue_depth : ESP8266_TCP_GET_DEFERRED_DEFAULT_DEPTH;
+	queue_bytes = (queue_bytes != 0) ? queue_bytes : ESP8266_TCP_GET_DEFERRED_DEFAULT_BYTES;
 
-void ICACHE_FLASH_ATTR _esp8266_tcp_get_data_acquisition_timer_cb(void* arg)
+	queue->events = (ESP8266_TCP_GET_EVENT*)os_zalloc(queue_depth * sizeof(ESP8266_TCP_GET_EVENT));
+	queue->bytes = (uint8_t*)os_zalloc(queue_bytes);
+	if(queue->events == NULL || queue->bytes == NULL)
+	{
+		ESP8266_TCP_GET_LOG_ERROR(NULL, ESP8266_TCP_GET_LOG_EVENT_QUEUE_ALLOC_FAILED, 0, 0);
+		if(queue->events != NULL)
+		{
+			os_free(queue->events);
+			queue->events = NULL;
+		}
+		if(queue->bytes != NULL)
+		{
+			os_free(queue->bytes);
+			queue->bytes = NULL;
+		}
+		return;
+	}
+	queue->stats.depth = queue_depth;
+	queue->stats.bytes_size = queue_bytes;
+
+	_esp8266_tcp_get_task_priority = task_priority;
+	system_os_task(_esp8266_tcp_get_task, task_priority, _esp8266_tcp_get_task_queue, ESP8266_TCP_GET_TASK_QUEUE_LENGTH);
+	_esp8266_tcp_get_task_on = 1;
+}
+
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetLogDrain(uint8_t task_priority, void (*write_fn)(uint8_t*, uint16_t))
+{
+	//SEND THE LOG RECORDS TO write_fn (FOR EXAMPLE uart0_tx_buffer OF THE SDK UART DRIVER)
+	//FROM A system_os_task AT task_priority (USER_TASK_PRIO_0 TO 2). USE THE LOWEST FREE
+	//PRIORITY SO RECORDS ARE SENT ONLY WHEN NOTHING ELSE IS WAITING. EACH RUN OF THE TASK
+	//SENDS AT MOST ESP8266_TCP_GET_LOG_DRAIN_BATCH RECORDS IN ONE CALL TO write_fn
+	//tools/esp8266_tcp_get_log.py TURNS THE OUTPUT BACK INTO TEXT
+	//
+	//NOTE : CALL ONCE. THE TASK PRIORITY MUST NOT BE USED BY ANOTHER system_os_task,
+	//INCLUDING THE ONE OF ESP8266_TCP_GET_SetDeferredProcessing
+	//NOTE : WITHOUT A DRAIN THE RECORDS STAY IN THE RING FOR ESP8266_TCP_GET_ReadLog
+
+#if ESP8266_TCP_GET_LOG_LEVEL > ESP8266_TCP_GET_LOG_LEVEL_NONE
+	ESP8266_TCP_GET_LOG* log = &_esp8266_tcp_get_log_ring;
+
+	if(log->task_on || write_fn == NULL)
+	{
+		return;
+	}
+
+	log->write_fn = write_fn;
+	log->task_priority = task_priority;
+	system_os_task(_esp8266_tcp_get_log_task, task_priority, _esp8266_tcp_get_log_task_queue, ESP8266_TCP_GET_TASK_QUEUE_LENGTH);
+	log->task_on = 1;
+
+	//SEND WHAT WAS LOGGED BEFORE
+	if(log->count != 0)
+	{
+		log->task_posted = system_os_post(log->task_priority, 0, 0);
+	}
+#endif
+}
+
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetCallbackFunctions(ESP8266_TCP_GET* tcp_get, void (*tcp_con_cb)(void*),
+															void (*tcp_discon_cb)(void*),
+															void (tcp_send_cb)(void*),
+															void (tcp_recv_cb)(void*, char*, unsigned short),
+															void (user_data_ready_cb)(ESP8266_TCP_GET*, ESP8266_TCP_GET_USER_DATA_CONTAINER*))
+{
+	//HOOK FOR THE USER TO PROVIDE CALLBACK FUNCTIONS FOR
+	//VARIOUS INTERNAL TCP OPERATION
+	//SET THE CALLBACK FUNCTIONS FOR THE EVENTS:
+	//	(1) TCP CONNECT
+	//	(2) TCP DISCONNECT
+	//	(3) TCP RECONNECT
+	//	(4) TCP SEND
+	//	(5) TCP RECEIVE
+	//	(6) USER DATA READY
+	//IF A NULL FUNCTION POINTER IS PASSED FOR THE CB OF A PARTICULAR
+	//EVENT, THE DEFAULT CALLBACK FUNCTION IS CALLED FOR THAT EVENT
+
+	/* TEMPORARY !!!!
+	if(user_data_ready_cb == NULL)
+	{
+		//DO NOT PROCEED. NEED A USER DATA READY CALLBACK
+		//THROW ERROR
+
+		_esp8266_tcp_state = ESP8266_TCP_STATE_ERROR;
+		return;
+	}
+	*/
+	//TCP DATA READY USER CB
+	tcp_get->user_data_ready_cb = user_data_ready_cb;
+
+	//TCP CONNECT CB
+	tcp_get->tcp_conn_cb = tcp_con_cb;
+
+	//TCP DISCONNECT CB
+	tcp_get->tcp_discon_cb = tcp_discon_cb;
+
+	//TCP SEND CB
+	tcp_get->tcp_send_cb = tcp_send_cb;
+
+	//TCP RECEIVE CB
+	tcp_get->tcp_recv_cb = tcp_recv_cb;
+}
+
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetBodySink(ESP8266_TCP_GET* tcp_get, uint8_t (*body_sink_cb)(ESP8266_TCP_GET*, char*, uint16_t))
+{
+	//PASS THE BODY OF EVERY 2XX REPLY TO body_sink_cb AS IT ARRIVES (NULL = OFF)
+	//HEADERS, CHUNK FRAMING AND CONTENT CODING ARE REMOVED. THE DATA POINTER IS INTO THE
+	//RECEIVED SEGMENT (OR THE DECODER WINDOW) AND IS ONLY VALID DURING THE CALL
+	//THE END OF THE BODY IS SIGNALLED BY ONE CALL WITH (NULL, 0). IF THE REPLY FAILS
+	//THERE IS NO SUCH CALL AND THE DATA READY CALLBACK GETS NULL
+	//
+	//THE SINK RETURNS 1 WHEN IT CAN TAKE MORE, OR 0 WHEN IT IS BUSY (FOR EXAMPLE WRITING
+	//FLASH). WHEN BUSY, RECEIVING IS HELD (THE TCP WINDOW CLOSES AND THE SERVER STOPS
+	//SENDING) UNTIL ESP8266_TCP_GET_ResumeBody IS CALLED. THE REPLY TIMEOUT DOES NOT RUN
+	//WHILE HELD, AND WITH A SINK IT COUNTS FROM THE LAST SEGMENT RATHER THAN THE REQUEST
+	//
+	//NOTE : THE REST OF A SEGMENT THAT IS ALREADY RECEIVED IS STILL PASSED TO A BUSY SINK
+	//(A CHUNKED OR COMPRESSED SEGMENT CAN GIVE SEVERAL CALLS). IT MUST TAKE IT
+
+	tcp_get->body_sink_cb = body_sink_cb;
+}
+
+uint32_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetDataAcquisitionInterval(ESP8266_TCP_GET* tcp_get)
+{
+	//RETURN ESP8266 TCP TIMER DATA ACQUISITION INTERVAL (MS)
+	//WHILE ACQUIRING, THIS IS THE CURRENT (ADAPTED) INTERVAL WITHOUT BACKOFF OR JITTER
+
+	if(tcp_get->acquisition_running)
+	{
+		return tcp_get->current_interval;
+	}
+	return tcp_get->timer_interval;
+}
+
+const char* ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetSourceHost(ESP8266_TCP_GET* tcp_get)
+{
+	//RETURN HOST NAME STRING
+
+	return tcp_get->host_name;
+}
+
+const char* ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetSourcePath(ESP8266_TCP_GET* tcp_get)
+{
+	//RETURN HOST PATH STRING
+
+	return tcp_get->host_path;
+}
+
+ESP8266_TCP_GET_STATE ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetState(ESP8266_TCP_GET* tcp_get)
+{
+	//RETURN THE INTERNAL ESP8266 TCP STATE VARIABLE VALUE
+
+	return tcp_get->state;
+}
+
+uint16_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetReplyStatusCode(ESP8266_TCP_GET* tcp_get)
+{
+	//RETURN THE HTTP STATUS CODE OF THE LAST (OR CURRENT) TCP GET REPLY
+	//0 IF NO STATUS LINE HAS BEEN RECEIVED YET
+
+	return tcp_get->http_parser.status_code;
+}
+
+const char* ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetLastEventId(ESP8266_TCP_GET* tcp_get)
+{
+	//RETURN THE id OF THE LAST SERVER-SENT EVENT (THE Last-Event-ID OF THE NEXT
+	//RECONNECT). EMPTY IF THE SERVER HAS NOT SENT ONE
+
+	return tcp_get->last_event_id;
+}
+
+ESP8266_TCP_GET_DNS_CACHE_STATE ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetDnsCacheEntry(ESP8266_TCP_GET* tcp_get, ip_addr_t* ip)
+{
+	//COPY THE CACHED HOST ADDRESS TO ip (IF NOT NULL) AND RETURN THE CACHE STATE
+	//EMPTY = NEVER RESOLVED, FRESH = CONFIRMED WITHIN THE TTL,
+	//STALE = SEEDED OR LAST REFRESH FAILED (ADDRESS STILL IN USE)
+
+	if(ip != NULL)
+	{
+		ip->addr = tcp_get->dns_cache.ip.addr;
+	}
+	return tcp_get->dns_cache.state;
+}
+
+uint8_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetServerAddresses(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_ADDRESS* addresses, uint8_t max_addresses)
+{
+	//COPY UP TO max_addresses CANDIDATE ADDRESSES WITH THEIR SCORES TO THE USER SUPPLIED
+	//ARRAY AND RETURN HOW MANY WERE COPIED. ENTRY 0 IS THE HOST ADDRESS (0 UNTIL RESOLVED)
+
+	uint8_t count = (tcp_get->address_count < max_addresses) ? tcp_get->address_count : max_addresses;
+
+	os_memcpy(addresses, tcp_get->addresses, count * sizeof(ESP8266_TCP_GET_ADDRESS));
+	return count;
+}
+
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetStats(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_STATS* stats)
+{
+	//COPY THE INSTANCE STATISTICS (COUNTERS, LAST CYCLE PHASE TIMES IN us AND
+	//PER PHASE LATENCY HISTOGRAMS) TO THE USER SUPPLIED STRUCTURE
+
+	os_memcpy(stats, &tcp_get->stats, sizeof(ESP8266_TCP_GET_STATS));
+}
+
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_ResetStats(ESP8266_TCP_GET* tcp_get)
+{
+	//CLEAR ALL INSTANCE STATISTICS
+
+	os_memset(&tcp_get->stats, 0, sizeof(ESP8266_TCP_GET_STATS));
+}
+
+uint32_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetArenaSize(ESP8266_TCP_GET* tcp_get)
+{
+	//RETURN THE SIZE OF THE INSTANCE MEMORY ARENA (BYTES)
+
+	return tcp_get->arena.size;
+}
+
+uint32_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetArenaHighWaterMark(ESP8266_TCP_GET* tcp_get)
+{
+	//RETURN THE MOST ARENA BYTES EVER IN USE AT ONCE (PERSISTENT + PER-CYCLE SCRATCH)
+
+	return tcp_get->arena.high_water;
+}
+
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetQueueStats(ESP8266_TCP_GET_QUEUE_STATS* stats)
+{
+	//COPY THE DEFERRED PROCESSING QUEUE SIZE, CURRENT DEPTH, HIGH WATER MARK AND
+	//DROP COUNTER TO THE USER SUPPLIED STRUCTURE (ALL 0 WHEN THE MODE IS OFF)
+
+	os_memcpy(stats, &_esp8266_tcp_get_event_queue.stats, sizeof(ESP8266_TCP_GET_QUEUE_STATS));
+}
+
+uint8_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetDeadlines(ESP8266_TCP_GET_DEADLINE* deadlines, uint8_t max_deadlines, uint32_t* wakes)
+{
+	//COPY UP TO max_deadlines PENDING DEADLINES OF ALL INSTANCES (INSTANCE, TYPE, ms LEFT)
+	//TO THE USER SUPPLIED ARRAY AND RETURN HOW MANY WERE COPIED. THEY ARE IN NO PARTICULAR ORDER
+	//wakes (IF NOT NULL) GETS THE NUMBER OF TIMES THE TIMER WHEEL HAS WOKEN THE CPU
+
+	ESP8266_TCP_GET_WHEEL* wheel = &_esp8266_tcp_get_wheel;
+	ESP8266_TCP_GET_TIMER* timer;
+	uint32_t clock = _esp8266_tcp_get_wheel_clock();
+	uint8_t count = 0;
+	uint16_t slot;
+
+	for(slot = 0; slot < ESP8266_TCP_GET_WHEEL_LEVELS * ESP8266_TCP_GET_WHEEL_SLOTS; slot++)
+	{
+		for(timer = wheel->slots[slot]; timer != NULL && count < max_deadlines; timer = timer->next)
+		{
+			deadlines[count].tcp_get = (ESP8266_TCP_GET*)timer->arg;
+			deadlines[count].type = (ESP8266_TCP_GET_DEADLINE_TYPE)timer->type;
+			deadlines[count].remaining_ms = ((int32_t)(timer->expires - clock) > 0) ?
+												(timer->expires - clock) * ESP8266_TCP_GET_WHEEL_TICK_MS : 0;
+			count++;
+		}
+	}
+	if(wakes != NULL)
+	{
+		*wakes = wheel->wakes;
+	}
+	return count;
+}
+
+uint16_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_ReadLog(uint8_t* buffer, uint16_t size)
+{
+	//MOVE THE OLDEST LOG RECORDS TO THE USER SUPPLIED BUFFER AS WHOLE FRAMES
+	//(ESP8266_TCP_GET_LOG_FRAME_SIZE BYTES EACH, AS SENT BY THE LOG DRAIN)
+	//AND RETURN THE NUMBER OF BYTES WRITTEN. FOR SENDING THE LOG SOME OTHER WAY
+	//THAN THE UART
+
+	uint16_t length = 0;
+
+#if ESP8266_TCP_GET_LOG_LEVEL > ESP8266_TCP_GET_LOG_LEVEL_NONE
+	while(_esp8266_tcp_get_log_ring.count != 0 && size - length >= ESP8266_TCP_GET_LOG_FRAME_SIZE)
+	{
+		_esp8266_tcp_get_log_frame(buffer + length);
+		length += ESP8266_TCP_GET_LOG_FRAME_SIZE;
+	}
+#endif
+	return length;
+}
+
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_ResolveHostName(ESP8266_TCP_GET* tcp_get, void (*user_dns_cb_fn)(ESP8266_TCP_GET*, ip_addr_t*))
+{
+	//RESOLVE PROVIDED HOSTNAME USING THE SUPPLIED DNS SERVER
+	//AND CALL THE USER PROVIDED DNS DONE CB FUNCTION WHEN DONE
+
+	//DONE ONLY IF THE HOSTNAME SUPPLIED IN INITIALIZATION FUNCTION
+	//IS NOT NULL. IF NULL, USER SUPPLIED IP ADDRESS IS USED INSTEAD
+	//AND NO DNS REOSLUTION IS DONE
+
+	//SET USER DNS RESOLVE CB FUNCTION
+	tcp_get->dns_cb_function = user_dns_cb_fn;
+
+	//SET DNS RETRY COUNTER TO ZERO
+	tcp_get->dns_retry_count = 0;
+
+	if(tcp_get->host_name != NULL)
+	{
+		//NEED TO DO DNS RESOLUTION
+		_esp8266_tcp_get_timer_cancel(&tcp_get->dns_timer);
+
+		if(tcp_get->dns_cache.state != ESP8266_TCP_GET_DNS_CACHE_EMPTY)
+		{
+			//CACHED (SEEDED) ADDRESS. USE IT RIGHT AWAY AND CONFIRM IT IN THE BACKGROUND
+			ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_DNS_CACHED, 0, tcp_get->dns_cache.ip.addr);
+			tcp_get->resolved_host_ip.addr = tcp_get->dns_cache.ip.addr;
+			tcp_get->state = ESP8266_TCP_GET_STATE_DNS_RESOLVED;
+			if(tcp_get->dns_cb_function != NULL)
+			{
+				(*tcp_get->dns_cb_function)(tcp_get, &tcp_get->resolved_host_ip);
+			}
+			_esp8266_tcp_get_dns_refresh(tcp_get);
+			return;
+		}
+
+		//START THE DNS RESOLVING PROCESS AND TIMER
+		tcp_get->resolved_host_ip.addr = 0;
+		tcp_get->dns_cache.refreshing = 0;
+		tcp_get->dns_start_time = system_get_time();
+		_esp8266_tcp_get_dns_lookup(tcp_get);
+		return;
+	}
+
+	//NO NEED TO DO DNS RESOLUTION. USE USER SUPPLIED IP ADDRESS STRING
+	tcp_get->resolved_host_ip.addr = ipaddr_addr(tcp_get->host_ip);
+
+	tcp_get->state = ESP8266_TCP_GET_STATE_DNS_RESOLVED;
+	//CALL USER SUPPLIED DNS RESOLVE CB FUNCTION
+	(*tcp_get->dns_cb_function)(tcp_get, &tcp_get->resolved_host_ip);
+}
+
+uint16_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetSourcePort(ESP8266_TCP_GET* tcp_get)
+{
+	//RETURN HOST REMOTE PORT NUMBER
+
+	return tcp_get->host_port;
+}
+
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_StartDataAcqusition(ESP8266_TCP_GET* tcp_get)
+{
+	//START TCP DATA AQUISITION CYCLE
+
+	struct espconn* pespconn;
+	uint8_t i;
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_ACQUISITION_START, 0, 0);
+
+	tcp_get->data_acquisition_count = 0;
+
+	//CREATE THE BASIC TCP GET REQUEST STRUCTURE AND OBJECTS
+	//BOTH ESPCONNS OF THE INSTANCE ARE SET UP THE SAME WAY
+	tcp_get->espconn.proto.tcp = &tcp_get->user_tcp;
+	tcp_get->race_espconn.proto.tcp = &tcp_get->race_tcp;
+	for(i = 0; i < 2; i++)
+	{
+		pespconn = _esp8266_tcp_get_attempt_espconn(tcp_get, i);
+		pespconn->reverse = tcp_get;
+		pespconn->type = ESPCONN_TCP;
+		pespconn->state = ESPCONN_NONE;
+
+		pespconn->proto.tcp->remote_port = tcp_get->host_port;
+
+		espconn_regist_connectcb(pespconn, _esp8266_tcp_get_connect_cb);
+		espconn_regist_disconcb(pespconn, _esp8266_tcp_get_disconnect_cb);
+		espconn_regist_reconcb(pespconn, _esp8266_tcp_get_reconnect_cb);
+	}
+
+	//START FROM THE USER INTERVAL (OR THE ONE RESTORED FROM A SNAPSHOT, WITH ITS
+	//BACKOFF), KEPT WITHIN THE ADAPTIVE BOUNDS
+	if(!tcp_get->snapshot_restored || tcp_get->current_interval == 0)
+	{
+		tcp_get->current_interval = tcp_get->timer_interval;
+		tcp_get->consecutive_failures = 0;
+	}
+	tcp_get->snapshot_restored = 0;
+	if(tcp_get->current_interval < tcp_get->interval_min)
+	{
+		tcp_get->current_interval = tcp_get->interval_min;
+	}
+	if(tcp_get->current_interval > tcp_get->interval_max)
+	{
+		tcp_get->current_interval = tcp_get->interval_max;
+	}
+	tcp_get->cycle_active = 0;
+	tcp_get->acquisition_running = 1;
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_ACQUISITION_TIMER, 0, tcp_get->current_interval);
+
+	//THE ACQUISITION TIMER IS ONE-SHOT. EACH CYCLE ARMS IT FOR THE NEXT ONE WHEN IT ENDS
+	_esp8266_tcp_get_timer_cancel(&tcp_get->timer);
+
+	//FIRST CYCLE RIGHT AWAY
+	_esp8266_tcp_get_data_acquisition_timer_cb(tcp_get);
+}
+
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_StopDataAcquisition(ESP8266_TCP_GET* tcp_get)
+{
+	//STOP TCP DATA AQUISITION CYCLE
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_ACQUISITION_STOP, 0, tcp_get->data_acquisition_count);
+
+	tcp_get->data_acquisition_count = 0;
+
+	//DISARM THE TIMER. A CYCLE STILL IN PROGRESS WILL NOT SCHEDULE ANOTHER ONE
+	tcp_get->acquisition_running = 0;
+	tcp_get->cycle_active = 0;
+	_esp8266_tcp_get_timer_cancel(&tcp_get->timer);
+
+	//GIVE UP A CONNECTION SLOT THE INSTANCE IS STILL WAITING FOR
+	_esp8266_tcp_get_slot_dequeue(tcp_get);
+
+	//CLOSE A KEPT-ALIVE CONNECTION, OR A STREAM (ITS REPLY NEVER ENDS ON ITS OWN)
+	_esp8266_tcp_get_timer_cancel(&tcp_get->idle_timer);
+	if(tcp_get->connected && (!tcp_get->reply_pending || tcp_get->stream_mode != ESP8266_TCP_GET_STREAM_OFF))
+	{
+		_esp8266_tcp_get_disconnect(tcp_get);
+	}
+}
+
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_ResumeBody(ESP8266_TCP_GET* tcp_get)
+{
+	//THE BODY SINK HAS FINISHED WITH ITS DATA. RECEIVE THE REST OF THE BODY
+	//SAFE TO CALL FROM THE SINK ITSELF OR WHEN NOTHING IS HELD
+
+	tcp_get->body_busy = 0;
+	if(!tcp_get->body_held)
+	{
+		return;
+	}
+	tcp_get->body_held = 0;
+	if(tcp_get->connected)
+	{
+		espconn_recv_unhold(tcp_get->conn);
+	}
+
+	//THE REPLY TIMEOUT STARTS AGAIN
+	if(tcp_get->reply_pending)
+	{
+		_esp8266_tcp_get_timer_arm(&tcp_get->reply_timeout_timer, _esp8266_tcp_get_reply_timeout(tcp_get));
+	}
+}
+
+uint8_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_QueueReading(ESP8266_TCP_GET* tcp_get, const char* reading, uint16_t length)
+{
+	//ADD A READING (length BYTES, WITHOUT '\n') TO THE UPLOAD QUEUE
+	//RETURNS 1 IF QUEUED, 0 IF THE QUEUE IS FULL (stats.upload_dropped COUNTS THEM)
+	//SAFE TO CALL WHILE A REQUEST IS IN PROGRESS. THE READING GOES WITH THE NEXT ONE
+
+	ESP8266_TCP_GET_UPLOAD_QUEUE* queue = &tcp_get->upload_queue;
+
+	if((uint32_t)queue->length + length + 1 > queue->size)
+	{
+		tcp_get->stats.upload_dropped++;
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_UPLOAD_QUEUE_FULL, 0, 0);
+		return 0;
+	}
+
+	if(queue->count == 0)
+	{
+		queue->first_time = system_get_time();
+	}
+	if(queue->sending_count != 0 && queue->count == queue->sending_count)
+	{
+		queue->next_first_time = system_get_time();
+	}
+	os_memcpy(queue->buffer + queue->length, reading, length);
+	queue->length += length;
+	queue->buffer[queue->length++] = '\n';
+	queue->count++;
+
+	//BATCH FULL OR OLD ENOUGH EARLIER THAN THE SCHEDULED CYCLE
+	_esp8266_tcp_get_upload_pull(tcp_get);
+	return 1;
+}
+
+uint8_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_SaveSnapshot(ESP8266_TCP_GET* tcp_get, uint8_t rtc_block)
+{
+	//WRITE THE WARM STATE OF THE INSTANCE (HOST ADDRESS, VALIDATORS, LAST EXTRACTED VALUES
+	//AND THEIR HASH, INTERVAL AND BACKOFF) TO RTC USER MEMORY STARTING AT rtc_block
+	//RETURN 1 IF WRITTEN, 0 IF THERE IS NO ADDRESS YET OR rtc_block IS OUT OF RANGE
+	//
+	//NOTE : CALL JUST BEFORE system_deep_sleep (E.G. FROM THE DATA READY CALLBACK)
+	//NOTE : TAKES sizeof(ESP8266_TCP_GET_SNAPSHOT) / 4 BLOCKS FROM rtc_block ON. RTC USER
+	//MEMORY IS BLOCKS ESP8266_TCP_GET_RTC_USER_BLOCK_FIRST TO ESP8266_TCP_GET_RTC_USER_BLOCK_LAST
+	//NOTE : VALUES BEYOND ESP8266_TCP_GET_SNAPSHOT_VALUE_BYTES ARE NOT SAVED
+
+	ESP8266_TCP_GET_SNAPSHOT snapshot;
+	ESP8266_TCP_GET_EXTRACTED_DATA* data;
+	uint8_t* ptr;
+	uint8_t length;
+	uint8_t i;
+
+	if(!_esp8266_tcp_get_rtc_block_valid(rtc_block) || tcp_get->resolved_host_ip.addr == 0)
+	{
+		return 0;
+	}
+
+	os_memset(&snapshot, 0, sizeof(ESP8266_TCP_GET_SNAPSHOT));
+	snapshot.magic = ESP8266_TCP_GET_SNAPSHOT_MAGIC;
+	snapshot.config_hash = _esp8266_tcp_get_config_hash(tcp_get);
+	snapshot.ip = tcp_get->resolved_host_ip.addr;
+	snapshot.last_data_hash = tcp_get->last_data_hash;
+	snapshot.current_interval = tcp_get->current_interval;
+	snapshot.consecutive_failures = tcp_get->consecutive_failures;
+	snapshot.dns_wakes = tcp_get->dns_wakes;
+	os_memcpy(snapshot.etag, tcp_get->etag, ESP8266_TCP_GET_ETAG_SIZE);
+	os_memcpy(snapshot.last_modified, tcp_get->last_modified, ESP8266_TCP_GET_LAST_MODIFIED_SIZE);
+
+	ptr = snapshot.values;
+	for(i = 0; i < tcp_get->extractor.field_count; i++)
+	{
+		data = tcp_get->extractor.data[i];
+		length = os_strlen(data->extracted_data);
+		if(ptr + 7 + length > snapshot.values + ESP8266_TCP_GET_SNAPSHOT_VALUE_BYTES)
+		{
+			break;
+		}
+		ptr[0] = data->data_found;
+		ptr[1] = data->extracted_value_decimals;
+		ptr[2] = length;
+		os_memcpy(ptr + 3, &data->extracted_value, 4);
+		os_memcpy(ptr + 7, data->extracted_data, length);
+		ptr += 7 + length;
+	}
+	snapshot.value_count = i;
+	snapshot.value_bytes = ptr - snapshot.values;
+
+	snapshot.checksum = _esp8266_tcp_get_fnv(ESP8266_TCP_GET_FNV_OFFSET_BASIS, (uint8_t*)&snapshot, sizeof(ESP8266_TCP_GET_SNAPSHOT));
+	return system_rtc_mem_write(rtc_block, &snapshot, sizeof(ESP8266_TCP_GET_SNAPSHOT));
+}
+
+uint8_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_RestoreSnapshot(ESP8266_TCP_GET* tcp_get, uint8_t rtc_block)
+{
+	//RESTORE THE WARM STATE SAVED BY ESP8266_TCP_GET_SaveSnapshot BEFORE DEEP SLEEP
+	//RETURN 1 IF RESTORED. THE INSTANCE IS THEN IN ESP8266_TCP_GET_STATE_DNS_RESOLVED AND
+	//ESP8266_TCP_GET_StartDataAcqusition CONNECTS RIGHT AWAY (NO ESP8266_TCP_GET_ResolveHostName)
+	//RETURN 0 IF THERE IS NO SNAPSHOT, IT IS CORRUPT (POWER-ON RESET) OR IT WAS TAKEN FOR
+	//ANOTHER HOST / PATH / PORT / FIELD SET. CONTINUE WITH ESP8266_TCP_GET_ResolveHostName
+	//
+	//NOTE : CALL AFTER ESP8266_TCP_GET_Intialize_Request_Buffer AND AFTER THE USER DATA
+	//CONTAINER / SUBSCRIBERS AND JSON MODE ARE SET
+	//NOTE : THE RESTORED ADDRESS IS USED WITHOUT A LOOKUP. EVERY ESP8266_TCP_GET_SNAPSHOT_DNS_WAKES
+	//WAKES (AND AFTER ANY CONNECTION ERROR) IT IS CONFIRMED BY A BACKGROUND LOOKUP
+
+	ESP8266_TCP_GET_SNAPSHOT snapshot;
+	ESP8266_TCP_GET_EXTRACTED_DATA* data;
+	uint32_t checksum;
+	uint8_t* ptr;
+	uint8_t* end;
+	uint8_t i;
+
+	if(!_esp8266_tcp_get_rtc_block_valid(rtc_block) ||
+		!system_rtc_mem_read(rtc_block, &snapshot, sizeof(ESP8266_TCP_GET_SNAPSHOT)))
+	{
+		return 0;
+	}
+
+	checksum = snapshot.checksum;
+	snapshot.checksum = 0;
+	if(snapshot.magic != ESP8266_TCP_GET_SNAPSHOT_MAGIC ||
+		checksum != _esp8266_tcp_get_fnv(ESP8266_TCP_GET_FNV_OFFSET_BASIS, (uint8_t*)&snapshot, sizeof(ESP8266_TCP_GET_SNAPSHOT)) ||
+		snapshot.config_hash != _esp8266_tcp_get_config_hash(tcp_get) ||
+		snapshot.ip == 0 || snapshot.value_bytes > ESP8266_TCP_GET_SNAPSHOT_VALUE_BYTES)
+	{
+		ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_SNAPSHOT_INVALID, 0, 0);
+		return 0;
+	}
+
+	//HOST ADDRESS
+	tcp_get->dns_cache.ip.addr = snapshot.ip;
+	tcp_get->dns_cache.state = ESP8266_TCP_GET_DNS_CACHE_FRESH;
+	tcp_get->resolved_host_ip.addr = snapshot.ip;
+	tcp_get->dns_wakes = (snapshot.dns_wakes < 0xFF) ? snapshot.dns_wakes + 1 : 0xFF;
+	tcp_get->state = ESP8266_TCP_GET_STATE_DNS_RESOLVED;
+	if(tcp_get->host_name != NULL && tcp_get->dns_wakes >= ESP8266_TCP_GET_SNAPSHOT_DNS_WAKES)
+	{
+		//CONFIRM THE ADDRESS NOW AND THEN. CYCLES DO NOT WAIT FOR IT
+		tcp_get->dns_cache.state = ESP8266_TCP_GET_DNS_CACHE_STALE;
+		_esp8266_tcp_get_timer_cancel(&tcp_get->dns_timer);
+		_esp8266_tcp_get_dns_refresh(tcp_get);
+	}
+
+	//VALIDATORS
+	if(tcp_get->conditional_get)
+	{
+		snapshot.etag[ESP8266_TCP_GET_ETAG_SIZE - 1] = '\0';
+		snapshot.last_modified[ESP8266_TCP_GET_LAST_MODIFIED_SIZE - 1] = '\0';
+		os_strcpy(tcp_get->etag, snapshot.etag);
+		os_strcpy(tcp_get->last_modified, snapshot.last_modified);
+		if(tcp_get->get_request_length != 0)
+		{
+			_esp8266_tcp_get_build_conditional(tcp_get);
+		}
+	}
+
+	//LAST EXTRACTED VALUES (A 304 REPLY KEEPS THEM) AND THEIR HASH
+	ptr = snapshot.values;
+	end = snapshot.values + snapshot.value_bytes;
+	for(i = 0; i < snapshot.value_count && i < tcp_get->extractor.field_count; i++)
+	{
+		data = tcp_get->extractor.data[i];
+		if(ptr + 7 > end || ptr + 7 + ptr[2] > end || ptr[2] >= sizeof(data->extracted_data))
+		{
+			break;
+		}
+		data->data_found = ptr[0];
+		data->extracted_value_decimals = ptr[1];
+		os_memcpy(&data->extracted_value, ptr + 3, 4);
+		os_memcpy(data->extracted_data, ptr + 7, ptr[2]);
+		data->extracted_data[ptr[2]] = '\0';
+		data->hash = _esp8266_tcp_get_field_hash(data);
+		ptr += 7 + ptr[2];
+	}
+	tcp_get->last_data_hash = snapshot.last_data_hash;
+
+	//SCHEDULER
+	tcp_get->current_interval = snapshot.current_interval;
+	tcp_get->consecutive_failures = snapshot.consecutive_failures;
+	tcp_get->snapshot_restored = 1;
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_SNAPSHOT_RESTORED, i, tcp_get->dns_wakes);
+	return 1;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_dns_timer_cb(void* arg)
+{
+	//ESP8266 DNS TIMER CALLBACK FUNCTION
+	//LOOKUP IN PROGRESS => LOOKUP TIMED OUT (ESP8266_TCP_GET_DNS_RETRY_MS). TRY AGAIN
+	//NO LOOKUP IN PROGRESS => CACHED ADDRESS REACHED ITS TTL. REFRESH IT
+
+	ESP8266_TCP_GET* tcp_get = (ESP8266_TCP_GET*)arg;
+
+	if(!tcp_get->dns_cache.lookup_pending)
+	{
+		_esp8266_tcp_get_dns_refresh(tcp_get);
+		return;
+	}
+
+	tcp_get->dns_retry_count++;
+	if(tcp_get->dns_retry_count == ESP8266_TCP_GET_DNS_MAX_TRIES)
+	{
+		//NO MORE DNS TRIES TO BE DONE
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_DNS_MAX_TRIES, 0, 0);
+		_esp8266_tcp_get_dns_failed(tcp_get);
+		return;
+	}
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_DNS_RETRY, tcp_get->dns_retry_count, 0);
+
+	_esp8266_tcp_get_dns_lookup(tcp_get);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_dns_found_cb(const char* name, ip_addr_t* ipAddr, void* arg)
+{
+	//ESP8266 TCP DNS RESOLVING DONE CALLBACK FUNCTION
+
+	//GET THE INSTANCE FROM THE ESPCONN PASSED TO espconn_gethostbyname
+	ESP8266_TCP_GET* tcp_get = (ESP8266_TCP_GET*)((struct espconn*)arg)->reverse;
+
+	if(!tcp_get->dns_cache.lookup_pending)
+	{
+		//ANSWER TO AN EARLIER TRY THAT WAS ALREADY HANDLED
+		return;
+	}
+
+	if(ipAddr == NULL)
+	{
+		//HOST NAME COULD NOT BE RESOLVED
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_DNS_NOT_RESOLVED, 0, 0);
+		_esp8266_tcp_get_dns_failed(tcp_get);
+		return;
+	}
+
+	//DNS GOT IP
+	_esp8266_tcp_get_dns_resolved(tcp_get, ipAddr);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_connect_cb(void* arg)
+{
+	//TCP CONNECT CALLBACK
+
+	//GET THE NEW USER TCP CONNECTION AND ITS INSTANCE
+	struct espconn *pespconn = arg;
+	ESP8266_TCP_GET* tcp_get = (ESP8266_TCP_GET*)pespconn->reverse;
+	uint8_t index = _esp8266_tcp_get_attempt_index(tcp_get, pespconn);
+	ESP8266_TCP_GET_ATTEMPT* attempt = &tcp_get->attempts[index];
+	ESP8266_TCP_GET_ADDRESS* address = &tcp_get->addresses[attempt->address];
+	uint32_t ms = (system_get_time() - attempt->start_time) / 1000;
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_CONNECTED, 0, 0);
+
+	if(!attempt->connecting)
+	{
+		//AN ATTEMPT ALREADY GIVEN UP. THE CALLBACK OF ITS ABORT FOLLOWS
+		return;
+	}
+
+	//FIRST ATTEMPT TO CONNECT WINS. GIVE UP THE ONE STILL RACING IT
+	attempt->connecting = 0;
+	_esp8266_tcp_get_timer_cancel(&tcp_get->connect_timer);
+	if(tcp_get->attempts[!index].connecting)
+	{
+		_esp8266_tcp_get_attempt_abort(tcp_get, !index);
+	}
+	tcp_get->conn = pespconn;
+
+	//SCORE THE ADDRESS FOR THE ORDER OF LATER CYCLES
+	if(ms >= ESP8266_TCP_GET_ADDRESS_UNTRIED_MS)
+	{
+		ms = ESP8266_TCP_GET_ADDRESS_UNTRIED_MS - 1;
+	}
+	address->connect_ms = (address->connect_ms == ESP8266_TCP_GET_ADDRESS_UNTRIED_MS) ? ms : (3 * address->connect_ms + ms) / 4;
+	address->fail_streak = 0;
+	address->successes++;
+	if(attempt->address != tcp_get->address_order[0])
+	{
+		tcp_get->stats.failovers++;
+	}
+
+	//REGISTER SEND AND RECEIVE CALLBACKS
+	espconn_regist_sentcb(pespconn, _esp8266_tcp_get_send_cb);
+	espconn_regist_recvcb(pespconn, _esp8266_tcp_get_receive_cb);
+	tcp_get->connected = 1;
+	_esp8266_tcp_get_stats_record(tcp_get, ESP8266_TCP_GET_PHASE_CONNECT, system_get_time() - tcp_get->connect_start_time);
+	if(tcp_get->secure)
+	{
+		//CONNECT CALLBACK OF A SECURE ESPCONN COMES AFTER THE HANDSHAKE
+		tcp_get->stats.tls_full_handshakes++;
+	}
+
+	//SEND USER DATA (GET REQUEST)
+	_esp8266_tcp_get_send_request(tcp_get);
+
+	//CALL USER CALLBACK IF NOT NULL
+	if(tcp_get->tcp_conn_cb != NULL)
+	{
+		(*tcp_get->tcp_conn_cb)(arg);
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_disconnect_cb(void* arg)
+{
+	//TCP DISCONNECT CALLBACK
+
+	ESP8266_TCP_GET* tcp_get = (ESP8266_TCP_GET*)((struct espconn*)arg)->reverse;
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_DISCONNECTED, 0, 0);
+
+	//A CONNECT ATTEMPT THAT FAILED OR WAS GIVEN UP. NOT THE CONNECTION IN USE
+	if(_esp8266_tcp_get_attempt_callback(tcp_get, (struct espconn*)arg))
+	{
+		return;
+	}
+
+	tcp_get->connected = 0;
+	tcp_get->closing = 1;
+	_esp8266_tcp_get_timer_cancel(&tcp_get->idle_timer);
+
+	//CONNECTION CLOSED. LET THE NEXT WAITING INSTANCE CONNECT
+	_esp8266_tcp_get_slot_release(tcp_get);
+
+	//DEFERRED PROCESSING. THE REPLY ENDS AFTER THE SEGMENTS STILL QUEUED
+	//AN EVENT THAT DOES NOT FIT IS HANDLED NOW
+	if(_esp8266_tcp_get_task_on && _esp8266_tcp_get_defer(tcp_get, ESP8266_TCP_GET_EVENT_DISCONNECT, NULL, 0))
+	{
+		return;
+	}
+	_esp8266_tcp_get_disconnect_process(tcp_get);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_disconnect_process(ESP8266_TCP_GET* tcp_get)
+{
+	//END THE CYCLE OF A CLOSED CONNECTION AND CALL THE USER DISCONNECT CALLBACK
+	//RUNS IN THE DISCONNECT CALLBACK, OR IN THE WORKER TASK IN DEFERRED MODE
+
+	//IF THE SERVER CLOSED THE CONNECTION WHILE A REPLY WAS PENDING, THE CYCLE ENDS HERE.
+	//A REPLY WITHOUT CONTENT-LENGTH / CHUNKED FRAMING IS COMPLETE ONLY WHEN THE SERVER CLOSES
+	//A COMPRESSED BODY MUST ALSO HAVE REACHED THE END OF ITS STREAM
+	if(tcp_get->reply_pending)
+	{
+		_esp8266_tcp_get_reply_done(tcp_get, tcp_get->http_parser.state == ESP8266_TCP_GET_HTTP_PARSER_BODY_UNTIL_CLOSE &&
+											(tcp_get->inflate == NULL || tcp_get->inflate->state == ESP8266_TCP_GET_INFLATE_DONE));
+	}
+	_esp8266_tcp_get_cycle_done(tcp_get, 0, 0);
+
+	//CALL USER CALLBACK IF NOT NULL
+	if(tcp_get->tcp_discon_cb != NULL)
+	{
+		(*tcp_get->tcp_discon_cb)(tcp_get->conn);
+	}
+	_esp8266_tcp_get_close_done(tcp_get);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_send_cb(void* arg)
+{
+	//TCP SENT DATA SUCCESSFULLY CALLBACK
+
+	ESP8266_TCP_GET* tcp_get = (ESP8266_TCP_GET*)((struct espconn*)arg)->reverse;
+
+	ESP8266_TCP_GET_LOG_DEBUG(tcp_get, ESP8266_TCP_GET_LOG_EVENT_SENT, 0, 0);
+
+	//NEXT PIECE OF A REQUEST BODY
+	if(tcp_get->upload_state == ESP8266_TCP_GET_UPLOAD_BODY)
+	{
+		_esp8266_tcp_get_upload_chunk(tcp_get);
+	}
+	else if(tcp_get->upload_state == ESP8266_TCP_GET_UPLOAD_LAST)
+	{
+		tcp_get->upload_state = ESP8266_TCP_GET_UPLOAD_DONE;
+	}
+
+	//SEND PHASE ENDS WHEN THE WHOLE REQUEST (WITH ITS BODY) HAS BEEN SENT
+	if(tcp_get->reply_pending && tcp_get->sent_time == 0 &&
+		(tcp_get->upload_state == ESP8266_TCP_GET_UPLOAD_IDLE || tcp_get->upload_state == ESP8266_TCP_GET_UPLOAD_DONE))
+	{
+		tcp_get->sent_time = system_get_time();
+		_esp8266_tcp_get_stats_record(tcp_get, ESP8266_TCP_GET_PHASE_SEND, tcp_get->sent_time - tcp_get->send_start_time);
+	}
+
+	//CALL USER CALLBACK IF NOT NULL
+	if(tcp_get->tcp_send_cb != NULL)
+	{
+		(*tcp_get->tcp_send_cb)(arg);
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_receive_cb(void* arg, char* pusrdata, unsigned short length)
+{
+	//TCP RECEIVED DATA CALLBACK
+
+	ESP8266_TCP_GET* tcp_get = (ESP8266_TCP_GET*)((struct espconn*)arg)->reverse;
+	uint32_t now = system_get_time();
+
+	ESP8266_TCP_GET_LOG_DEBUG(tcp_get, ESP8266_TCP_GET_LOG_EVENT_RECEIVED, length, 0);
+
+	if(tcp_get->reply_pending)
+	{
+		tcp_get->stats.bytes_received += length;
+		if(!tcp_get->first_byte_received)
+		{
+			//SERVER TIME. COUNTED FROM THE SENT CALLBACK (OR THE SEND IF IT HAS NOT COME YET)
+			tcp_get->first_byte_received = 1;
+			tcp_get->first_byte_time = now;
+			_esp8266_tcp_get_stats_record(tcp_get, ESP8266_TCP_GET_PHASE_FIRST_BYTE,
+											now - ((tcp_get->sent_time != 0) ? tcp_get->sent_time : tcp_get->send_start_time));
+		}
+
+		//WITH A BODY SINK OR A STREAM THE REPLY TIMEOUT IS AN INACTIVITY TIMEOUT, SO A
+		//LARGE BODY OR A LONG STREAM IS NOT CUT OFF WHILE IT IS STILL ARRIVING
+		if(tcp_get->body_sink_cb != NULL || tcp_get->stream_mode != ESP8266_TCP_GET_STREAM_OFF)
+		{
+			_esp8266_tcp_get_timer_arm(&tcp_get->reply_timeout_timer, _esp8266_tcp_get_reply_timeout(tcp_get));
+		}
+	}
+
+	//DEFERRED PROCESSING. THE WORKER TASK DOES THE REST
+	if(_esp8266_tcp_get_task_on)
+	{
+		if(!_esp8266_tcp_get_defer(tcp_get, ESP8266_TCP_GET_EVENT_DATA, pusrdata, length))
+		{
+			//NO ROOM. THE REPLY HAS A HOLE NOW. IT FAILS WHEN THE WORKER GETS TO
+			//THE INSTANCE, OR AT THE REPLY TIMEOUT
+			ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_SEGMENT_DROPPED, length, 0);
+			_esp8266_tcp_get_event_queue.stats.drops++;
+			tcp_get->stats.segments_dropped++;
+			tcp_get->queue_overflow = 1;
+		}
+		return;
+	}
+	_esp8266_tcp_get_receive_process(tcp_get, pusrdata, length);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_receive_process(ESP8266_TCP_GET* tcp_get, char* pusrdata, uint16_t length)
+{
+	//PARSE A RECEIVED SEGMENT AND END THE REPLY WHEN IT IS COMPLETE
+	//RUNS IN THE RECEIVE CALLBACK, OR IN THE WORKER TASK IN DEFERRED MODE
+
+	uint32_t now;
+
+	//CALL USER CALLBACK IF NOT NULL
+	if(tcp_get->tcp_recv_cb != NULL)
+	{
+		(*tcp_get->tcp_recv_cb)(tcp_get->conn, pusrdata, length);
+	}
+
+	if(!tcp_get->reply_pending)
+	{
+		//DATA AFTER THE END OF THE REPLY. NOTHING MORE TO DO
+		return;
+	}
+
+	//PROCESS INCOMING TCP DATA
+	//RUN THE DATA THROUGH THE HTTP REPLY PARSER. THE PARSER PASSES THE HEADER AND
+	//(DE-CHUNKED) BODY BYTES ON TO THE USER DATA EXTRACTOR
+	now = system_get_time();
+	_esp8266_tcp_get_http_parse(tcp_get, pusrdata, length);
+	tcp_get->parse_time += system_get_time() - now;
+
+	//BODY SINK BUSY. HOLD BACK THE NEXT SEGMENTS UNTIL ESP8266_TCP_GET_ResumeBody
+	if(tcp_get->body_busy && !tcp_get->body_held &&
+		tcp_get->http_parser.state != ESP8266_TCP_GET_HTTP_PARSER_DONE &&
+		tcp_get->http_parser.state != ESP8266_TCP_GET_HTTP_PARSER_ERROR)
+	{
+		tcp_get->body_held = 1;
+		espconn_recv_hold(tcp_get->conn);
+		_esp8266_tcp_get_timer_cancel(&tcp_get->reply_timeout_timer);
+	}
+
+	//CHECK FOR PACKET ENDING CONDITION
+	if(tcp_get->http_parser.state == ESP8266_TCP_GET_HTTP_PARSER_DONE ||
+		tcp_get->http_parser.state == ESP8266_TCP_GET_HTTP_PARSER_ERROR)
+	{
+		//END OF PACKET (LAST BODY BYTE RECEIVED) OR MALFORMED REPLY
+		_esp8266_tcp_get_reply_done(tcp_get, tcp_get->http_parser.state == ESP8266_TCP_GET_HTTP_PARSER_DONE);
+
+		//DISCONNECT TCP CONNECTION (OR KEEP IT OPEN FOR THE NEXT CYCLE)
+		_esp8266_tcp_get_release_connection(tcp_get, tcp_get->http_parser.state == ESP8266_TCP_GET_HTTP_PARSER_DONE &&
+											tcp_get->http_parser.keep_alive);
+	}
+	else if(tcp_get->http_parser.state == ESP8266_TCP_GET_HTTP_PARSER_BODY_UNTIL_CLOSE &&
+			tcp_get->extractor.terminator_found && tcp_get->stream_mode != ESP8266_TCP_GET_STREAM_SSE)
+	{
+		//REPLY HAS NO FRAMING. USER SUPPLIED TERMINATING CHARS FOUND
+		_esp8266_tcp_get_reply_done(tcp_get, 1);
+
+		//DISCONNECT TCP CONNECTION
+		_esp8266_tcp_get_release_connection(tcp_get, 0);
+	}
+	else if(tcp_get->stop_when_all_found && tcp_get->body_sink_cb == NULL && tcp_get->stream_mode != ESP8266_TCP_GET_STREAM_SSE &&
+			tcp_get->extractor.fields_wanted != 0 &&
+			tcp_get->extractor.fields_found == tcp_get->extractor.fields_wanted)
+	{
+		//ALL USER DATA FOUND. NO NEED TO WAIT FOR THE REST OF THE REPLY
+		//(UNLESS A BODY SINK WANTS ALL OF IT)
+		ESP8266_TCP_GET_LOG_DEBUG(tcp_get, ESP8266_TCP_GET_LOG_EVENT_ALL_FOUND, 0, 0);
+		_esp8266_tcp_get_reply_done(tcp_get, 1);
+
+		//DISCONNECT TCP CONNECTION
+		_esp8266_tcp_get_release_connection(tcp_get, 0);
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_receive_timeout_cb(void* arg)
+{
+	//CALLBACK FOR TCP GET REPLY TIMEOUT TIMER
+	//IF CALLED => TCP GET REPLY NOT RECEIVED IN SET TIME
+
+	ESP8266_TCP_GET* tcp_get = (ESP8266_TCP_GET*)arg;
+
+	tcp_get->stats.timeouts++;
+
+	ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_REPLY_TIMEOUT, 0, 0);
+
+	//END THE CURRENT TRANSACTION (CALLS USER SPECIFIED DATA READY CALLBACK
+	//WITH NULL ARGUMENT) AND DISCONNECT THE TCP CONNECTION
+	_esp8266_tcp_get_reply_done(tcp_get, 0);
+	_esp8266_tcp_get_release_connection(tcp_get, 0);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_data_acquisition_timer_cb(void* arg)
+{
+	//ESP8266 DATA ACQUISITION TIMER CALLABCK
+
+	ESP8266_TCP_GET* tcp_get = (ESP8266_TCP_GET*)arg;
+	ESP8266_TCP_GET_SUBSCRIBER* subscriber;
+
+	if(tcp_get->cycle_active)
+	{
+		//PREVIOUS CYCLE STILL IN PROGRESS. CYCLES NEVER OVERLAP
+		ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_CYCLE_SKIPPED, 0, 0);
+		return;
+	}
+	if(tcp_get->closing)
+	{
+		//THE LAST CONNECTION IS STILL CLOSING. ITS espconn CAN NOT BE SENT ON OR
+		//CONNECTED AGAIN YET. THE CYCLE STARTS WHEN THE CLOSE HAS BEEN PROCESSED
+		tcp_get->start_on_close = 1;
+		return;
+	}
+	tcp_get->cycle_active = 1;
+	tcp_get->cycle_start_time = system_get_time();
+
+	//WORK OUT WHICH SUBSCRIBERS THIS FETCH IS FOR
+	_esp8266_tcp_get_subscribers_mark_due(tcp_get);
+
+	//NOTHING TO UPLOAD AND NOTHING TO FETCH. LEAVE THE RADIO ALONE
+	if(tcp_get->method != ESP8266_TCP_GET_METHOD_GET && tcp_get->upload_producer_cb == NULL &&
+		tcp_get->upload_queue.count == 0)
+	{
+		for(subscriber = tcp_get->subscribers; subscriber != NULL && !subscriber->due; subscriber = subscriber->next);
+		if(subscriber == NULL)
+		{
+			ESP8266_TCP_GET_LOG_DEBUG(tcp_get, ESP8266_TCP_GET_LOG_EVENT_UPLOAD_EMPTY, 0, 0);
+			_esp8266_tcp_get_cycle_done(tcp_get, 1, 0);
+			return;
+		}
+	}
+	tcp_get->stats.cycles++;
+
+	if(tcp_get->keep_alive && tcp_get->connected && !tcp_get->reply_pending)
+	{
+		ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_CYCLE_START, 1, tcp_get->data_acquisition_count);
+		tcp_get->data_acquisition_count++;
+
+		//REUSE THE OPEN TCP CONNECTION
+		if(tcp_get->secure)
+		{
+			tcp_get->stats.tls_cycles_on_open_connection++;
+		}
+		_esp8266_tcp_get_send_request(tcp_get);
+		return;
+	}
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_CYCLE_START, 0, tcp_get->data_acquisition_count);
+	tcp_get->data_acquisition_count++;
+
+	//INITIATE A NEW TCP CONNECTION
+	_esp8266_tcp_get_connect(tcp_get);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_reconnect_cb(void* arg, sint8 err)
+{
+	//TCP CONNECTION ERROR CALLBACK
+	//CALLED INSTEAD OF THE DISCONNECT CALLBACK WHEN THE CONNECTION FAILS OR IS RESET
+
+	ESP8266_TCP_GET* tcp_get = (ESP8266_TCP_GET*)((struct espconn*)arg)->reverse;
+
+	ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_CONNECTION_ERROR, err, 0);
+
+	//A CONNECT ATTEMPT THAT FAILED OR WAS GIVEN UP. NOT THE CONNECTION IN USE
+	if(_esp8266_tcp_get_attempt_callback(tcp_get, (struct espconn*)arg))
+	{
+		return;
+	}
+	tcp_get->stats.connection_errors++;
+
+	tcp_get->connected = 0;
+	tcp_get->closing = 1;
+	_esp8266_tcp_get_timer_cancel(&tcp_get->idle_timer);
+
+	//CONNECTION GONE. LET THE NEXT WAITING INSTANCE CONNECT
+	_esp8266_tcp_get_slot_release(tcp_get);
+
+	//THE HOST MAY HAVE MOVED. CONFIRM THE CACHED ADDRESS WITHOUT WAITING FOR ITS TTL
+	_esp8266_tcp_get_dns_refresh(tcp_get);
+
+	//DEFERRED PROCESSING. THE REPLY ENDS AFTER THE SEGMENTS STILL QUEUED
+	//AN EVENT THAT DOES NOT FIT IS HANDLED NOW
+	if(_esp8266_tcp_get_task_on && _esp8266_tcp_get_defer(tcp_get, ESP8266_TCP_GET_EVENT_ERROR, NULL, 0))
+	{
+		return;
+	}
+	_esp8266_tcp_get_reconnect_process(tcp_get);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_reconnect_process(ESP8266_TCP_GET* tcp_get)
+{
+	//END ANY PENDING REPLY AS FAILED. A CYCLE THAT NEVER GOT TO SEND ENDS HERE TOO
+	//RUNS IN THE CONNECTION ERROR CALLBACK, OR IN THE WORKER TASK IN DEFERRED MODE
+
+	_esp8266_tcp_get_reply_done(tcp_get, 0);
+	_esp8266_tcp_get_cycle_done(tcp_get, 0, 0);
+	_esp8266_tcp_get_close_done(tcp_get);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_close_done(ESP8266_TCP_GET* tcp_get)
+{
+	//THE CLOSE OF THE CONNECTION HAS BEEN PROCESSED. START A CYCLE THAT CAME DUE MEANWHILE
+	//(FOR EXAMPLE THE IDLE TIMER AND THE CYCLE TIMER OF A KEPT-ALIVE CONNECTION EXPIRING TOGETHER)
+
+	tcp_get->closing = 0;
+	if(tcp_get->start_on_close)
+	{
+		tcp_get->start_on_close = 0;
+		if(tcp_get->acquisition_running)
+		{
+			_esp8266_tcp_get_data_acquisition_timer_cb(tcp_get);
+		}
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_idle_timeout_cb(void* arg)
+{
+	//CALLBACK FOR THE KEEP-ALIVE IDLE TIMER
+	//IF CALLED => KEPT-ALIVE CONNECTION NOT REUSED WITHIN THE IDLE LIMIT
+
+	ESP8266_TCP_GET* tcp_get = (ESP8266_TCP_GET*)arg;
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_IDLE_DISCONNECT, 0, 0);
+
+	if(tcp_get->connected && !tcp_get->reply_pending)
+	{
+		_esp8266_tcp_get_disconnect(tcp_get);
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_connect_timer_cb(void* arg)
+{
+	//CALLBACK FOR THE CONNECT TIMER
+	//STAGGER DELAY => THE ATTEMPTS IN PROGRESS HAVE STALLED. TRY THE NEXT ADDRESS
+	//DEADLINE => NO ADDRESS CONNECTED IN TIME. GIVE UP ALL ATTEMPTS AND FAIL THE CYCLE
+
+	ESP8266_TCP_GET* tcp_get = (ESP8266_TCP_GET*)arg;
+	ESP8266_TCP_GET_ATTEMPT* attempts = tcp_get->attempts;
+	uint8_t index;
+
+	if(!attempts[0].connecting && !attempts[1].connecting)
+	{
+		return;
+	}
+
+	if((int32_t)(tcp_get->connect_deadline - system_get_time()) <= 0)
+	{
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_CONNECT_TIMEOUT, 0, tcp_get->connect_timeout_ms);
+		tcp_get->stats.connect_timeouts++;
+		for(index = 0; index < 2; index++)
+		{
+			if(attempts[index].connecting)
+			{
+				_esp8266_tcp_get_attempt_failed(tcp_get, index);
+				_esp8266_tcp_get_attempt_abort(tcp_get, index);
+			}
+		}
+		_esp8266_tcp_get_connect_failed(tcp_get);
+		return;
+	}
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_CONNECT_STALLED, 0, 0);
+
+	//A SECURE ATTEMPT, OR THE OLDER OF TWO RACING ONES, MAKES ROOM FOR THE NEXT ADDRESS
+	if(tcp_get->address_next < tcp_get->address_order_count &&
+		(tcp_get->secure || (attempts[0].connecting && attempts[1].connecting)))
+	{
+		if(attempts[0].connecting && attempts[1].connecting)
+		{
+			index = ((int32_t)(attempts[1].start_time - attempts[0].start_time) < 0) ? 1 : 0;
+		}
+		else
+		{
+			index = attempts[0].connecting ? 0 : 1;
+		}
+		_esp8266_tcp_get_attempt_failed(tcp_get, index);
+		_esp8266_tcp_get_attempt_abort(tcp_get, index);
+	}
+
+	if(!_esp8266_tcp_get_attempt_start(tcp_get) && !attempts[0].connecting && !attempts[1].connecting)
+	{
+		_esp8266_tcp_get_connect_failed(tcp_get);
+		return;
+	}
+	_esp8266_tcp_get_connect_arm(tcp_get);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_task(os_event_t* event)
+{
+	//DEFERRED PROCESSING WORKER TASK
+	//HANDLES THE OLDEST QUEUED EVENT AND POSTS ITSELF AGAIN WHILE MORE ARE WAITING,
+	//SO THE NETWORK STACK AND OTHER TASKS RUN BETWEEN EVENTS
+
+	ESP8266_TCP_GET_EVENT_QUEUE* queue = &_esp8266_tcp_get_event_queue;
+	ESP8266_TCP_GET_EVENT* ev;
+	ESP8266_TCP_GET* tcp_get;
+
+	_esp8266_tcp_get_task_posted = 0;
+	if(queue->stats.count == 0)
+	{
+		return;
+	}
+	ev = &queue->events[queue->first];
+	tcp_get = ev->tcp_get;
+
+	//A DROPPED SEGMENT LEFT A HOLE IN THE REPLY. END IT AS FAILED
+	if(tcp_get->queue_overflow && tcp_get->reply_pending)
+	{
+		tcp_get->queue_overflow = 0;
+		_esp8266_tcp_get_reply_done(tcp_get, 0);
+		_esp8266_tcp_get_release_connection(tcp_get, 0);
+	}
+
+	switch(ev->type)
+	{
+		case ESP8266_TCP_GET_EVENT_DATA:
+			_esp8266_tcp_get_receive_process(tcp_get, (char*)queue->bytes + ev->offset, ev->length);
+			break;
+		case ESP8266_TCP_GET_EVENT_DISCONNECT:
+			_esp8266_tcp_get_disconnect_process(tcp_get);
+			break;
+		case ESP8266_TCP_GET_EVENT_ERROR:
+			_esp8266_tcp_get_reconnect_process(tcp_get);
+			break;
+	}
+
+	//FREE THE EVENT AND ITS DATA. DATA IS FREED IN THE ORDER IT WAS WRITTEN
+	if(ev->length != 0)
+	{
+		if(queue->wrapped && ev->offset < queue->bytes_out)
+		{
+			//REACHED THE DATA WRITTEN AFTER THE WRAP
+			queue->wrapped = 0;
+		}
+		queue->bytes_out = ev->offset + ev->length;
+	}
+	queue->first = (queue->first + 1) % queue->stats.depth;
+	queue->stats.count--;
+
+	if(queue->stats.count == 0)
+	{
+		queue->bytes_in = 0;
+		queue->bytes_out = 0;
+		queue->wrapped = 0;
+	}
+	else if(!_esp8266_tcp_get_task_posted)
+	{
+		_esp8266_tcp_get_task_posted = system_os_post(_esp8266_tcp_get_task_priority, 0, 0);
+	}
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_defer(ESP8266_TCP_GET* tcp_get, uint8_t type, char* data, uint16_t length)
+{
+	//QUEUE AN ESPCONN EVENT (WITH A COPY OF ITS DATA) FOR THE WORKER TASK
+	//RETURN 0 IF THE QUEUE OR THE BYTE RING IS FULL
+
+	ESP8266_TCP_GET_EVENT_QUEUE* queue = &_esp8266_tcp_get_event_queue;
+	ESP8266_TCP_GET_EVENT* ev;
+	uint16_t offset = queue->bytes_in;
+
+	if(queue->stats.count == queue->stats.depth)
+	{
+		return 0;
+	}
+
+	if(length != 0)
+	{
+		if(!queue->wrapped)
+		{
+			if(queue->stats.bytes_size - queue->bytes_in < length)
+			{
+				//NO ROOM AT THE END. WRAP TO THE START IF THE OLDEST DATA LEFT ENOUGH
+				if(queue->bytes_out < length)
+				{
+					return 0;
+				}
+				offset = 0;
+				queue->wrapped = 1;
+			}
+		}
+		else if(queue->bytes_out - queue->bytes_in < length)
+		{
+			return 0;
+		}
+		os_memcpy(queue->bytes + offset, data, length);
+		queue->bytes_in = offset + length;
+	}
+
+	ev = &queue->events[(queue->first + queue->stats.count) % queue->stats.depth];
+	ev->tcp_get = tcp_get;
+	ev->type = type;
+	ev->offset = offset;
+	ev->length = length;
+	queue->stats.count++;
+	if(queue->stats.count > queue->stats.high_water)
+	{
+		queue->stats.high_water = queue->stats.count;
+	}
+
+	if(!_esp8266_tcp_get_task_posted)
+	{
+		_esp8266_tcp_get_task_posted = system_os_post(_esp8266_tcp_get_task_priority, 0, 0);
+	}
+	return 1;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_dns_lookup(ESP8266_TCP_GET* tcp_get)
+{
+	//START ONE DNS LOOKUP TRY AND ARM THE RETRY TIMER
+	//THE INSTANCE ESPCONN IS PASSED SO THE DNS FOUND CALLBACK CAN FIND ITS INSTANCE
+
+	sint8 result;
+
+	tcp_get->dns_cache.lookup_pending = 1;
+	tcp_get->dns_cache.lookup_ip.addr = 0;
+	_esp8266_tcp_get_timer_arm(&tcp_get->dns_timer, ESP8266_TCP_GET_DNS_RETRY_MS);
+
+	result = espconn_gethostbyname(&tcp_get->espconn, tcp_get->host_name, &tcp_get->dns_cache.lookup_ip, _esp8266_tcp_get_dns_found_cb);
+	if(result == ESPCONN_OK)
+	{
+		//ANSWERED FROM THE LWIP DNS TABLE. NO CALLBACK WILL COME
+		_esp8266_tcp_get_dns_resolved(tcp_get, &tcp_get->dns_cache.lookup_ip);
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_dns_refresh(ESP8266_TCP_GET* tcp_get)
+{
+	//START A BACKGROUND LOOKUP OF THE HOST NAME
+	//CYCLES KEEP USING THE CACHED ADDRESS WHILE IT RUNS
+
+	if(tcp_get->host_name == NULL || tcp_get->dns_cache.state == ESP8266_TCP_GET_DNS_CACHE_EMPTY
+		|| tcp_get->dns_cache.lookup_pending)
+	{
+		return;
+	}
+
+	_esp8266_tcp_get_timer_cancel(&tcp_get->dns_timer);
+	tcp_get->dns_retry_count = 0;
+	tcp_get->dns_cache.refreshing = 1;
+	tcp_get->dns_start_time = system_get_time();
+	_esp8266_tcp_get_dns_lookup(tcp_get);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_dns_resolved(ESP8266_TCP_GET* tcp_get, ip_addr_t* ip)
+{
+	//A LOOKUP SUCCEEDED. UPDATE THE CACHE AND SCHEDULE THE NEXT REFRESH
+	//NEW CONNECTIONS USE THE NEW ADDRESS. AN OPEN CONNECTION IS NOT TOUCHED
+
+	_esp8266_tcp_get_timer_cancel(&tcp_get->dns_timer);
+	tcp_get->dns_cache.lookup_pending = 0;
+	_esp8266_tcp_get_stats_record(tcp_get, ESP8266_TCP_GET_PHASE_DNS, system_get_time() - tcp_get->dns_start_time);
+
+	if(ip->addr != tcp_get->dns_cache.ip.addr)
+	{
+		ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_DNS_RESOLVED, 0, ip->addr);
+	}
+
+	tcp_get->dns_cache.ip.addr = ip->addr;
+	tcp_get->dns_cache.state = ESP8266_TCP_GET_DNS_CACHE_FRESH;
+	tcp_get->resolved_host_ip.addr = ip->addr;
+	tcp_get->dns_wakes = 0;
+	_esp8266_tcp_get_timer_arm(&tcp_get->dns_timer, tcp_get->dns_cache.ttl_s * 1000);
+
+	if(tcp_get->dns_cache.refreshing)
+	{
+		//BACKGROUND REFRESH. USER ALREADY HAS AN ADDRESS
+		tcp_get->dns_cache.refreshing = 0;
+		return;
+	}
+
+	tcp_get->state = ESP8266_TCP_GET_STATE_DNS_RESOLVED;
+
+	//CALL USER PROVIDED DNS CB FUNCTION
+	if(tcp_get->dns_cb_function != NULL)
+	{
+		(*tcp_get->dns_cb_function)(tcp_get, &tcp_get->resolved_host_ip);
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_dns_failed(ESP8266_TCP_GET* tcp_get)
+{
+	//A LOOKUP FAILED (NXDOMAIN OR OUT OF RETRIES)
+	//BACKGROUND REFRESH => KEEP SERVING THE LAST GOOD ADDRESS AND TRY AGAIN LATER
+	//FIRST RESOLUTION => NOTHING TO FALL BACK TO. REPORT THE ERROR TO THE USER
+
+	_esp8266_tcp_get_timer_cancel(&tcp_get->dns_timer);
+	tcp_get->dns_cache.lookup_pending = 0;
+	tcp_get->stats.dns_failures++;
+
+	if(tcp_get->dns_cache.refreshing)
+	{
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_DNS_REFRESH_FAILED, 0, 0);
+		tcp_get->dns_cache.refreshing = 0;
+		tcp_get->dns_cache.state = ESP8266_TCP_GET_DNS_CACHE_STALE;
+		_esp8266_tcp_get_timer_arm(&tcp_get->dns_timer, ESP8266_TCP_GET_DNS_STALE_RETRY_MS);
+		return;
+	}
+
+	tcp_get->state = ESP8266_TCP_GET_STATE_ERROR;
+	//CALL USER PROVIDED DNS CB FUNCTION WITH NULL PARAMETER
+	if(tcp_get->dns_cb_function != NULL)
+	{
+		(*tcp_get->dns_cb_function)(tcp_get, NULL);
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_build_request(ESP8266_TCP_GET* tcp_get)
+{
+	//GENERATE THE GET STRING USING HOST-NAME & HOST-PATH
+	//THE LENGTH IS CACHED SO EVERY CYCLE SENDS THE BUFFER DIRECTLY
+	//POST / PUT ALSO CARRY THE METHOD AND THE BODY HEADERS. AN SSE GET ASKS FOR AN EVENT STREAM
+
+	const char* request_string = tcp_get->keep_alive ? ESP8266_TCP_GET_KEEP_ALIVE_REQUEST_STRING : ESP8266_TCP_GET_GET_REQUEST_STRING;
+	const char* method = (tcp_get->method == ESP8266_TCP_GET_METHOD_PUT) ? "PUT" : "POST";
+
+	//EACH OF THE TWO %s IS REPLACED. +1 FOR THE TERMINATING NULL
+	uint32_t length = os_strlen(request_string) - 4 + os_strlen(tcp_get->host_path) + os_strlen(tcp_get->host_name);
+	if(tcp_get->method != ESP8266_TCP_GET_METHOD_GET)
+	{
+		//FOUR %s
+		request_string = tcp_get->keep_alive ? ESP8266_TCP_GET_KEEP_ALIVE_UPLOAD_REQUEST_STRING : ESP8266_TCP_GET_UPLOAD_REQUEST_STRING;
+		length = os_strlen(request_string) - 8 + os_strlen(method) + os_strlen(tcp_get->host_path) +
+					os_strlen(tcp_get->host_name) + os_strlen(tcp_get->content_type);
+	}
+	uint32_t accept_length = tcp_get->compression ? os_strlen(ESP8266_TCP_GET_ACCEPT_ENCODING_STRING) : 0;
+	uint8_t sse = (tcp_get->stream_mode == ESP8266_TCP_GET_STREAM_SSE && tcp_get->method == ESP8266_TCP_GET_METHOD_GET);
+	uint32_t sse_length = sse ? os_strlen(ESP8266_TCP_GET_SSE_ACCEPT_STRING) : 0;
+	if(length + accept_length + sse_length + 1 > tcp_get->get_request_buffer_size)
+	{
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_REQUEST_BUFFER_SMALL, 0, length + accept_length + sse_length + 1);
+		tcp_get->get_request_length = 0;
+		tcp_get->state = ESP8266_TCP_GET_STATE_ERROR;
+		return;
+	}
+
+	if(tcp_get->method != ESP8266_TCP_GET_METHOD_GET)
+	{
+		os_sprintf(tcp_get->get_request_buffer, request_string, method, tcp_get->host_path, tcp_get->host_name, tcp_get->content_type);
+	}
+	else
+	{
+		os_sprintf(tcp_get->get_request_buffer, request_string, tcp_get->host_path, tcp_get->host_name);
+	}
+	tcp_get->get_request_prefix_length = length - 2;
+
+	//ACCEPT-ENCODING IS PART OF THE FIXED PREFIX
+	if(accept_length != 0)
+	{
+		os_strcpy(tcp_get->get_request_buffer + tcp_get->get_request_prefix_length, ESP8266_TCP_GET_ACCEPT_ENCODING_STRING);
+		tcp_get->get_request_prefix_length += accept_length;
+	}
+	if(sse_length != 0)
+	{
+		os_strcpy(tcp_get->get_request_buffer + tcp_get->get_request_prefix_length, ESP8266_TCP_GET_SSE_ACCEPT_STRING);
+		tcp_get->get_request_prefix_length += sse_length;
+	}
+	tcp_get->get_request_length = tcp_get->get_request_prefix_length + 2;
+
+	//ADD THE VALIDATORS OF THE LAST REPLY (IF ANY)
+	_esp8266_tcp_get_build_conditional(tcp_get);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_build_conditional(ESP8266_TCP_GET* tcp_get)
+{
+	//REWRITE THE END OF THE GET STRING (AFTER THE CACHED PREFIX) WITH THE
+	//CONDITIONAL HEADERS FOR THE CURRENT VALIDATORS AND THE FINAL CRLF
+	//IF THEY DO NOT FIT THE REQUEST BUFFER, AN UNCONDITIONAL GET IS SENT
+	//POST / PUT ARE NEVER CONDITIONAL. AN SSE GET SENDS THE RESUME POINT INSTEAD
+
+	char* ptr = tcp_get->get_request_buffer + tcp_get->get_request_prefix_length;
+	uint32_t etag_length = os_strlen(tcp_get->etag);
+	uint32_t last_modified_length = os_strlen(tcp_get->last_modified);
+	uint32_t length = tcp_get->get_request_prefix_length + 2;
+	uint32_t event_id_length = 0;
+
+	if(tcp_get->stream_mode == ESP8266_TCP_GET_STREAM_SSE)
+	{
+		//NO VALIDATORS ON A STREAM. THE LAST EVENT ID TELLS THE SERVER WHERE TO RESUME
+		event_id_length = os_strlen(tcp_get->last_event_id);
+		etag_length = 0;
+		last_modified_length = 0;
+	}
+	if(etag_length != 0)
+	{
+		length += os_strlen("If-None-Match: \r\n") + etag_length;
+	}
+	if(last_modified_length != 0)
+	{
+		length += os_strlen("If-Modified-Since: \r\n") + last_modified_length;
+	}
+	if(event_id_length != 0)
+	{
+		length += os_strlen("Last-Event-ID: \r\n") + event_id_length;
+	}
+	if(tcp_get->method != ESP8266_TCP_GET_METHOD_GET)
+	{
+		etag_length = 0;
+		last_modified_length = 0;
+		event_id_length = 0;
+		length = tcp_get->get_request_prefix_length + 2;
+	}
+	if(length + 1 > tcp_get->get_request_buffer_size)
+	{
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_CONDITIONAL_BUFFER_SMALL, 0, length + 1);
+		etag_length = 0;
+		last_modified_length = 0;
+		event_id_length = 0;
+		length = tcp_get->get_request_prefix_length + 2;
+	}
+
+	if(etag_length != 0)
+	{
+		ptr += os_sprintf(ptr, "If-None-Match: %s\r\n", tcp_get->etag);
+	}
+	if(last_modified_length != 0)
+	{
+		ptr += os_sprintf(ptr, "If-Modified-Since: %s\r\n", tcp_get->last_modified);
+	}
+	if(event_id_length != 0)
+	{
+		ptr += os_sprintf(ptr, "Last-Event-ID: %s\r\n", tcp_get->last_event_id);
+	}
+	os_strcpy(ptr, "\r\n");
+	tcp_get->get_request_length = length;
+
+	ESP8266_TCP_GET_LOG_DEBUG(tcp_get, ESP8266_TCP_GET_LOG_EVENT_REQUEST_BUILT, 0, os_strlen(tcp_get->get_request_buffer));
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_connect(ESP8266_TCP_GET* tcp_get)
+{
+	//INITIATE A NEW TCP CONNECTION FROM A FRESH LOCAL PORT
+	//IF ALL CONNECTION SLOTS ARE IN USE, THE INSTANCE WAITS IN THE SLOT QUEUE
+	//AND CONNECTS AS SOON AS ANOTHER INSTANCE CLOSES ITS CONNECTION
+	//A SECURE INSTANCE ALSO WAITS WHILE ANOTHER INSTANCE HOLDS THE TLS CONNECTION
+
+	if(tcp_get->waiting_for_slot)
+	{
+		//ALREADY QUEUED FROM A PREVIOUS CYCLE
+		return;
+	}
+
+	if(!tcp_get->holds_slot)
+	{
+		if(_esp8266_tcp_get_open_connections >= _esp8266_tcp_get_max_connections)
+		{
+			ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_SLOTS_BUSY, _esp8266_tcp_get_max_connections, 0);
+			_esp8266_tcp_get_slot_enqueue(tcp_get);
+			return;
+		}
+		if(tcp_get->secure && _esp8266_tcp_get_secure_owner != NULL)
+		{
+			ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_TLS_BUSY, 0, 0);
+			_esp8266_tcp_get_slot_enqueue(tcp_get);
+
+			//AN IDLE KEPT-ALIVE TLS CONNECTION IS HANDED OVER NOW INSTEAD OF AT ITS IDLE LIMIT
+			if(_esp8266_tcp_get_secure_owner->connected && !_esp8266_tcp_get_secure_owner->reply_pending)
+			{
+				_esp8266_tcp_get_timer_cancel(&_esp8266_tcp_get_secure_owner->idle_timer);
+				_esp8266_tcp_get_disconnect(_esp8266_tcp_get_secure_owner);
+			}
+			return;
+		}
+		_esp8266_tcp_get_open_connections++;
+		tcp_get->holds_slot = 1;
+		if(tcp_get->secure)
+		{
+			_esp8266_tcp_get_secure_owner = tcp_get;
+		}
+	}
+
+	//TRY THE CANDIDATE ADDRESSES (THE CURRENT, POSSIBLY REFRESHED, HOST ADDRESS AND
+	//THE FAILOVER ONES) BEST FIRST, ALL WITHIN ONE CONNECT DEADLINE
+	tcp_get->connect_start_time = system_get_time();
+	tcp_get->connect_deadline = tcp_get->connect_start_time + tcp_get->connect_timeout_ms * 1000;
+	_esp8266_tcp_get_addresses_order(tcp_get);
+	if(!_esp8266_tcp_get_attempt_start(tcp_get))
+	{
+		//NO CALLBACK WILL COME FOR THIS CONNECTION. GIVE THE SLOT BACK
+		_esp8266_tcp_get_slot_release(tcp_get);
+		_esp8266_tcp_get_cycle_done(tcp_get, 0, 0);
+		return;
+	}
+	_esp8266_tcp_get_connect_arm(tcp_get);
+}
+
+struct espconn* ICACHE_FLASH_ATTR _esp8266_tcp_get_attempt_espconn(ESP8266_TCP_GET* tcp_get, uint8_t index)
+{
+	//RETURN THE ESPCONN OF CONNECT ATTEMPT index (0 OR 1)
+
+	return (index == 0) ? &tcp_get->espconn : &tcp_get->race_espconn;
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_attempt_index(ESP8266_TCP_GET* tcp_get, struct espconn* pespconn)
+{
+	//RETURN THE CONNECT ATTEMPT INDEX OF AN ESPCONN OF THE INSTANCE
+
+	return (pespconn == &tcp_get->race_espconn) ? 1 : 0;
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_attempt_start(ESP8266_TCP_GET* tcp_get)
+{
+	//START A CONNECT ATTEMPT TO THE NEXT CANDIDATE ADDRESS ON A FREE ESPCONN
+	//AN ADDRESS THAT CANNOT EVEN BE TRIED IS COUNTED AS FAILED AND SKIPPED
+	//RETURNS 0 IF NO ATTEMPT WAS STARTED (NO ADDRESS LEFT, NO FREE ESPCONN, A SECURE
+	//ATTEMPT STILL IN PROGRESS OR THE DEADLINE HAS PASSED)
+
+	ESP8266_TCP_GET_ATTEMPT* attempt;
+	struct espconn* pespconn;
+	uint8_t index;
+
+	while(tcp_get->address_next < tcp_get->address_order_count &&
+			(int32_t)(tcp_get->connect_deadline - system_get_time()) > 0)
+	{
+		if(tcp_get->secure && (tcp_get->attempts[0].connecting || tcp_get->attempts[1].connecting))
+		{
+			return 0;
+		}
+		for(index = 0; index < 2; index++)
+		{
+			attempt = &tcp_get->attempts[index];
+			pespconn = _esp8266_tcp_get_attempt_espconn(tcp_get, index);
+			if(!attempt->connecting && !attempt->aborting && !(tcp_get->connected && tcp_get->conn == pespconn))
+			{
+				break;
+			}
+		}
+		if(index == 2)
+		{
+			return 0;
+		}
+
+		attempt->address = tcp_get->address_order[tcp_get->address_next++];
+		attempt->start_time = system_get_time();
+		os_memcpy(pespconn->proto.tcp->remote_ip, (uint8_t*)(&tcp_get->addresses[attempt->address].ip.addr), 4);
+		pespconn->proto.tcp->local_port = espconn_port();
+		if((tcp_get->secure ? espconn_secure_connect(pespconn) : espconn_connect(pespconn)) == ESPCONN_OK)
+		{
+			attempt->connecting = 1;
+			return 1;
+		}
+
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_CONNECT_FAILED, tcp_get->secure, 0);
+		_esp8266_tcp_get_attempt_failed(tcp_get, index);
+	}
+	return 0;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_attempt_abort(ESP8266_TCP_GET* tcp_get, uint8_t index)
+{
+	//GIVE UP A CONNECT ATTEMPT STILL IN PROGRESS
+	//ITS ESPCONN IS NOT REUSED UNTIL THE CALLBACK OF THE ABORT HAS COME
+
+	struct espconn* pespconn = _esp8266_tcp_get_attempt_espconn(tcp_get, index);
+
+	tcp_get->attempts[index].connecting = 0;
+	tcp_get->attempts[index].aborting = ((tcp_get->secure ? espconn_secure_disconnect(pespconn) : espconn_abort(pespconn)) == ESPCONN_OK);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_attempt_failed(ESP8266_TCP_GET* tcp_get, uint8_t index)
+{
+	//A CONNECT ATTEMPT FAILED OR STALLED. SCORE ITS ADDRESS DOWN FOR LATER CYCLES
+
+	ESP8266_TCP_GET_ATTEMPT* attempt = &tcp_get->attempts[index];
+	ESP8266_TCP_GET_ADDRESS* address = &tcp_get->addresses[attempt->address];
+
+	attempt->connecting = 0;
+	address->failures++;
+	if(address->fail_streak < 0xFF)
+	{
+		address->fail_streak++;
+	}
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_ADDRESS_FAILED, address->fail_streak, address->ip.addr);
+
+	//THE HOST MAY HAVE MOVED. CONFIRM THE CACHED ADDRESS WITHOUT WAITING FOR ITS TTL
+	if(attempt->address == 0)
+	{
+		_esp8266_tcp_get_dns_refresh(tcp_get);
+	}
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_attempt_callback(ESP8266_TCP_GET* tcp_get, struct espconn* pespconn)
+{
+	//DISCONNECT / CONNECTION ERROR CALLBACK OF AN ESPCONN OF THE INSTANCE
+	//RETURN 1 IF IT BELONGS TO A CONNECT ATTEMPT (FAILED OR GIVEN UP) OR TO AN ESPCONN
+	//NO LONGER IN USE, AND SO HAS BEEN HANDLED HERE. A FAILED ATTEMPT MAKES ROOM FOR
+	//THE NEXT ADDRESS. THE CYCLE FAILS ONLY WHEN THE LAST ATTEMPT HAS FAILED
+
+	uint8_t index = _esp8266_tcp_get_attempt_index(tcp_get, pespconn);
+	ESP8266_TCP_GET_ATTEMPT* attempts = tcp_get->attempts;
+
+	if(attempts[index].aborting)
+	{
+		attempts[index].aborting = 0;
+		return 1;
+	}
+	if(!attempts[index].connecting)
+	{
+		return (pespconn != tcp_get->conn);
+	}
+
+	tcp_get->stats.connection_errors++;
+	_esp8266_tcp_get_attempt_failed(tcp_get, index);
+	if(!_esp8266_tcp_get_attempt_start(tcp_get) && !attempts[0].connecting && !attempts[1].connecting)
+	{
+		_esp8266_tcp_get_connect_failed(tcp_get);
+		return 1;
+	}
+	_esp8266_tcp_get_connect_arm(tcp_get);
+	return 1;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_connect_arm(ESP8266_TCP_GET* tcp_get)
+{
+	//ARM THE CONNECT TIMER FOR THE NEXT STAGGERED ATTEMPT OR THE DEADLINE, WHICHEVER IS FIRST
+
+	int32_t remaining = (int32_t)(tcp_get->connect_deadline - system_get_time()) / 1000;
+	uint32_t delay = (remaining > 0) ? remaining : 0;
+
+	if(tcp_get->address_next < tcp_get->address_order_count && tcp_get->connect_stagger_ms != 0 &&
+		tcp_get->connect_stagger_ms < delay)
+	{
+		delay = tcp_get->connect_stagger_ms;
+	}
+	_esp8266_tcp_get_timer_arm(&tcp_get->connect_timer, (delay != 0) ? delay : 1);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_connect_failed(ESP8266_TCP_GET* tcp_get)
+{
+	//NO CANDIDATE ADDRESS CONNECTED. GIVE THE SLOT BACK AND FAIL THE CYCLE
+
+	_esp8266_tcp_get_timer_cancel(&tcp_get->connect_timer);
+	_esp8266_tcp_get_slot_release(tcp_get);
+
+	//DEFERRED PROCESSING. THE CYCLE ENDS AFTER THE EVENTS STILL QUEUED
+	//AN EVENT THAT DOES NOT FIT IS HANDLED NOW
+	if(_esp8266_tcp_get_task_on && _esp8266_tcp_get_defer(tcp_get, ESP8266_TCP_GET_EVENT_ERROR, NULL, 0))
+	{
+		return;
+	}
+	_esp8266_tcp_get_reconnect_process(tcp_get);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_addresses_order(ESP8266_TCP_GET* tcp_get)
+{
+	//START OF THE CONNECT PHASE. ORDER THE CANDIDATE ADDRESSES BEST SCORE FIRST
+	//ENTRY 0 FOLLOWS THE HOST ADDRESS. WHEN THAT CHANGES, ITS SCORE STARTS AGAIN
+	//ADDRESSES NOT KNOWN YET (0) AND FAILOVER COPIES OF THE HOST ADDRESS ARE LEFT OUT
+
+	ESP8266_TCP_GET_ADDRESS* host = &tcp_get->addresses[0];
+	uint32_t score;
+	uint8_t count = 0;
+	uint8_t i;
+	uint8_t j;
+
+	if(host->ip.addr != tcp_get->resolved_host_ip.addr)
+	{
+		os_memset(host, 0, sizeof(ESP8266_TCP_GET_ADDRESS));
+		host->ip.addr = tcp_get->resolved_host_ip.addr;
+		host->connect_ms = ESP8266_TCP_GET_ADDRESS_UNTRIED_MS;
+	}
+
+	for(i = 0; i < tcp_get->address_count; i++)
+	{
+		if(tcp_get->addresses[i].ip.addr == 0 || (i != 0 && tcp_get->addresses[i].ip.addr == host->ip.addr))
+		{
+			continue;
+		}
+
+		//INSERTION SORT. EQUAL SCORES KEEP THE LIST ORDER
+		score = _esp8266_tcp_get_address_score(&tcp_get->addresses[i]);
+		for(j = count; j > 0 && _esp8266_tcp_get_address_score(&tcp_get->addresses[tcp_get->address_order[j - 1]]) > score; j--)
+		{
+			tcp_get->address_order[j] = tcp_get->address_order[j - 1];
+		}
+		tcp_get->address_order[j] = i;
+		count++;
+	}
+	tcp_get->address_order_count = count;
+	tcp_get->address_next = 0;
+}
+
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_address_score(ESP8266_TCP_GET_ADDRESS* address)
+{
+	//ORDERING SCORE OF A CANDIDATE ADDRESS. LOWER IS BETTER
+	//FAILURES IN A ROW FIRST, THEN THE AVERAGE CONNECT TIME (UNTRIED = SLOWEST)
+
+	return ((uint32_t)address->fail_streak << 16) | address->connect_ms;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_slot_enqueue(ESP8266_TCP_GET* tcp_get)
+{
+	//ADD THE INSTANCE TO THE END OF THE CONNECTION SLOT WAITING QUEUE
+
+	tcp_get->waiting_for_slot = 1;
+	tcp_get->next_waiting = NULL;
+	if(_esp8266_tcp_get_waiting_tail != NULL)
+	{
+		_esp8266_tcp_get_waiting_tail->next_waiting = tcp_get;
+	}
+	else
+	{
+		_esp8266_tcp_get_waiting_head = tcp_get;
+	}
+	_esp8266_tcp_get_waiting_tail = tcp_get;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_slot_dequeue(ESP8266_TCP_GET* tcp_get)
+{
+	//REMOVE THE INSTANCE FROM THE CONNECTION SLOT WAITING QUEUE (IF QUEUED)
+
+	ESP8266_TCP_GET* prev = NULL;
+	ESP8266_TCP_GET* cur = _esp8266_tcp_get_waiting_head;
+
+	while(cur != NULL && cur != tcp_get)
+	{
+		prev = cur;
+		cur = cur->next_waiting;
+	}
+	if(cur == NULL)
+	{
+		return;
+	}
+
+	if(prev != NULL)
+	{
+		prev->next_waiting = cur->next_waiting;
+	}
+	else
+	{
+		_esp8266_tcp_get_waiting_head = cur->next_waiting;
+	}
+	if(_esp8266_tcp_get_waiting_tail == cur)
+	{
+		_esp8266_tcp_get_waiting_tail = prev;
+	}
+	cur->next_waiting = NULL;
+	cur->waiting_for_slot = 0;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_slot_release(ESP8266_TCP_GET* tcp_get)
+{
+	//GIVE BACK THE CONNECTION SLOT HELD BY THE INSTANCE AND START THE
+	//CONNECTION OF THE FIRST INSTANCE WAITING FOR ONE
+	//A WAITING SECURE INSTANCE IS PASSED OVER WHILE THE TLS CONNECTION IS STILL IN USE
+
+	ESP8266_TCP_GET* next;
+
+	if(!tcp_get->holds_slot)
+	{
+		return;
+	}
+	tcp_get->holds_slot = 0;
+	_esp8266_tcp_get_open_connections--;
+	if(_esp8266_tcp_get_secure_owner == tcp_get)
+	{
+		_esp8266_tcp_get_secure_owner = NULL;
+	}
+
+	next = _esp8266_tcp_get_waiting_head;
+	while(next != NULL && next->secure && _esp8266_tcp_get_secure_owner != NULL)
+	{
+		next = next->next_waiting;
+	}
+	if(next != NULL)
+	{
+		_esp8266_tcp_get_slot_dequeue(next);
+		_esp8266_tcp_get_connect(next);
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_send_request(ESP8266_TCP_GET* tcp_get)
+{
+	//START A NEW REPLY AND SEND THE GET REQUEST ON THE CONNECTED ESPCONN
+
+	//CONNECTION IN USE. STOP THE KEEP-ALIVE IDLE TIMER
+	_esp8266_tcp_get_timer_cancel(&tcp_get->idle_timer);
+
+	//START A NEW REPLY
+	_esp8266_tcp_get_http_parser_reset(tcp_get);
+	tcp_get->reply_pending = 1;
+	tcp_get->queue_overflow = 0;
+	tcp_get->send_start_time = system_get_time();
+	tcp_get->sent_time = 0;
+	tcp_get->first_byte_received = 0;
+	tcp_get->parse_time = 0;
+	tcp_get->stream_events = 0;
+	_esp8266_tcp_get_sse_reset(tcp_get);
+
+	//RETURN LAST CYCLE'S SCRATCH SPACE
+	_esp8266_tcp_get_arena_rewind(tcp_get);
+
+	//SUBSCRIPTIONS CHANGED DURING THE LAST REPLY. THE EXTRACTOR IS FREE NOW
+	if(tcp_get->recompile_pending)
+	{
+		tcp_get->recompile_pending = 0;
+		_esp8266_tcp_get_subscribers_changed(tcp_get);
+	}
+
+	//START THE TCP GET REPLY TIMEOUT TIMER. IT COVERS THE SEND TOO, SO A
+	//REQUEST THAT IS NEVER ACKNOWLEDGED STILL ENDS THE CYCLE
+	_esp8266_tcp_get_timer_arm(&tcp_get->reply_timeout_timer, _esp8266_tcp_get_reply_timeout(tcp_get));
+
+	//POST / PUT. THE BODY FOLLOWS THE HEADERS FROM THE SENT CALLBACK
+	if(!_esp8266_tcp_get_upload_start(tcp_get))
+	{
+		_esp8266_tcp_get_reply_done(tcp_get, 0);
+		_esp8266_tcp_get_release_connection(tcp_get, 0);
+		return;
+	}
+
+	//SEND USER DATA (GET REQUEST) STRAIGHT FROM THE PREBUILT BUFFER
+	_esp8266_tcp_get_send(tcp_get, tcp_get->get_request_buffer, tcp_get->get_request_length);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_send(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length)
+{
+	//QUEUE DATA ON THE CONNECTED ESPCONN (PLAIN OR TLS)
+	//THE DATA MUST STAY VALID UNTIL THE SENT CALLBACK
+
+	if(tcp_get->secure)
+	{
+		espconn_secure_sent(tcp_get->conn, (uint8*)data, length);
+	}
+	else
+	{
+		espconn_sent(tcp_get->conn, (uint8*)data, length);
+	}
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_upload_start(ESP8266_TCP_GET* tcp_get)
+{
+	//START OF A REQUEST. FOR POST / PUT TAKE THE CHUNK BUFFER FROM THE ARENA SCRATCH
+	//AND FIX THE QUEUED READINGS THIS REQUEST CARRIES
+	//RETURNS 0 IF THE BODY CANNOT BE SENT
+
+	ESP8266_TCP_GET_UPLOAD_QUEUE* queue = &tcp_get->upload_queue;
+
+	tcp_get->upload_state = ESP8266_TCP_GET_UPLOAD_IDLE;
+	if(tcp_get->method == ESP8266_TCP_GET_METHOD_GET)
+	{
+		return 1;
+	}
+
+	tcp_get->upload_chunk = (char*)_esp8266_tcp_get_arena_alloc(tcp_get, ESP8266_TCP_GET_UPLOAD_CHUNK_SIZE, 0);
+	if(tcp_get->upload_chunk == NULL)
+	{
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_UPLOAD_NO_CHUNK, 0, 0);
+		return 0;
+	}
+
+	queue->sending = queue->length;
+	queue->sending_count = queue->count;
+	queue->cursor = 0;
+	tcp_get->upload_state = ESP8266_TCP_GET_UPLOAD_BODY;
+	tcp_get->stats.upload_requests++;
+	return 1;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_upload_chunk(ESP8266_TCP_GET* tcp_get)
+{
+	//SEND THE NEXT CHUNK OF THE REQUEST BODY ("<HEX LENGTH>\r\n<DATA>\r\n")
+	//OR THE LAST CHUNK ("0\r\n\r\n") ONCE THE PRODUCER HAS NO MORE
+	//THE DATA IS PRODUCED 6 BYTES INTO THE BUFFER AND THE LENGTH WRITTEN BACKWARDS IN FRONT OF IT
+
+	char* data = tcp_get->upload_chunk + 6;
+	char* start = data - 2;
+	uint16_t size = ESP8266_TCP_GET_UPLOAD_CHUNK_SIZE - 8;
+	uint16_t length;
+	uint16_t n;
+
+	//THE SERVER IS TAKING THE BODY. GIVE THE REPLY ITS FULL TIME AFTER THE LAST CHUNK
+	_esp8266_tcp_get_timer_arm(&tcp_get->reply_timeout_timer, _esp8266_tcp_get_reply_timeout(tcp_get));
+
+	if(tcp_get->upload_producer_cb != NULL)
+	{
+		length = (*tcp_get->upload_producer_cb)(tcp_get, data, size);
+	}
+	else
+	{
+		length = _esp8266_tcp_get_upload_queue_read(tcp_get, data, size);
+	}
+
+	if(length == 0)
+	{
+		tcp_get->upload_state = ESP8266_TCP_GET_UPLOAD_LAST;
+		os_memcpy(tcp_get->upload_chunk, "0\r\n\r\n", 5);
+		_esp8266_tcp_get_send(tcp_get, tcp_get->upload_chunk, 5);
+		return;
+	}
+	if(length > size)
+	{
+		length = size;
+	}
+
+	start[0] = '\r';
+	start[1] = '\n';
+	n = length;
+	do
+	{
+		*--start = "0123456789abcdef"[n & 0x0F];
+		n >>= 4;
+	}while(n != 0);
+	data[length] = '\r';
+	data[length + 1] = '\n';
+	_esp8266_tcp_get_send(tcp_get, start, (data + length + 2) - start);
+}
+
+uint16_t ICACHE_FLASH_ATTR _esp8266_tcp_get_upload_queue_read(ESP8266_TCP_GET* tcp_get, char* buffer, uint16_t size)
+{
+	//BUILT-IN BODY PRODUCER. THE QUEUED READINGS OF THE REQUEST IN PROGRESS, ONE PER LINE
+
+	ESP8266_TCP_GET_UPLOAD_QUEUE* queue = &tcp_get->upload_queue;
+	uint16_t length = queue->sending - queue->cursor;
+
+	if(length > size)
+	{
+		length = size;
+	}
+	os_memcpy(buffer, queue->buffer + queue->cursor, length);
+	queue->cursor += length;
+	return length;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_upload_done(ESP8266_TCP_GET* tcp_get, uint8_t success)
+{
+	//END OF THE REPLY TO A REQUEST. REMOVE THE READINGS IT CARRIED IF THE SERVER
+	//ACCEPTED (2XX) OR REJECTED (4XX) THEM. OTHERWISE THE NEXT REQUEST SENDS THEM AGAIN
+
+	ESP8266_TCP_GET_UPLOAD_QUEUE* queue = &tcp_get->upload_queue;
+	uint16_t status_code = tcp_get->http_parser.status_code;
+
+	if(tcp_get->upload_state == ESP8266_TCP_GET_UPLOAD_IDLE)
+	{
+		return;
+	}
+
+	//REPLY CAME BEFORE THE WHOLE BODY WAS SENT. THE CONNECTION CANNOT BE REUSED
+	if(tcp_get->upload_state != ESP8266_TCP_GET_UPLOAD_DONE)
+	{
+		tcp_get->http_parser.keep_alive = 0;
+	}
+	tcp_get->upload_state = ESP8266_TCP_GET_UPLOAD_IDLE;
+
+	//A REDIRECT (3XX) OR SERVER ERROR (5XX) IS NOT A VERDICT ON THE READINGS. KEEP THEM
+	if(success && ((status_code >= 200 && status_code < 300) || (status_code >= 400 && status_code < 500)) &&
+		queue->sending_count != 0)
+	{
+		if(status_code < 300)
+		{
+			tcp_get->stats.upload_readings += queue->sending_count;
+		}
+		else
+		{
+			tcp_get->stats.upload_dropped += queue->sending_count;
+			ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_READINGS_REJECTED, queue->sending_count, 0);
+		}
+		os_memmove(queue->buffer, queue->buffer + queue->sending, queue->length - queue->sending);
+		queue->length -= queue->sending;
+		queue->count -= queue->sending_count;
+		queue->first_time = queue->next_first_time;
+	}
+	queue->sending = 0;
+	queue->sending_count = 0;
+	queue->cursor = 0;
+}
+
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_upload_next(ESP8266_TCP_GET* tcp_get)
+{
+	//RETURN THE ms UNTIL THE QUEUED READINGS MAKE A BATCH
+	//0xFFFFFFFF IF THE QUEUE IS EMPTY OR HAS NO BATCH LIMITS
+
+	ESP8266_TCP_GET_UPLOAD_QUEUE* queue = &tcp_get->upload_queue;
+	uint32_t age;
+
+	if(queue->count == 0)
+	{
+		return 0xFFFFFFFF;
+	}
+	if(queue->batch_count != 0 && queue->count >= queue->batch_count)
+	{
+		return 0;
+	}
+	if(queue->batch_ms == 0)
+	{
+		return 0xFFFFFFFF;
+	}
+	age = (system_get_time() - queue->first_time) / 1000;
+	return (age < queue->batch_ms) ? (queue->batch_ms - age) : 0;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_upload_pull(ESP8266_TCP_GET* tcp_get)
+{
+	//BRING THE NEXT CYCLE FORWARD IF THE QUEUED READINGS MAKE A BATCH BEFORE IT
+	//NOT DURING A CYCLE (IT RESCHEDULES WHEN IT ENDS) OR WHILE BACKING OFF
+
+	uint32_t now = system_get_time();
+	uint32_t next;
+	uint32_t remaining;
+
+	if(!tcp_get->acquisition_running || tcp_get->cycle_active || tcp_get->consecutive_failures != 0)
+	{
+		return;
+	}
+	next = _esp8266_tcp_get_upload_next(tcp_get);
+	remaining = ((int32_t)(tcp_get->next_cycle_time - now) > 0) ? (tcp_get->next_cycle_time - now) / 1000 : 0;
+	if(next >= remaining)
+	{
+		return;
+	}
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_UPLOAD_DUE, 0, next);
+	tcp_get->next_cycle_time = now + next * 1000;
+	_esp8266_tcp_get_timer_arm(&tcp_get->timer, (next != 0) ? next : 1);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_release_connection(ESP8266_TCP_GET* tcp_get, uint8_t reusable)
+{
+	//END OF A REPLY. IN KEEP-ALIVE MODE A REUSABLE CONNECTION (REPLY FULLY READ AND THE
+	//SERVER DID NOT ASK TO CLOSE) IS KEPT OPEN UNTIL THE IDLE LIMIT. OTHERWISE DISCONNECT
+	//A TLS CONNECTION ANOTHER SECURE INSTANCE IS WAITING FOR IS ALWAYS CLOSED
+
+	ESP8266_TCP_GET* waiting = NULL;
+
+	if(!tcp_get->connected)
+	{
+		//ALREADY CLOSED (DEFERRED PROCESSING CAN END A REPLY AFTER THE DISCONNECT)
+		return;
+	}
+
+	if(tcp_get->secure)
+	{
+		waiting = _esp8266_tcp_get_waiting_head;
+		while(waiting != NULL && !waiting->secure)
+		{
+			waiting = waiting->next_waiting;
+		}
+	}
+
+	if(tcp_get->keep_alive && reusable && waiting == NULL)
+	{
+		_esp8266_tcp_get_timer_arm(&tcp_get->idle_timer, tcp_get->keep_alive_idle_timeout_ms);
+		return;
+	}
+
+	_esp8266_tcp_get_disconnect(tcp_get);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_disconnect(ESP8266_TCP_GET* tcp_get)
+{
+	//CLOSE THE INSTANCE CONNECTION THROUGH THE MATCHING (PLAIN / SECURE) ESPCONN API
+
+	//A CLOSE ALREADY UNDER WAY IS NOT ISSUED AGAIN (ESPCONN WOULD REFUSE IT)
+	if(tcp_get->closing)
+	{
+		return;
+	}
+
+	//THE CONNECTION IS CLOSING UNTIL ITS CALLBACK HAS BEEN PROCESSED
+	if((tcp_get->secure ? espconn_secure_disconnect(tcp_get->conn) : espconn_disconnect(tcp_get->conn)) == ESPCONN_OK)
+	{
+		tcp_get->closing = 1;
+	}
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_arena_reserve(ESP8266_TCP_GET* tcp_get, uint32_t arena_size)
+{
+	//RESERVE THE INSTANCE ARENA FROM THE HEAP. DONE ONCE PER INSTANCE
+	//RETURNS 1 ON SUCCESS (OR IF ALREADY RESERVED), 0 IF THE HEAP IS EXHAUSTED
+
+	ESP8266_TCP_GET_ARENA* arena = &tcp_get->arena;
+
+	if(arena->base != NULL)
+	{
+		return 1;
+	}
+
+	arena_size = (arena_size + ESP8266_TCP_GET_ARENA_ALIGN - 1) & ~(ESP8266_TCP_GET_ARENA_ALIGN - 1);
+	arena->base = (uint8_t*)os_zalloc(arena_size);
+	if(arena->base == NULL)
+	{
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_ARENA_FAILED, 0, arena_size);
+		return 0;
+	}
+	arena->size = arena_size;
+	arena->persistent = 0;
+	arena->used = 0;
+	arena->tables = arena_size;
+	arena->high_water = 0;
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_ARENA_RESERVED, 0, arena_size);
+	return 1;
+}
+
+void* ICACHE_FLASH_ATTR _esp8266_tcp_get_arena_alloc(ESP8266_TCP_GET* tcp_get, uint32_t size, uint8_t persistent)
+{
+	//TAKE A ZEROED, ALIGNED BLOCK FROM THE INSTANCE ARENA
+	//PERSISTENT(1) BLOCKS LIVE AS LONG AS THE INSTANCE AND MUST BE TAKEN WHILE
+	//NO SCRATCH IS OUTSTANDING (INITIALIZATION). SCRATCH(0) BLOCKS ARE RETURNED
+	//BY _esp8266_tcp_get_arena_rewind
+	//
+	//RETURNS NULL IF THE ARENA IS FULL
+
+	ESP8266_TCP_GET_ARENA* arena = &tcp_get->arena;
+	void* block;
+
+	if(arena->base == NULL && !_esp8266_tcp_get_arena_reserve(tcp_get, ESP8266_TCP_GET_ARENA_DEFAULT_SIZE))
+	{
+		return NULL;
+	}
+
+	size = (size + ESP8266_TCP_GET_ARENA_ALIGN - 1) & ~(ESP8266_TCP_GET_ARENA_ALIGN - 1);
+	if(size > arena->tables - arena->used)
+	{
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_ARENA_FULL, size, arena->used);
+		return NULL;
+	}
+
+	block = arena->base + arena->used;
+	arena->used += size;
+	if(persistent)
+	{
+		arena->persistent = arena->used;
+	}
+	if(arena->used + (arena->size - arena->tables) > arena->high_water)
+	{
+		arena->high_water = arena->used + (arena->size - arena->tables);
+	}
+	os_memset(block, 0, size);
+	return block;
+}
+
+void* ICACHE_FLASH_ATTR _esp8266_tcp_get_arena_alloc_table(ESP8266_TCP_GET* tcp_get, uint32_t size)
+{
+	//TAKE A ZEROED, ALIGNED BLOCK FOR THE EXTRACTOR TABLES FROM THE TOP OF THE ARENA
+	//THEY ARE THE ONLY BLOCKS TAKEN FROM THERE, SO EVERY REBUILD FREES THEM ALL
+	//(_esp8266_tcp_get_arena_tables_free) AND STARTS AGAIN AT THE SAME PLACE, WHATEVER
+	//PERSISTENT BLOCKS HAVE BEEN TAKEN SINCE THE LAST ONE
+	//
+	//RETURNS NULL IF THE ARENA IS FULL
+
+	ESP8266_TCP_GET_ARENA* arena = &tcp_get->arena;
+
+	if(arena->base == NULL && !_esp8266_tcp_get_arena_reserve(tcp_get, ESP8266_TCP_GET_ARENA_DEFAULT_SIZE))
+	{
+		return NULL;
+	}
+
+	size = (size + ESP8266_TCP_GET_ARENA_ALIGN - 1) & ~(ESP8266_TCP_GET_ARENA_ALIGN - 1);
+	if(size > arena->tables - arena->used)
+	{
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_ARENA_FULL, size, arena->used);
+		return NULL;
+	}
+
+	arena->tables -= size;
+	if(arena->used + (arena->size - arena->tables) > arena->high_water)
+	{
+		arena->high_water = arena->used + (arena->size - arena->tables);
+	}
+	os_memset(arena->base + arena->tables, 0, size);
+	return arena->base + arena->tables;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_arena_rewind(ESP8266_TCP_GET* tcp_get)
+{
+	//RETURN ALL SCRATCH BLOCKS. PERSISTENT BLOCKS AND THE EXTRACTOR TABLES ARE KEPT
+
+	tcp_get->arena.used = tcp_get->arena.persistent;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_arena_tables_free(ESP8266_TCP_GET* tcp_get)
+{
+	//RETURN THE EXTRACTOR TABLES. ONLY BEFORE THEY ARE BUILT AGAIN
+
+	tcp_get->arena.tables = tcp_get->arena.size;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_timer_setup(ESP8266_TCP_GET_TIMER* timer, void (*fn)(void*), void* arg, uint8_t type)
+{
+	//BIND A LIBRARY DEADLINE TO ITS CALLBACK. THE TIMER MUST NOT BE PENDING
+
+	os_memset(timer, 0, sizeof(ESP8266_TCP_GET_TIMER));
+	timer->fn = fn;
+	timer->arg = arg;
+	timer->type = type;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_timer_arm(ESP8266_TCP_GET_TIMER* timer, uint32_t ms)
+{
+	//(RE)ARM A ONE-SHOT DEADLINE ms FROM NOW. O(1)
+	//A DEADLINE MAY FIRE LATE BY UP TO 1/2^ESP8266_TCP_GET_WHEEL_SLACK_SHIFT OF ITS DELAY
+	//(AT MOST ESP8266_TCP_GET_WHEEL_MAX_SLACK_MS). IT IS ROUNDED UP TO A GRID OF THAT
+	//SIZE, SO DEADLINES THAT FALL CLOSE TOGETHER SHARE ONE WAKE-UP
+
+	ESP8266_TCP_GET_WHEEL* wheel = &_esp8266_tcp_get_wheel;
+	uint32_t slack = ms >> ESP8266_TCP_GET_WHEEL_SLACK_SHIFT;
+	uint32_t grid = 1;
+	uint32_t ticks = (ms + ESP8266_TCP_GET_WHEEL_TICK_MS - 1) / ESP8266_TCP_GET_WHEEL_TICK_MS;
+	uint32_t clock;
+	uint8_t was_wake = (timer->pprev != NULL && timer->expires == wheel->wake);
+
+	_esp8266_tcp_get_wheel_remove(timer);
+
+	if(slack > ESP8266_TCP_GET_WHEEL_MAX_SLACK_MS)
+	{
+		slack = ESP8266_TCP_GET_WHEEL_MAX_SLACK_MS;
+	}
+	slack /= ESP8266_TCP_GET_WHEEL_TICK_MS;
+	while((grid << 1) <= slack)
+	{
+		grid <<= 1;
+	}
+
+	//AN EMPTY WHEEL CARRIES ON FROM THE CURRENT TIME
+	clock = _esp8266_tcp_get_wheel_clock();
+	if(wheel->pending == 0 && !wheel->running)
+	{
+		wheel->now = clock;
+	}
+	timer->expires = (clock + ((ticks != 0) ? ticks : 1) + grid - 1) & ~(grid - 1);
+	_esp8266_tcp_get_wheel_insert(timer);
+
+	//THE os_timer IS SET AGAIN WHEN THE EXPIRED DEADLINES HAVE BEEN HANDLED
+	if(wheel->running)
+	{
+		return;
+	}
+	if(!wheel->armed || (int32_t)(timer->expires - wheel->wake) < 0)
+	{
+		_esp8266_tcp_get_wheel_sleep(timer->expires);
+	}
+	else if(was_wake)
+	{
+		//MOVED LATER. IT WAS THE ONE THE os_timer WAS SET FOR
+		_esp8266_tcp_get_wheel_program();
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_timer_cancel(ESP8266_TCP_GET_TIMER* timer)
+{
+	//CANCEL A DEADLINE. SAFE TO CALL IF IT IS NOT PENDING. O(1), EXCEPT THAT
+	//CANCELLING THE EARLIEST DEADLINE SETS THE os_timer FOR THE NEXT ONE
+
+	ESP8266_TCP_GET_WHEEL* wheel = &_esp8266_tcp_get_wheel;
+	uint8_t was_wake;
+
+	if(timer->pprev == NULL)
+	{
+		return;
+	}
+	was_wake = (timer->expires == wheel->wake);
+	_esp8266_tcp_get_wheel_remove(timer);
+
+	if(!wheel->running && wheel->armed && (was_wake || wheel->pending == 0))
+	{
+		_esp8266_tcp_get_wheel_program();
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_insert(ESP8266_TCP_GET_TIMER* timer)
+{
+	//PUT A TIMER IN THE LOWEST LEVEL ITS DELAY FROM THE LAST PROCESSED TICK FITS
+	//DELAYS BEYOND THE TOP LEVEL WAIT IN THE LAST SLOT IT REACHES AND ARE PLACED AGAIN FROM THERE
+
+	ESP8266_TCP_GET_WHEEL* wheel = &_esp8266_tcp_get_wheel;
+	int32_t delta = (int32_t)(timer->expires - wheel->now);
+	uint32_t position = timer->expires;
+	uint8_t level = 0;
+	uint8_t slot;
+
+	if(delta < 0)
+	{
+		delta = 0;
+		position = wheel->now;
+	}
+	while(level < ESP8266_TCP_GET_WHEEL_LEVELS - 1 &&
+			(uint32_t)delta >= (1UL << (ESP8266_TCP_GET_WHEEL_SLOT_BITS * (level + 1))))
+	{
+		level++;
+	}
+	if((uint32_t)delta >= (1UL << (ESP8266_TCP_GET_WHEEL_SLOT_BITS * ESP8266_TCP_GET_WHEEL_LEVELS)))
+	{
+		position = wheel->now + (1UL << (ESP8266_TCP_GET_WHEEL_SLOT_BITS * ESP8266_TCP_GET_WHEEL_LEVELS)) - 1;
+	}
+	slot = (position >> (ESP8266_TCP_GET_WHEEL_SLOT_BITS * level)) & (ESP8266_TCP_GET_WHEEL_SLOTS - 1);
+
+	timer->slot = level * ESP8266_TCP_GET_WHEEL_SLOTS + slot;
+	timer->next = wheel->slots[timer->slot];
+	if(timer->next != NULL)
+	{
+		timer->next->pprev = &timer->next;
+	}
+	timer->pprev = &wheel->slots[timer->slot];
+	wheel->slots[timer->slot] = timer;
+	wheel->occupied[level] |= (1UL << slot);
+	wheel->pending++;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_remove(ESP8266_TCP_GET_TIMER* timer)
+{
+	//TAKE A TIMER OFF THE WHEEL, IF IT IS ON IT
+
+	ESP8266_TCP_GET_WHEEL* wheel = &_esp8266_tcp_get_wheel;
+
+	if(timer->pprev == NULL)
+	{
+		return;
+	}
+	*timer->pprev = timer->next;
+	if(timer->next != NULL)
+	{
+		timer->next->pprev = timer->pprev;
+	}
+	if(wheel->slots[timer->slot] == NULL)
+	{
+		wheel->occupied[timer->slot / ESP8266_TCP_GET_WHEEL_SLOTS] &= ~(1UL << (timer->slot % ESP8266_TCP_GET_WHEEL_SLOTS));
+	}
+	timer->next = NULL;
+	timer->pprev = NULL;
+	wheel->pending--;
+}
+
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_clock(void)
+{
+	//RETURN THE CURRENT WHEEL TICK, COUNTED FROM system_get_time()
+	//THE os_timer NEVER SLEEPS LONGER THAN ESP8266_TCP_GET_WHEEL_MAX_SLEEP_MS, SO THE
+	//32 BIT us COUNTER NEVER WRAPS TWICE BETWEEN TWO READINGS WHILE DEADLINES ARE PENDING
+
+	ESP8266_TCP_GET_WHEEL* wheel = &_esp8266_tcp_get_wheel;
+	uint32_t now = system_get_time();
+	uint32_t ticks;
+
+	if(!wheel->started)
+	{
+		wheel->started = 1;
+		wheel->clock_us = now;
+		os_timer_setfn(&_esp8266_tcp_get_wheel_timer, (os_timer_func_t*)_esp8266_tcp_get_wheel_cb, NULL);
+	}
+	ticks = (now - wheel->clock_us) / (ESP8266_TCP_GET_WHEEL_TICK_MS * 1000);
+	wheel->clock += ticks;
+	wheel->clock_us += ticks * ESP8266_TCP_GET_WHEEL_TICK_MS * 1000;
+	return wheel->clock;
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_first(uint8_t level)
+{
+	//RETURN HOW MANY SLOTS AFTER THE CURRENT ONE THE FIRST NON EMPTY SLOT OF A LEVEL
+	//IS (1 TO ESP8266_TCP_GET_WHEEL_SLOTS, IN TIME ORDER). 0 = LEVEL EMPTY
+	//ONE uint32_t OF OCCUPIED BITS PER LEVEL (ESP8266_TCP_GET_WHEEL_SLOT_BITS = 5)
+
+	ESP8266_TCP_GET_WHEEL* wheel = &_esp8266_tcp_get_wheel;
+	uint32_t bits = wheel->occupied[level];
+	uint8_t start = ((wheel->now >> (ESP8266_TCP_GET_WHEEL_SLOT_BITS * level)) + 1) & (ESP8266_TCP_GET_WHEEL_SLOTS - 1);
+	uint8_t distance = 1;
+
+	if(bits == 0)
+	{
+		return 0;
+	}
+	if(start != 0)
+	{
+		bits = (bits >> start) | (bits << (ESP8266_TCP_GET_WHEEL_SLOTS - start));
+	}
+	while(!(bits & 1))
+	{
+		bits >>= 1;
+		distance++;
+	}
+	return distance;
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_next(uint32_t* tick, uint8_t exact)
+{
+	//FIND THE NEXT TICK AFTER THE LAST PROCESSED ONE THAT NEEDS THE WHEEL
+	//exact = 0 => THE FIRST TIMER OF LEVEL 0 OR THE FIRST CASCADE OF A HIGHER LEVEL
+	//exact = 1 => THE EARLIEST DEADLINE (LOOKS INTO THE FIRST SLOT OF THE HIGHER LEVELS)
+	//RETURNS 0 IF THE WHEEL IS EMPTY
+
+	ESP8266_TCP_GET_WHEEL* wheel = &_esp8266_tcp_get_wheel;
+	ESP8266_TCP_GET_TIMER* timer;
+	uint32_t candidate;
+	uint32_t cascade;
+	uint8_t parked;
+	uint8_t found = 0;
+	uint8_t distance;
+	uint8_t shift;
+	uint8_t level;
+
+	for(level = 0; level < ESP8266_TCP_GET_WHEEL_LEVELS; level++)
+	{
+		distance = _esp8266_tcp_get_wheel_first(level);
+		if(distance == 0)
+		{
+			continue;
+		}
+		shift = ESP8266_TCP_GET_WHEEL_SLOT_BITS * level;
+		candidate = ((wheel->now >> shift) + distance) << shift;
+		if(exact && level != 0)
+		{
+			//EVERY TIMER OF THE SLOT IS DUE AT OR AFTER ITS CASCADE
+			//A TOP LEVEL SLOT WITH A PARKED TIMER (DUE AFTER THE SLOT ENDS) CAN COME BEFORE
+			//A SLOT WITH AN EARLIER DEADLINE. THEN THE WHEEL WAKES FOR THE CASCADE
+			cascade = candidate;
+			parked = 0;
+			timer = wheel->slots[level * ESP8266_TCP_GET_WHEEL_SLOTS + ((candidate >> shift) & (ESP8266_TCP_GET_WHEEL_SLOTS - 1))];
+			candidate = timer->expires;
+			for(; timer != NULL; timer = timer->next)
+			{
+				if((int32_t)(timer->expires - candidate) < 0)
+				{
+					candidate = timer->expires;
+				}
+				parked |= ((timer->expires - cascade) >= (1UL << shift));
+			}
+			if(parked)
+			{
+				candidate = cascade;
+			}
+		}
+		if(!found || (int32_t)(candidate - *tick) < 0)
+		{
+			*tick = candidate;
+			found = 1;
+		}
+	}
+	return found;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_advance(uint32_t target)
+{
+	//PROCESS THE WHEEL UP TO TICK target. ONLY TICKS WITH A CASCADE OR A DUE TIMER ARE VISITED
+	//CALLBACKS MAY ARM AND CANCEL TIMERS, INCLUDING THOSE OF THE SAME TICK
+
+	ESP8266_TCP_GET_WHEEL* wheel = &_esp8266_tcp_get_wheel;
+	ESP8266_TCP_GET_TIMER* timer;
+	ESP8266_TCP_GET_TIMER* list;
+	uint32_t tick;
+	uint8_t shift;
+	uint8_t slot;
+	uint8_t level;
+
+	while(_esp8266_tcp_get_wheel_next(&tick, 0) && (int32_t)(tick - target) <= 0)
+	{
+		wheel->now = tick;
+
+		//HIGHEST LEVEL FIRST, SO TIMERS CAN MOVE DOWN MORE THAN ONE LEVEL AT ONCE
+		for(level = ESP8266_TCP_GET_WHEEL_LEVELS - 1; level > 0; level--)
+		{
+			shift = ESP8266_TCP_GET_WHEEL_SLOT_BITS * level;
+			slot = (tick >> shift) & (ESP8266_TCP_GET_WHEEL_SLOTS - 1);
+			if((tick & ((1UL << shift) - 1)) != 0 || !(wheel->occupied[level] & (1UL << slot)))
+			{
+				continue;
+			}
+			list = wheel->slots[level * ESP8266_TCP_GET_WHEEL_SLOTS + slot];
+			wheel->slots[level * ESP8266_TCP_GET_WHEEL_SLOTS + slot] = NULL;
+			wheel->occupied[level] &= ~(1UL << slot);
+			while(list != NULL)
+			{
+				timer = list;
+				list = list->next;
+				wheel->pending--;
+				_esp8266_tcp_get_wheel_insert(timer);
+			}
+		}
+
+		//EXPIRE THE TIMERS OF THIS TICK
+		slot = tick & (ESP8266_TCP_GET_WHEEL_SLOTS - 1);
+		while((timer = wheel->slots[slot]) != NULL)
+		{
+			_esp8266_tcp_get_wheel_remove(timer);
+			(*timer->fn)(timer->arg);
+		}
+	}
+	wheel->now = target;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_program(void)
+{
+	//SET THE os_timer FOR THE EARLIEST PENDING DEADLINE. STOP IT IF THERE IS NONE
+
+	uint32_t tick;
+
+	if(!_esp8266_tcp_get_wheel_next(&tick, 1))
+	{
+		os_timer_disarm(&_esp8266_tcp_get_wheel_timer);
+		_esp8266_tcp_get_wheel.armed = 0;
+		return;
+	}
+	_esp8266_tcp_get_wheel_sleep(tick);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_sleep(uint32_t tick)
+{
+	//SET THE os_timer FOR THE START OF A WHEEL TICK
+	//LONG SLEEPS ARE CUT TO ESP8266_TCP_GET_WHEEL_MAX_SLEEP_MS. THE WHEEL THEN JUST SLEEPS AGAIN
+
+	ESP8266_TCP_GET_WHEEL* wheel = &_esp8266_tcp_get_wheel;
+	int32_t ticks = (int32_t)(tick - _esp8266_tcp_get_wheel_clock());
+	uint32_t into_tick_us = system_get_time() - wheel->clock_us;
+	uint32_t ms = 1;
+
+	if(ticks > ESP8266_TCP_GET_WHEEL_MAX_SLEEP_MS / ESP8266_TCP_GET_WHEEL_TICK_MS)
+	{
+		ticks = ESP8266_TCP_GET_WHEEL_MAX_SLEEP_MS / ESP8266_TCP_GET_WHEEL_TICK_MS;
+	}
+	if(ticks > 0)
+	{
+		ms = ((uint32_t)ticks * ESP8266_TCP_GET_WHEEL_TICK_MS * 1000 - into_tick_us + 999) / 1000;
+	}
+
+	os_timer_disarm(&_esp8266_tcp_get_wheel_timer);
+	os_timer_arm(&_esp8266_tcp_get_wheel_timer, (ms != 0) ? ms : 1, 0);
+	wheel->wake = tick;
+	wheel->armed = 1;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_cb(void* arg)
+{
+	//CALLBACK FOR THE TIMER WHEEL os_timer
+	//EXPIRE EVERY DEADLINE THAT IS DUE, THEN SLEEP UNTIL THE NEXT ONE
+
+	ESP8266_TCP_GET_WHEEL* wheel = &_esp8266_tcp_get_wheel;
+
+	wheel->armed = 0;
+	wheel->wakes++;
+	wheel->running = 1;
+	_esp8266_tcp_get_wheel_advance(_esp8266_tcp_get_wheel_clock());
+	wheel->running = 0;
+	_esp8266_tcp_get_wheel_program();
+}
+
+#if ESP8266_TCP_GET_LOG_LEVEL > ESP8266_TCP_GET_LOG_LEVEL_NONE
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_log(ESP8266_TCP_GET* tcp_get, uint8_t event, uint16_t a, uint32_t b)
+{
+	//WRITE A TRACE RECORD TO THE LOG RING (tcp_get = NULL FOR LIBRARY WIDE EVENTS)
+	//NO FORMATTING AND NO UART HERE. A RECORD THAT DOES NOT FIT IS COUNTED, AND THE
+	//COUNT IS LOGGED AHEAD OF THE FIRST RECORD THAT FITS AGAIN
+
+	ESP8266_TCP_GET_LOG* log = &_esp8266_tcp_get_log_ring;
+	ESP8266_TCP_GET_LOG_RECORD* record;
+	uint32_t drops;
+
+	if(!_esp8266_tcp_get_debug)
+	{
+		return;
+	}
+
+	if(log->drops != 0)
+	{
+		if(log->count > ESP8266_TCP_GET_LOG_RECORDS - 2)
+		{
+			log->drops++;
+			return;
+		}
+		drops = log->drops;
+		log->drops = 0;
+		_esp8266_tcp_get_log(NULL, ESP8266_TCP_GET_LOG_EVENT_DROPPED, 0, drops);
+	}
+	else if(log->count == ESP8266_TCP_GET_LOG_RECORDS)
+	{
+		log->drops = 1;
+		return;
+	}
+
+	record = &log->records[(log->first + log->count) % ESP8266_TCP_GET_LOG_RECORDS];
+	record->time = system_get_time();
+	record->event = event;
+	record->instance = (tcp_get != NULL) ? tcp_get->log_id : 0;
+	record->a = a;
+	record->b = b;
+	log->count++;
+
+	if(log->task_on && !log->task_posted)
+	{
+		log->task_posted = system_os_post(log->task_priority, 0, 0);
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_log_frame(uint8_t* frame)
+{
+	//TAKE THE OLDEST RECORD OFF THE LOG RING AS A FRAME
+	//SYNC BYTES, RECORD (LITTLE ENDIAN), LOW BYTE OF THE SUM OF THE RECORD BYTES
+
+	ESP8266_TCP_GET_LOG* log = &_esp8266_tcp_get_log_ring;
+	ESP8266_TCP_GET_LOG_RECORD* record = &log->records[log->first];
+	uint8_t sum = 0;
+	uint8_t i;
+
+	frame[0] = ESP8266_TCP_GET_LOG_SYNC_0;
+	frame[1] = ESP8266_TCP_GET_LOG_SYNC_1;
+	frame[2] = (uint8_t)record->time;
+	frame[3] = (uint8_t)(record->time >> 8);
+	frame[4] = (uint8_t)(record->time >> 16);
+	frame[5] = (uint8_t)(record->time >> 24);
+	frame[6] = record->event;
+	frame[7] = record->instance;
+	frame[8] = (uint8_t)record->a;
+	frame[9] = (uint8_t)(record->a >> 8);
+	frame[10] = (uint8_t)record->b;
+	frame[11] = (uint8_t)(record->b >> 8);
+	frame[12] = (uint8_t)(record->b >> 16);
+	frame[13] = (uint8_t)(record->b >> 24);
+	for(i = 2; i < ESP8266_TCP_GET_LOG_FRAME_SIZE - 1; i++)
+	{
+		sum += frame[i];
+	}
+	frame[ESP8266_TCP_GET_LOG_FRAME_SIZE - 1] = sum;
+
+	log->first = (log->first + 1) % ESP8266_TCP_GET_LOG_RECORDS;
+	log->count--;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_log_task(os_event_t* event)
+{
+	//LOG DRAIN TASK
+	//SENDS A BATCH OF RECORDS AND POSTS ITSELF AGAIN WHILE MORE ARE WAITING,
+	//SO OTHER TASKS RUN BETWEEN BATCHES
+
+	ESP8266_TCP_GET_LOG* log = &_esp8266_tcp_get_log_ring;
+	uint8_t frames[ESP8266_TCP_GET_LOG_DRAIN_BATCH * ESP8266_TCP_GET_LOG_FRAME_SIZE];
+	uint16_t length = 0;
+
+	log->task_posted = 0;
+	while(log->count != 0 && length < sizeof(frames))
+	{
+		_esp8266_tcp_get_log_frame(frames + length);
+		length += ESP8266_TCP_GET_LOG_FRAME_SIZE;
+	}
+	if(length != 0)
+	{
+		log->write_fn(frames, length);
+	}
+
+	if(log->count != 0 && !log->task_posted)
+	{
+		log->task_posted = system_os_post(log->task_priority, 0, 0);
+	}
+}
+#endif
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_stats_record(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_PHASE phase, uint32_t duration_us)
+{
+	//STORE THE DURATION OF A CYCLE PHASE AND COUNT IT IN THE PHASE HISTOGRAM
+
+	uint32_t ms = duration_us / 1000;
+	uint8_t bucket = 0;
+
+	while(ms != 0 && bucket < (ESP8266_TCP_GET_STATS_BUCKET_COUNT - 1))
+	{
+		ms >>= 1;
+		bucket++;
+	}
+
+	tcp_get->stats.last_us[phase] = duration_us;
+	if(tcp_get->stats.histogram[phase][bucket] != 0xFFFF)
+	{
+		tcp_get->stats.histogram[phase][bucket]++;
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_cycle_done(ESP8266_TCP_GET* tcp_get, uint8_t success, uint8_t changed)
+{
+	//END THE CURRENT DATA ACQUISITION CYCLE AND ARM THE ONE-SHOT TIMER FOR THE NEXT
+	//SUCCESS => ADAPT THE INTERVAL WITHIN THE USER BOUNDS (CHANGED DATA => FASTER)
+	//FAILURE => EXPONENTIAL BACKOFF ON THE CURRENT INTERVAL (THE RECONNECT DELAY OF A STREAM)
+	//BOTH GET RANDOM JITTER SO DEVICES STARTED TOGETHER DO NOT POLL IN LOCKSTEP
+	//SAFE TO CALL MORE THAN ONCE PER CYCLE. ONLY THE FIRST CALL HAS ANY EFFECT
+
+	uint32_t base = (tcp_get->stream_mode != ESP8266_TCP_GET_STREAM_OFF) ? tcp_get->stream_retry_ms : tcp_get->current_interval;
+	uint32_t delay;
+	uint32_t spread;
+	uint32_t limit;
+	uint32_t next;
+	uint8_t shift;
+
+	if(!tcp_get->cycle_active)
+	{
+		return;
+	}
+	tcp_get->cycle_active = 0;
+
+	if(success)
+	{
+		tcp_get->consecutive_failures = 0;
+		if(changed)
+		{
+			tcp_get->current_interval /= 2;
+			if(tcp_get->current_interval < tcp_get->interval_min)
+			{
+				tcp_get->current_interval = tcp_get->interval_min;
+			}
+		}
+		else
+		{
+			tcp_get->current_interval += tcp_get->current_interval / 4;
+			if(tcp_get->current_interval > tcp_get->interval_max)
+			{
+				tcp_get->current_interval = tcp_get->interval_max;
+			}
+		}
+
+		//+/- ESP8266_TCP_GET_JITTER_PERCENT
+		delay = tcp_get->current_interval;
+		spread = (delay / 100) * ESP8266_TCP_GET_JITTER_PERCENT;
+		delay = delay - spread + (os_random() % (2 * spread + 1));
+
+		//NO LATER THAN THE DATA OF THE FIRST SUBSCRIBER GOES STALE. WITHOUT A MAIN
+		//CONTAINER THE SUBSCRIBERS ALONE SET THE PACE
+		next = _esp8266_tcp_get_subscribers_next(tcp_get);
+		if(next != 0xFFFFFFFF && (next < delay || tcp_get->user_data_container == NULL))
+		{
+			delay = next;
+		}
+
+		//NO LATER THAN THE QUEUED READINGS MAKE AN UPLOAD BATCH
+		next = _esp8266_tcp_get_upload_next(tcp_get);
+		if(next < delay)
+		{
+			delay = next;
+		}
+
+		//STREAMS ARE NOT POLLED. A LONG POLL GOES OUT AGAIN RIGHT AWAY, AN ENDED
+		//SSE STREAM RECONNECTS AFTER THE RETRY DELAY
+		if(tcp_get->stream_mode == ESP8266_TCP_GET_STREAM_LONG_POLL)
+		{
+			delay = 0;
+		}
+		else if(tcp_get->stream_mode == ESP8266_TCP_GET_STREAM_SSE)
+		{
+			spread = (base / 100) * ESP8266_TCP_GET_JITTER_PERCENT;
+			delay = base - spread + (os_random() % (2 * spread + 1));
+		}
+	}
+	else
+	{
+		if(tcp_get->consecutive_failures < 0xFF)
+		{
+			tcp_get->consecutive_failures++;
+		}
+		shift = (tcp_get->consecutive_failures < ESP8266_TCP_GET_BACKOFF_MAX_SHIFT) ?
+					tcp_get->consecutive_failures : ESP8266_TCP_GET_BACKOFF_MAX_SHIFT;
+		limit = (tcp_get->interval_max > ESP8266_TCP_GET_BACKOFF_MAX_MS) ? tcp_get->interval_max : ESP8266_TCP_GET_BACKOFF_MAX_MS;
+		delay = (base > (limit >> shift)) ? limit : (base << shift);
+
+		//EQUAL JITTER : HALF FIXED, HALF RANDOM
+		delay = (delay / 2) + (os_random() % (delay / 2 + 1));
+
+		ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_CYCLE_FAILED, tcp_get->consecutive_failures, 0);
+	}
+
+	if(!tcp_get->acquisition_running)
+	{
+		return;
+	}
+
+	ESP8266_TCP_GET_LOG_DEBUG(tcp_get, ESP8266_TCP_GET_LOG_EVENT_NEXT_CYCLE, 0, delay);
+	tcp_get->next_cycle_time = system_get_time() + delay * 1000;
+	_esp8266_tcp_get_timer_arm(&tcp_get->timer, (delay != 0) ? delay : 1);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_subscribers_mark_due(ESP8266_TCP_GET* tcp_get)
+{
+	//START OF A CYCLE. THE FETCH IS FOR EVERY SUBSCRIBER WITHOUT DATA OR WHOSE DATA IS
+	//AT LEAST HALF WAY TO ITS MAXIMUM STALENESS. THOSE CLOSE TO DUE COME ALONG NOW
+	//RATHER THAN NEEDING A FETCH OF THEIR OWN SHORTLY AFTER
+
+	ESP8266_TCP_GET_SUBSCRIBER* subscriber;
+	uint32_t now = system_get_time();
+
+	for(subscriber = tcp_get->subscribers; subscriber != NULL; subscriber = subscriber->next)
+	{
+		//EVERY EVENT OF AN SSE STREAM IS FOR EVERY SUBSCRIBER
+		subscriber->due = (tcp_get->stream_mode == ESP8266_TCP_GET_STREAM_SSE || !subscriber->has_data ||
+							(now - subscriber->last_update_time) / 1000 >= subscriber->max_staleness_ms / 2);
+	}
+}
+
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_subscribers_next(ESP8266_TCP_GET* tcp_get)
+{
+	//RETURN THE ms UNTIL THE DATA OF THE FIRST SUBSCRIBER GOES STALE
+	//0xFFFFFFFF IF THERE ARE NO SUBSCRIBERS
+
+	ESP8266_TCP_GET_SUBSCRIBER* subscriber;
+	uint32_t now = system_get_time();
+	uint32_t next = 0xFFFFFFFF;
+	uint32_t age;
+
+	for(subscriber = tcp_get->subscribers; subscriber != NULL; subscriber = subscriber->next)
+	{
+		age = (now - subscriber->last_update_time) / 1000;
+		if(!subscriber->has_data || age >= subscriber->max_staleness_ms)
+		{
+			return 0;
+		}
+		if(subscriber->max_staleness_ms - age < next)
+		{
+			next = subscriber->max_staleness_ms - age;
+		}
+	}
+	return next;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_subscribers_changed(ESP8266_TCP_GET* tcp_get)
+{
+	//REBUILD THE EXTRACTOR FOR THE CURRENT SET OF SUBSCRIBERS
+	//NOT WHILE A REPLY IS BEING EXTRACTED. THEN IT IS DONE BEFORE THE NEXT REQUEST
+
+	if(tcp_get->reply_pending)
+	{
+		tcp_get->recompile_pending = 1;
+		return;
+	}
+	if(!_esp8266_tcp_get_extractor_compile(tcp_get))
+	{
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_EXTRACTOR_NOT_SET_UP, 0, 0);
+		tcp_get->state = ESP8266_TCP_GET_STATE_ERROR;
+	}
+}
+
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_data_hash(ESP8266_TCP_GET* tcp_get)
+{
+	//FNV-1A HASH OF THE FOUND FLAGS AND VALUES OF ALL USER DATA FIELDS
+	//(MAIN CONTAINER AND SUBSCRIBERS)
+
+	ESP8266_TCP_GET_EXTRACTOR* ex = &tcp_get->extractor;
+	uint32_t hash = ESP8266_TCP_GET_FNV_OFFSET_BASIS;
+	const char* ptr;
+	uint8_t i;
+
+	if(ex->field_count == 0)
+	{
+		return 0;
+	}
+
+	for(i = 0; i < ex->field_count; i++)
+	{
+		hash = (hash ^ ex->data[i]->data_found) * ESP8266_TCP_GET_FNV_PRIME;
+		for(ptr = ex->data[i]->extracted_data; *ptr != '\0'; ptr++)
+		{
+			hash = (hash ^ (uint8_t)*ptr) * ESP8266_TCP_GET_FNV_PRIME;
+		}
+	}
+	return hash;
+}
+
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_fnv(uint32_t hash, const uint8_t* data, uint32_t length)
+{
+	//CONTINUE AN FNV-1A HASH OVER length BYTES
+
+	while(length-- != 0)
+	{
+		hash = (hash ^ *data++) * ESP8266_TCP_GET_FNV_PRIME;
+	}
+	return hash;
+}
+
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_config_hash(ESP8266_TCP_GET* tcp_get)
+{
+	//HASH OF THE CONFIGURATION A SNAPSHOT IS ONLY VALID FOR
+	//(HOST, PATH, PORT, EXTRACTION MODE AND THE RULE OF EVERY FIELD)
+
+	const char* host = (tcp_get->host_name != NULL) ? tcp_get->host_name : tcp_get->host_ip;
+	uint32_t hash = ESP8266_TCP_GET_FNV_OFFSET_BASIS;
+	uint8_t i;
+
+	if(host != NULL)
+	{
+		hash = _esp8266_tcp_get_fnv(hash, (const uint8_t*)host, os_strlen(host) + 1);
+	}
+	hash = _esp8266_tcp_get_fnv(hash, (const uint8_t*)tcp_get->host_path, os_strlen(tcp_get->host_path) + 1);
+	hash = _esp8266_tcp_get_fnv(hash, (const uint8_t*)&tcp_get->host_port, 2);
+	hash = _esp8266_tcp_get_fnv(hash, &tcp_get->json_mode, 1);
+	hash = _esp8266_tcp_get_fnv(hash, &tcp_get->extractor.field_count, 1);
+	for(i = 0; i < tcp_get->extractor.field_count && tcp_get->extractor.fields != NULL; i++)
+	{
+		//THE KEY PATH HASH STANDS IN FOR THE MATCH STRING, WHICH MAY BE IN FLASH
+		hash = _esp8266_tcp_get_fnv(hash, (const uint8_t*)&tcp_get->extractor.json_paths[i], 4);
+		hash = _esp8266_tcp_get_fnv(hash, &tcp_get->extractor.fields[i].length, 1);
+		hash = _esp8266_tcp_get_fnv(hash, &tcp_get->extractor.fields[i].offset, 1);
+		hash = _esp8266_tcp_get_fnv(hash, &tcp_get->extractor.fields[i].char_len, 1);
+	}
+	return hash;
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_rtc_block_valid(uint8_t rtc_block)
+{
+	//A SNAPSHOT STARTING AT rtc_block FITS IN RTC USER MEMORY
+
+	return (rtc_block >= ESP8266_TCP_GET_RTC_USER_BLOCK_FIRST &&
+			rtc_block + sizeof(ESP8266_TCP_GET_SNAPSHOT) / 4 - 1 <= ESP8266_TCP_GET_RTC_USER_BLOCK_LAST);
+}
+
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_field_hash(ESP8266_TCP_GET_EXTRACTED_DATA* data)
+{
+	//FNV-1A HASH OF THE FOUND FLAG AND (IF FOUND) THE VALUE OF A USER DATA FIELD
+
+	uint32_t hash = _esp8266_tcp_get_fnv(ESP8266_TCP_GET_FNV_OFFSET_BASIS, &data->data_found, 1);
+
+	if(data->data_found)
+	{
+		hash = _esp8266_tcp_get_fnv(hash, (const uint8_t*)data->extracted_data, os_strlen(data->extracted_data));
+	}
+	return hash;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_bind_fields(ESP8266_TCP_GET* tcp_get, uint8_t back)
+{
+	//POINT THE EXTRACTOR FIELDS OF DOUBLE BUFFERED CONTAINERS AT THEIR BACK BUFFER
+	//(back = 1, FOR A NEW REPLY) OR AT THE PUBLISHED DATA (back = 0)
+	//SUBSCRIBERS THE REPLY IS NOT FOR STAY ON THEIR PUBLISHED DATA
+
+	ESP8266_TCP_GET_EXTRACTOR* ex = &tcp_get->extractor;
+	ESP8266_TCP_GET_SUBSCRIBER* subscriber;
+	uint8_t count;
+
+	//THE MAIN CONTAINER HAS THE FIRST FIELDS
+	if(tcp_get->user_data_container != NULL)
+	{
+		count = (tcp_get->user_data_container->tcp_reply_extracted_data_count < ex->field_count) ?
+					tcp_get->user_data_container->tcp_reply_extracted_data_count : ex->field_count;
+		_esp8266_tcp_get_bind_container(tcp_get, tcp_get->user_data_container, 0, count, back);
+	}
+	for(subscriber = tcp_get->subscribers; subscriber != NULL; subscriber = subscriber->next)
+	{
+		_esp8266_tcp_get_bind_container(tcp_get, subscriber->container, subscriber->field_start,
+										subscriber->field_count, back && subscriber->due);
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_bind_container(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_USER_DATA_CONTAINER* container,
+														uint8_t start, uint8_t count, uint8_t back)
+{
+	//POINT count EXTRACTOR FIELDS FROM start ON AT THE BACK BUFFER OF A CONTAINER
+	//(CLEARED FOR THE NEW REPLY) OR AT ITS PUBLISHED DATA
+
+	ESP8266_TCP_GET_EXTRACTED_DATA* data;
+	uint8_t i;
+
+	if(container->tcp_reply_back_data == NULL)
+	{
+		return;
+	}
+
+	for(i = 0; i < count; i++)
+	{
+		if(back)
+		{
+			data = &container->tcp_reply_back_data[i];
+			data->data_found = 0;
+			data->extracted_data[0] = '\0';
+			data->extracted_value = 0;
+			data->extracted_value_decimals = 0;
+		}
+		else
+		{
+			data = &container->tcp_reply_extracted_data[i];
+		}
+		tcp_get->extractor.data[start + i] = data;
+	}
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_container_publish(ESP8266_TCP_GET_USER_DATA_CONTAINER* container, uint8_t new_data)
+{
+	//END OF A REPLY FOR A CONTAINER
+	//new_data = 1 => SET THE HASH AND CHANGED BIT OF EVERY FIELD AND PUBLISH THE DATA
+	//(SWAP IN THE BACK BUFFER OF A DOUBLE BUFFERED CONTAINER)
+	//new_data = 0 => NOTHING CHANGED (304). CLEAR THE CHANGED BITS
+	//RETURNS 1 IF THE USER IS TO BE NOTIFIED : A FIELD CHANGED, A FIELD WANTS EVERY REPLY
+	//OR THE CONTAINER HAS NO FIELDS
+
+	ESP8266_TCP_GET_EXTRACTED_DATA* published = container->tcp_reply_extracted_data;
+	ESP8266_TCP_GET_EXTRACTED_DATA* fresh = (container->tcp_reply_back_data != NULL) ? container->tcp_reply_back_data : published;
+	uint32_t hash;
+	uint8_t notify = (container->tcp_reply_extracted_data_count == 0);
+	uint8_t i;
+
+	if(!new_data)
+	{
+		fresh = published;
+	}
+
+	for(i = 0; i < container->tcp_reply_extracted_data_count; i++)
+	{
+		if(new_data)
+		{
+			//COMPARED WITH THE HASH OF THE LAST PUBLISHED DATA
+			hash = _esp8266_tcp_get_field_hash(&fresh[i]);
+			fresh[i].changed = (hash != published[i].hash);
+			fresh[i].hash = hash;
+		}
+		else
+		{
+			fresh[i].changed = 0;
+		}
+		if(!fresh[i].notify_only_on_change || fresh[i].changed)
+		{
+			notify = 1;
+		}
+	}
+
+	if(new_data)
+	{
+		if(container->tcp_reply_back_data != NULL)
+		{
+			container->tcp_reply_back_data = published;
+			container->tcp_reply_extracted_data = fresh;
+		}
+		container->tcp_reply_sequence++;
+	}
+	return notify;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_http_parser_reset(ESP8266_TCP_GET* tcp_get)
+{
+	//RESET THE HTTP REPLY PARSER FOR A NEW REPLY
+
+	os_memset(&tcp_get->http_parser, 0, sizeof(ESP8266_TCP_GET_HTTP_PARSER));
+	tcp_get->http_parser.state = ESP8266_TCP_GET_HTTP_PARSER_STATUS_LINE;
+	tcp_get->inflate = NULL;
+}
+
+uint16_t ICACHE_FLASH_ATTR _esp8266_tcp_get_http_parse(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length)
+{
+	//INCREMENTAL HTTP/1.1 REPLY PARSER
+	//FEEDS ONE TCP SEGMENT THROUGH THE STATUS-LINE / HEADER / BODY STATE MACHINE.
+	//STATE IS KEPT BETWEEN CALLS SO LINES AND BODIES CAN SPAN ANY NUMBER OF SEGMENTS
+	//
+	//RETURNS THE NUMBER OF BYTES CONSUMED. PARSING STOPS AT THE LAST BYTE OF THE
+	//REPLY (STATE DONE) OR ON A MALFORMED REPLY (STATE ERROR)
+
+	ESP8266_TCP_GET_HTTP_PARSER* parser = &tcp_get->http_parser;
+	uint16_t i = 0;
+	uint16_t start;
+	uint32_t n;
+
+	while(i < length && parser->state != ESP8266_TCP_GET_HTTP_PARSER_DONE &&
+			parser->state != ESP8266_TCP_GET_HTTP_PARSER_ERROR)
+	{
+		switch(parser->state)
+		{
+			case ESP8266_TCP_GET_HTTP_PARSER_STATUS_LINE:
+			case ESP8266_TCP_GET_HTTP_PARSER_HEADERS:
+			case ESP8266_TCP_GET_HTTP_PARSER_CHUNK_SIZE:
+			case ESP8266_TCP_GET_HTTP_PARSER_CHUNK_TRAILER:
+				//LINE ORIENTED STATES. COLLECT A COMPLETE LINE BEFORE PROCESSING IT
+				//LINES LONGER THAN THE LINE BUFFER ARE TRUNCATED
+				start = i;
+				while(i < length && data[i] != '\n')
+				{
+					if(parser->line_length < (ESP8266_TCP_GET_HTTP_LINE_BUFFER_SIZE - 1))
+					{
+						parser->line[parser->line_length++] = data[i];
+					}
+					i++;
+				}
+				if(i < length)
+				{
+					//INCLUDE THE LINE FEED
+					i++;
+				}
+
+				//HEADERS ARE PASSED TO THE EXTRACTOR AS RECEIVED. THE STATUS LINE IS
+				//PASSED ONCE PROCESSED, SO A 304 REPLY NEVER REACHES THE EXTRACTOR
+				//AN SSE STREAM IS EXTRACTED PER EVENT. ITS HEADERS BELONG TO NO EVENT
+				if(parser->state == ESP8266_TCP_GET_HTTP_PARSER_HEADERS && parser->status_code != 304 && !tcp_get->json_mode &&
+					tcp_get->stream_mode != ESP8266_TCP_GET_STREAM_SSE)
+				{
+					_esp8266_tcp_get_extractor_feed(tcp_get, data + start, i - start);
+				}
+
+				if(data[i - 1] == '\n')
+				{
+					if(parser->line_length > 0 && parser->line[parser->line_length - 1] == '\r')
+					{
+						parser->line_length--;
+					}
+					parser->line[parser->line_length] = '\0';
+					_esp8266_tcp_get_http_process_line(tcp_get);
+					parser->line_length = 0;
+				}
+				break;
+
+			case ESP8266_TCP_GET_HTTP_PARSER_BODY_IDENTITY:
+			case ESP8266_TCP_GET_HTTP_PARSER_CHUNK_DATA:
+				//CONSUME AS MUCH OF THE REMAINING BODY / CHUNK AS THIS SEGMENT HOLDS
+				n = length - i;
+				if(n > parser->body_remaining)
+				{
+					n = parser->body_remaining;
+				}
+				_esp8266_tcp_get_body_feed(tcp_get, data + i, n);
+				parser->body_remaining -= n;
+				parser->body_received += n;
+				i += n;
+
+				if(parser->body_remaining == 0 && parser->state != ESP8266_TCP_GET_HTTP_PARSER_ERROR)
+				{
+					parser->state = (parser->state == ESP8266_TCP_GET_HTTP_PARSER_BODY_IDENTITY) ?
+										ESP8266_TCP_GET_HTTP_PARSER_DONE : ESP8266_TCP_GET_HTTP_PARSER_CHUNK_DATA_END;
+				}
+				break;
+
+			case ESP8266_TCP_GET_HTTP_PARSER_CHUNK_DATA_END:
+				//SKIP THE CRLF FOLLOWING THE CHUNK DATA
+				if(data[i] == '\n')
+				{
+					parser->state = ESP8266_TCP_GET_HTTP_PARSER_CHUNK_SIZE;
+				}
+				i++;
+				break;
+
+			case ESP8266_TCP_GET_HTTP_PARSER_BODY_UNTIL_CLOSE:
+			default:
+				//BODY ENDS WHEN THE SERVER CLOSES THE CONNECTION
+				_esp8266_tcp_get_body_feed(tcp_get, data + i, length - i);
+				parser->body_received += length - i;
+				i = length;
+				break;
+		}
+	}
+
+	//A COMPRESSED BODY THAT ENDS BEFORE ITS STREAM DOES IS TRUNCATED
+	if(parser->state == ESP8266_TCP_GET_HTTP_PARSER_DONE && tcp_get->inflate != NULL &&
+		tcp_get->inflate->state != ESP8266_TCP_GET_INFLATE_DONE)
+	{
+		parser->state = ESP8266_TCP_GET_HTTP_PARSER_ERROR;
+	}
+	return i;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_http_process_line(ESP8266_TCP_GET* tcp_get)
+{
+	//PROCESS ONE COMPLETE LINE (WITHOUT CRLF) COLLECTED BY THE HTTP REPLY PARSER
+
+	ESP8266_TCP_GET_HTTP_PARSER* parser = &tcp_get->http_parser;
+	const char* value;
+	char* ptr = parser->line;
+	uint32_t n;
+	int8_t digit;
+
+	switch(parser->state)
+	{
+		case ESP8266_TCP_GET_HTTP_PARSER_STATUS_LINE:
+			if(parser->line_length == 0)
+			{
+				//IGNORE EMPTY LINES BEFORE THE STATUS LINE
+				return;
+			}
+			//STATUS LINE : HTTP/1.x SSS REASON
+			if(os_strncmp(ptr, "HTTP/", 5) != 0)
+			{
+				parser->state = ESP8266_TCP_GET_HTTP_PARSER_ERROR;
+				return;
+			}
+			while(*ptr != ' ' && *ptr != '\0')
+			{
+				ptr++;
+			}
+			while(*ptr == ' ')
+			{
+				ptr++;
+			}
+			parser->status_code = 0;
+			for(n = 0; n < 3; n++)
+			{
+				if(ptr[n] < '0' || ptr[n] > '9')
+				{
+					parser->state = ESP8266_TCP_GET_HTTP_PARSER_ERROR;
+					return;
+				}
+				parser->status_code = (parser->status_code * 10) + (ptr[n] - '0');
+			}
+			//HTTP/1.1 CONNECTIONS ARE PERSISTENT UNLESS THE SERVER SAYS OTHERWISE
+			parser->keep_alive = (os_strncmp(parser->line, "HTTP/1.0", 8) != 0);
+			parser->state = ESP8266_TCP_GET_HTTP_PARSER_HEADERS;
+
+			//304 => THE DATA DELIVERED EARLIER IS STILL CURRENT. LEAVE IT UNTOUCHED
+			//OTHERWISE START EXTRACTING FROM THIS REPLY, STATUS LINE INCLUDED
+			if(parser->status_code != 304)
+			{
+				_esp8266_tcp_get_extractor_reset(tcp_get);
+				if(!tcp_get->json_mode && tcp_get->stream_mode != ESP8266_TCP_GET_STREAM_SSE)
+				{
+					_esp8266_tcp_get_extractor_feed(tcp_get, parser->line, parser->line_length);
+					_esp8266_tcp_get_extractor_feed(tcp_get, "\r\n", 2);
+				}
+			}
+			break;
+
+		case ESP8266_TCP_GET_HTTP_PARSER_HEADERS:
+			if(parser->line_length != 0)
+			{
+				//HEADER LINE. ONLY THE FRAMING HEADERS ARE OF INTEREST
+				if((value = _esp8266_tcp_get_http_header_value(ptr, "content-length")) != NULL)
+				{
+					parser->content_length = 0;
+					while(*value >= '0' && *value <= '9')
+					{
+						parser->content_length = (parser->content_length * 10) + (*value - '0');
+						value++;
+					}
+					parser->content_length_present = 1;
+				}
+				else if((value = _esp8266_tcp_get_http_header_value(ptr, "transfer-encoding")) != NULL)
+				{
+					//LAST TRANSFER CODING MUST BE "chunked"
+					n = os_strlen(value);
+					while(n > 0 && value[n - 1] == ' ')
+					{
+						n--;
+					}
+					parser->chunked = (n >= 7 && _esp8266_tcp_get_match_lower(value + n - 7, "chunked"));
+				}
+				else if((value = _esp8266_tcp_get_http_header_value(ptr, "etag")) != NULL)
+				{
+					//A LINE THAT FILLED THE LINE BUFFER MAY HAVE BEEN TRUNCATED
+					_esp8266_tcp_get_http_copy_value(parser->etag, value,
+						(parser->line_length < ESP8266_TCP_GET_HTTP_LINE_BUFFER_SIZE - 1) ? ESP8266_TCP_GET_ETAG_SIZE : 0);
+				}
+				else if((value = _esp8266_tcp_get_http_header_value(ptr, "last-modified")) != NULL)
+				{
+					_esp8266_tcp_get_http_copy_value(parser->last_modified, value,
+						(parser->line_length < ESP8266_TCP_GET_HTTP_LINE_BUFFER_SIZE - 1) ? ESP8266_TCP_GET_LAST_MODIFIED_SIZE : 0);
+				}
+				else if((value = _esp8266_tcp_get_http_header_value(ptr, "content-encoding")) != NULL)
+				{
+					if(_esp8266_tcp_get_match_lower(value, "gzip") || _esp8266_tcp_get_match_lower(value, "x-gzip"))
+					{
+						parser->content_encoding = ESP8266_TCP_GET_CONTENT_ENCODING_GZIP;
+					}
+					else if(_esp8266_tcp_get_match_lower(value, "deflate"))
+					{
+						parser->content_encoding = ESP8266_TCP_GET_CONTENT_ENCODING_DEFLATE;
+					}
+					else if(!_esp8266_tcp_get_match_lower(value, "identity"))
+					{
+						parser->content_encoding = ESP8266_TCP_GET_CONTENT_ENCODING_UNSUPPORTED;
+					}
+				}
+				else if((value = _esp8266_tcp_get_http_header_value(ptr, "connection")) != NULL)
+				{
+					if(_esp8266_tcp_get_match_lower(value, "close"))
+					{
+						parser->keep_alive = 0;
+					}
+					else if(_esp8266_tcp_get_match_lower(value, "keep-alive"))
+					{
+						parser->keep_alive = 1;
+					}
+				}
+				return;
+			}
+
+			//EMPTY LINE => END OF HEADERS. WORK OUT HOW THE BODY IS FRAMED
+			if(parser->status_code >= 100 && parser->status_code < 200)
+			{
+				//INTERIM REPLY (100 CONTINUE ETC). THE REAL STATUS LINE FOLLOWS
+				parser->state = ESP8266_TCP_GET_HTTP_PARSER_STATUS_LINE;
+				parser->chunked = 0;
+				parser->content_length_present = 0;
+			}
+			else if(parser->status_code == 204 || parser->status_code == 304)
+			{
+				//NO BODY ALLOWED
+				parser->state = ESP8266_TCP_GET_HTTP_PARSER_DONE;
+			}
+			else if(parser->chunked)
+			{
+				parser->state = ESP8266_TCP_GET_HTTP_PARSER_CHUNK_SIZE;
+			}
+			else if(parser->content_length_present)
+			{
+				parser->body_remaining = parser->content_length;
+				parser->state = (parser->content_length == 0) ? ESP8266_TCP_GET_HTTP_PARSER_DONE :
+																ESP8266_TCP_GET_HTTP_PARSER_BODY_IDENTITY;
+			}
+			else
+			{
+				parser->state = ESP8266_TCP_GET_HTTP_PARSER_BODY_UNTIL_CLOSE;
+			}
+
+			//A COMPRESSED BODY GOES THROUGH THE DECODER
+			if(parser->state != ESP8266_TCP_GET_HTTP_PARSER_DONE && parser->state != ESP8266_TCP_GET_HTTP_PARSER_STATUS_LINE &&
+				parser->content_encoding != ESP8266_TCP_GET_CONTENT_ENCODING_IDENTITY && !_esp8266_tcp_get_inflate_start(tcp_get))
+			{
+				parser->state = ESP8266_TCP_GET_HTTP_PARSER_ERROR;
+			}
+			break;
+
+		case ESP8266_TCP_GET_HTTP_PARSER_CHUNK_SIZE:
+			//CHUNK SIZE IN HEX, OPTIONALLY FOLLOWED BY ;EXTENSIONS
+			n = 0;
+			digit = 0;
+			while(1)
+			{
+				if(*ptr >= '0' && *ptr <= '9')
+				{
+					n = (n << 4) | (*ptr - '0');
+				}
+				else if(*ptr >= 'a' && *ptr <= 'f')
+				{
+					n = (n << 4) | (*ptr - 'a' + 10);
+				}
+				else if(*ptr >= 'A' && *ptr <= 'F')
+				{
+					n = (n << 4) | (*ptr - 'A' + 10);
+				}
+				else
+				{
+					break;
+				}
+				digit = 1;
+				ptr++;
+			}
+			if(!digit)
+			{
+				parser->state = ESP8266_TCP_GET_HTTP_PARSER_ERROR;
+				return;
+			}
+			if(n == 0)
+			{
+				//LAST CHUNK. OPTIONAL TRAILER HEADERS FOLLOW
+				parser->state = ESP8266_TCP_GET_HTTP_PARSER_CHUNK_TRAILER;
+				return;
+			}
+			parser->body_remaining = n;
+			parser->state = ESP8266_TCP_GET_HTTP_PARSER_CHUNK_DATA;
+			break;
+
+		case ESP8266_TCP_GET_HTTP_PARSER_CHUNK_TRAILER:
+			//TRAILER HEADERS ARE IGNORED. EMPTY LINE ENDS THE REPLY
+			if(parser->line_length == 0)
+			{
+				parser->state = ESP8266_TCP_GET_HTTP_PARSER_DONE;
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+const char* ICACHE_FLASH_ATTR _esp8266_tcp_get_http_header_value(const char* line, const char* name)
+{
+	//IF THE HEADER LINE HAS THE SPECIFIED (LOWER CASE) NAME, RETURN A POINTER TO
+	//ITS VALUE WITH LEADING WHITESPACE SKIPPED. OTHERWISE RETURN NULL
+	//HEADER NAMES ARE CASE INSENSITIVE
+
+	if(!_esp8266_tcp_get_match_lower(line, name))
+	{
+		return NULL;
+	}
+	line += os_strlen(name);
+	if(*line != ':')
+	{
+		return NULL;
+	}
+	line++;
+	while(*line == ' ' || *line == '\t')
+	{
+		line++;
+	}
+	return line;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_http_copy_value(char* dest, const char* value, uint16_t size)
+{
+	//COPY A HEADER VALUE (TRAILING WHITESPACE REMOVED) TO DEST
+	//A VALUE THAT DOES NOT FIT IS NOT USABLE AS A VALIDATOR. DEST IS LEFT EMPTY
+
+	uint16_t n = os_strlen(value);
+
+	while(n > 0 && (value[n - 1] == ' ' || value[n - 1] == '\t'))
+	{
+		n--;
+	}
+	if(n >= size)
+	{
+		dest[0] = '\0';
+		return;
+	}
+	os_memcpy(dest, value, n);
+	dest[n] = '\0';
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_match_lower(const char* str, const char* lower)
+{
+	//RETURN 1 IF STR STARTS WITH THE (LOWER CASE) STRING LOWER, IGNORING CASE
+
+	char c;
+
+	while(*lower != '\0')
+	{
+		c = *str;
+		if(c >= 'A' && c <= 'Z')
+		{
+			c += ('a' - 'A');
+		}
+		if(c != *lower)
+		{
+			return 0;
+		}
+		str++;
+		lower++;
+	}
+	return 1;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_reply_done(ESP8266_TCP_GET* tcp_get, uint8_t success)
+{
+	//END THE CURRENT TCP GET REPLY CYCLE
+	//STOPS THE REPLY TIMEOUT TIMER AND CALLS THE USER DATA READY CALLBACK
+	//(WITH NULL ARGUMENT IF THE REPLY WAS NOT RECEIVED SUCCESSFULLY, OR ITS STATUS
+	//IS NOT 2XX / 304. ONLY THOSE CARRY DATA FOR THE CONTAINERS)
+	//SAFE TO CALL MORE THAN ONCE PER CYCLE. ONLY THE FIRST CALL HAS ANY EFFECT
+
+	uint16_t status_code = tcp_get->http_parser.status_code;
+	ESP8266_TCP_GET_SUBSCRIBER* subscriber;
+	ESP8266_TCP_GET_SUBSCRIBER* next;
+	uint32_t hash;
+	uint32_t now;
+	uint8_t changed = 0;
+	uint8_t notify = 1;
+	uint8_t streamed;
+	uint8_t usable;
+
+	if(!tcp_get->reply_pending)
+	{
+		return;
+	}
+	tcp_get->reply_pending = 0;
+
+	//A STREAM THAT DELIVERED EVENTS HAS DONE ITS JOB. SERVERS AND PROXIES CUT LONG
+	//STREAMS ANYWHERE, SO HOW IT ENDED DOES NOT MATTER
+	if(tcp_get->stream_events != 0)
+	{
+		success = 1;
+	}
+	streamed = (success && tcp_get->stream_mode == ESP8266_TCP_GET_STREAM_SSE && status_code >= 200 && status_code < 300);
+	usable = (success && ((status_code >= 200 && status_code < 300) || status_code == 304));
+
+	//STOP TCP GET REPLY TIMEOUT TIMER
+	_esp8266_tcp_get_timer_cancel(&tcp_get->reply_timeout_timer);
+
+	//NOTHING MORE TO HOLD BACK FOR THIS REPLY
+	tcp_get->body_busy = 0;
+	if(tcp_get->body_held)
+	{
+		tcp_get->body_held = 0;
+		if(tcp_get->connected)
+		{
+			espconn_recv_unhold(tcp_get->conn);
+		}
+	}
+
+	now = system_get_time();
+	if(success)
+	{
+		tcp_get->stats.cycles_ok++;
+		tcp_get->stats.fields_found += tcp_get->extractor.fields_found;
+		_esp8266_tcp_get_stats_record(tcp_get, ESP8266_TCP_GET_PHASE_TRANSFER, now - tcp_get->first_byte_time);
+		_esp8266_tcp_get_stats_record(tcp_get, ESP8266_TCP_GET_PHASE_PARSE, tcp_get->parse_time);
+		_esp8266_tcp_get_stats_record(tcp_get, ESP8266_TCP_GET_PHASE_TOTAL, now - tcp_get->cycle_start_time);
+	}
+
+	if(success && status_code == 304)
+	{
+		//NOT MODIFIED. THE CONTAINER STILL HOLDS THE DATA OF THE LAST CHANGED REPLY
+		if(tcp_get->user_data_container != NULL)
+		{
+			tcp_get->user_data_container->tcp_reply_status = ESP8266_TCP_GET_REPLY_UNCHANGED;
+			notify = _esp8266_tcp_get_container_publish(tcp_get->user_data_container, 0);
+		}
+	}
+	else if(streamed)
+	{
+		//EVERY EVENT WAS DELIVERED AS IT CAME. AN EVENT CUT OFF BY THE END OF THE STREAM IS DROPPED
+		notify = 0;
+		if(tcp_get->body_sink_cb != NULL)
+		{
+			(*tcp_get->body_sink_cb)(tcp_get, NULL, 0);
+		}
+	}
+	else if(usable)
+	{
+		//DATA RUNNING TO THE END OF THE REPLY IS COMPLETE NOW
+		_esp8266_tcp_get_extractor_finish(tcp_get);
+		if(tcp_get->body_sink_cb != NULL)
+		{
+			(*tcp_get->body_sink_cb)(tcp_get, NULL, 0);
+		}
+		if(tcp_get->user_data_container != NULL)
+		{
+			tcp_get->user_data_container->tcp_reply_status = ESP8266_TCP_GET_REPLY_NEW_DATA;
+			notify = _esp8266_tcp_get_container_publish(tcp_get->user_data_container, 1);
+		}
+
+		//REMEMBER THE VALIDATORS OF A COMPLETE 2XX REPLY FOR THE NEXT REQUEST
+		if(tcp_get->conditional_get && (os_strcmp(tcp_get->etag, tcp_get->http_parser.etag) != 0
+				|| os_strcmp(tcp_get->last_modified, tcp_get->http_parser.last_modified) != 0))
+		{
+			os_strcpy(tcp_get->etag, tcp_get->http_parser.etag);
+			os_strcpy(tcp_get->last_modified, tcp_get->http_parser.last_modified);
+			_esp8266_tcp_get_build_conditional(tcp_get);
+		}
+
+		//DID THE EXTRACTED DATA CHANGE SINCE THE LAST REPLY
+		hash = _esp8266_tcp_get_data_hash(tcp_get);
+		changed = (hash != tcp_get->last_data_hash);
+		tcp_get->last_data_hash = hash;
+	}
+
+	//THE NEXT STREAM RESUMES FROM THE LAST EVENT OF THIS ONE
+	if(tcp_get->last_event_id_changed)
+	{
+		tcp_get->last_event_id_changed = 0;
+		_esp8266_tcp_get_build_conditional(tcp_get);
+	}
+
+	//THE SUBSCRIBERS THIS REPLY WAS FETCHED FOR ARE UP TO DATE NOW
+	if(usable && !streamed)
+	{
+		for(subscriber = tcp_get->subscribers; subscriber != NULL; subscriber = subscriber->next)
+		{
+			if(subscriber->due)
+			{
+				subscriber->container->tcp_reply_status = (status_code == 304) ? ESP8266_TCP_GET_REPLY_UNCHANGED :
+																				ESP8266_TCP_GET_REPLY_NEW_DATA;
+				subscriber->notify = _esp8266_tcp_get_container_publish(subscriber->container, status_code != 304);
+				subscriber->last_update_time = now;
+				subscriber->has_data = 1;
+			}
+		}
+	}
+
+	//BETWEEN REPLIES THE EXTRACTOR FIELDS POINT AT THE PUBLISHED DATA
+	_esp8266_tcp_get_bind_fields(tcp_get, 0);
+
+	//KEEP OR REMOVE THE UPLOADED READINGS BEFORE THE NEXT CYCLE IS SCHEDULED FOR THEM
+	_esp8266_tcp_get_upload_done(tcp_get, success);
+
+	//SCHEDULE THE NEXT CYCLE BEFORE THE USER CALLBACK, SO THE CALLBACK CAN STOP ACQUISITION
+	//REPLIES WITHOUT DATA BACK OFF LIKE TIMEOUTS. REDIRECTS (3XX) ARE NOT FOLLOWED, SO A
+	//PERMANENT ONE WOULD OTHERWISE BE FETCHED AGAIN (AND ITS READINGS RESENT) EVERY INTERVAL
+	_esp8266_tcp_get_cycle_done(tcp_get, usable, changed);
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_REPLY_DONE, tcp_get->http_parser.status_code, tcp_get->http_parser.body_received);
+
+	//CALL USER SPECIFIED DATA READY CALLBACK
+	//NOT IF EVERY FIELD OF THE CONTAINER IS NOTIFY-ON-CHANGE AND NONE CHANGED
+	if(tcp_get->user_data_ready_cb != NULL && (!usable || notify))
+	{
+		(*tcp_get->user_data_ready_cb)(tcp_get, usable ? tcp_get->user_data_container : NULL);
+	}
+
+	//FAN THE REPLY OUT TO THE SUBSCRIBERS IT WAS FETCHED FOR
+	//A CALLBACK MAY UNSUBSCRIBE ITS OWN SUBSCRIBER
+	for(subscriber = tcp_get->subscribers; subscriber != NULL; subscriber = next)
+	{
+		next = subscriber->next;
+		if(!subscriber->due)
+		{
+			continue;
+		}
+		subscriber->due = 0;
+		if(subscriber->data_ready_cb != NULL && (!usable || subscriber->notify))
+		{
+			(*subscriber->data_ready_cb)(tcp_get, usable ? subscriber->container : NULL);
+		}
+	}
+}
+
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_reply_timeout(ESP8266_TCP_GET* tcp_get)
+{
+	//RETURN THE REPLY TIMEOUT IN ms. FOR A STREAM IT IS THE LONGEST SILENCE FROM THE SERVER
+
+	if(tcp_get->stream_mode != ESP8266_TCP_GET_STREAM_OFF)
+	{
+		return tcp_get->stream_idle_timeout_ms;
+	}
+	return ESP8266_TCP_GET_REPLY_TIMEOUT_MS;
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_compile(ESP8266_TCP_GET* tcp_get)
+{
+	//SET UP THE EXTRACTOR FOR THE MATCH STRINGS OF ALL THE USER DATA FIELDS
+	//(PATTERN i = FIELD i) AND THE PACKET TERMINATING CHARS (LAST PATTERN)
+	//
+	//WITH A FLASH RULE TABLE (ESP8266_TCP_GET_SetRuleTable) ITS PRECOMPILED AUTOMATON
+	//IS USED IN PLACE. OTHERWISE THE AUTOMATON IS BUILT IN THE ARENA
+	//
+	//RETURNS 1 ON SUCCESS, 0 IF THE ARENA IS TOO SMALL OR THE RULE TABLE DOES NOT FIT
+
+	ESP8266_TCP_GET_EXTRACTOR* ex = &tcp_get->extractor;
+	ESP8266_TCP_GET_USER_DATA_CONTAINER* container = tcp_get->user_data_container;
+	ESP8266_TCP_GET_SUBSCRIBER* subscriber = tcp_get->subscribers;
+	uint16_t field_count = 0;
+	uint8_t built = 0;
+	uint8_t p, i;
+
+	//THE TABLES OF A PREVIOUSLY COMPILED AUTOMATON ARE REPLACED, IN THE SAME PLACE
+	_esp8266_tcp_get_arena_tables_free(tcp_get);
+	_esp8266_tcp_get_arena_rewind(tcp_get);
+	os_memset(ex, 0, sizeof(ESP8266_TCP_GET_EXTRACTOR));
+
+	//ONE FIELD PER USER DATA FIELD OF THE MAIN CONTAINER AND OF EVERY SUBSCRIBER, SO
+	//ONE PASS OVER THE REPLY EXTRACTS THE UNION OF THEIR RULES
+	if(container != NULL)
+	{
+		field_count += container->tcp_reply_extracted_data_count;
+	}
+	for(; subscriber != NULL; subscriber = subscriber->next)
+	{
+		field_count += subscriber->container->tcp_reply_extracted_data_count;
+	}
+	if(field_count > ESP8266_TCP_GET_AC_NO_PATTERN - 1)
+	{
+		field_count = ESP8266_TCP_GET_AC_NO_PATTERN - 1;
+	}
+	ex->field_count = field_count;
+	ex->terminator_pattern = ex->field_count;
+
+	//TABLES STAY UNTIL THE NEXT COMPILE
+	ex->data = (ESP8266_TCP_GET_EXTRACTED_DATA**)_esp8266_tcp_get_arena_alloc_table(tcp_get, (ex->field_count + 1) * sizeof(ESP8266_TCP_GET_EXTRACTED_DATA*));
+	if(ex->data != NULL)
+	{
+		p = 0;
+		for(i = 0; container != NULL && i < container->tcp_reply_extracted_data_count && p < ex->field_count; i++)
+		{
+			ex->data[p++] = &container->tcp_reply_extracted_data[i];
+		}
+		for(subscriber = tcp_get->subscribers; subscriber != NULL; subscriber = subscriber->next)
+		{
+			subscriber->field_start = p;
+			for(i = 0; i < subscriber->container->tcp_reply_extracted_data_count && p < ex->field_count; i++)
+			{
+				ex->data[p++] = &subscriber->container->tcp_reply_extracted_data[i];
+			}
+			subscriber->field_count = p - subscriber->field_start;
+		}
+
+		if(tcp_get->rule_table != NULL)
+		{
+			built = _esp8266_tcp_get_extractor_load(tcp_get);
+		}
+#ifndef ESP8266_TCP_GET_FLASH_RULES
+		else
+		{
+			built = _esp8266_tcp_get_extractor_build(tcp_get);
+		}
+#endif
+	}
+
+	if(!built)
+	{
+		_esp8266_tcp_get_arena_tables_free(tcp_get);
+		_esp8266_tcp_get_arena_rewind(tcp_get);
+		os_memset(ex, 0, sizeof(ESP8266_TCP_GET_EXTRACTOR));
+		return 0;
+	}
+	return 1;
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_load(ESP8266_TCP_GET* tcp_get)
+{
+	//TAKE THE EXTRACTOR AUTOMATON AND RULES FROM THE FLASH RULE TABLE
+	//ONLY THE PER FIELD STATE IS TAKEN FROM THE ARENA. THE TABLE FIELDS MAP TO THE
+	//CONTAINER FIELDS IN ORDER (MAIN CONTAINER, THEN SUBSCRIBERS AS LINKED)
+	//
+	//RETURNS 1 ON SUCCESS, 0 IF THE TABLE IS FROM ANOTHER GENERATOR VERSION OR THE ARENA IS TOO SMALL
+
+	ESP8266_TCP_GET_EXTRACTOR* ex = &tcp_get->extractor;
+	ESP8266_TCP_GET_SUBSCRIBER* subscriber;
+	const ESP8266_TCP_GET_RULE_TABLE* table = tcp_get->rule_table;
+	uint8_t pattern_count = ex->field_count + 1;
+	uint32_t match, data;
+	uint8_t p;
+
+	if(ESP8266_TCP_GET_WORD(table->version) != ESP8266_TCP_GET_RULE_TABLE_VERSION)
+	{
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_RULE_TABLE_VERSION, 0, ESP8266_TCP_GET_WORD(table->version));
+		return 0;
+	}
+	if(ESP8266_TCP_GET_WORD(table->field_count) != ex->field_count)
+	{
+		//NOT ALL CONTAINERS OF THE TABLE ARE THERE YET (SUBSCRIBERS ARE ADDED ONE AT
+		//A TIME). NOTHING IS EXTRACTED UNTIL THEY MATCH IT
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_RULE_TABLE_FIELDS, ex->field_count, ESP8266_TCP_GET_WORD(table->field_count));
+		ex->field_count = 0;
+		ex->terminator_pattern = 0;
+		for(subscriber = tcp_get->subscribers; subscriber != NULL; subscriber = subscriber->next)
+		{
+			subscriber->field_start = 0;
+			subscriber->field_count = 0;
+		}
+		return 1;
+	}
+
+	ex->fields = (ESP8266_TCP_GET_EXTRACTOR_FIELD*)_esp8266_tcp_get_arena_alloc_table(tcp_get, pattern_count * sizeof(ESP8266_TCP_GET_EXTRACTOR_FIELD));
+	ex->json_paths = (uint32_t*)_esp8266_tcp_get_arena_alloc_table(tcp_get, pattern_count * sizeof(uint32_t));
+	if(ex->fields == NULL || ex->json_paths == NULL)
+	{
+		return 0;
+	}
+
+	ex->nodes = table->nodes;
+	ex->node_count = ESP8266_TCP_GET_WORD(table->node_count);
+	for(p = 0; p < pattern_count; p++)
+	{
+		match = ESP8266_TCP_GET_WORD(table->rules[p].match);
+		data = ESP8266_TCP_GET_WORD(table->rules[p].data);
+		ex->fields[p].length = (uint8_t)(match >> 16);
+		ex->fields[p].pattern_next = (uint8_t)(match >> 24);
+		ex->fields[p].offset = (uint8_t)data;
+		ex->fields[p].char_len = (uint8_t)(data >> 8);
+		ex->fields[p].terminating_char = (char)(data >> 16);
+		ex->json_paths[p] = ESP8266_TCP_GET_WORD(table->rules[p].json_path);
+	}
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_EXTRACTOR_LOADED, pattern_count, ex->node_count);
+	return 1;
+}
+
+#ifndef ESP8266_TCP_GET_FLASH_RULES
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_build(ESP8266_TCP_GET* tcp_get)
+{
+	//BUILD AN AHO-CORASICK AUTOMATON FROM THE MATCH STRINGS IN THE CONTAINERS
+	//
+	//THE TRIE IS STORED AS FIRST CHILD / NEXT SIBLING LISTS. FAILURE AND OUTPUT
+	//LINKS ARE FILLED IN BREADTH FIRST
+	//
+	//RETURNS 1 ON SUCCESS, 0 IF THE ARENA IS TOO SMALL
+
+	ESP8266_TCP_GET_EXTRACTOR* ex = &tcp_get->extractor;
+	ESP8266_TCP_GET_EXTRACTED_DATA* data;
+	ESP8266_TCP_GET_AC_NODE* nodes;
+	uint16_t* queue;
+	uint16_t head, tail;
+	uint16_t node_count = 1;
+	uint16_t u, v, f, w;
+	uint8_t pattern_count = ex->field_count + 1;
+	uint8_t p;
+	const char* str;
+
+	//WORST CASE NODE COUNT = ROOT + TOTAL PATTERN LENGTH. THE BFS QUEUE IS SCRATCH
+	for(p = 0; p < pattern_count; p++)
+	{
+		node_count += os_strlen(_esp8266_tcp_get_extractor_pattern(tcp_get, p));
+	}
+	nodes = (ESP8266_TCP_GET_AC_NODE*)_esp8266_tcp_get_arena_alloc_table(tcp_get, node_count * sizeof(ESP8266_TCP_GET_AC_NODE));
+	ex->fields = (ESP8266_TCP_GET_EXTRACTOR_FIELD*)_esp8266_tcp_get_arena_alloc_table(tcp_get, pattern_count * sizeof(ESP8266_TCP_GET_EXTRACTOR_FIELD));
+	ex->json_paths = (uint32_t*)_esp8266_tcp_get_arena_alloc_table(tcp_get, pattern_count * sizeof(uint32_t));
+	queue = (uint16_t*)_esp8266_tcp_get_arena_alloc(tcp_get, node_count * sizeof(uint16_t), 0);
+	if(nodes == NULL || ex->fields == NULL || ex->json_paths == NULL || queue == NULL)
+	{
+		return 0;
+	}
+	ex->nodes = nodes;
+	nodes[0].match = (uint32_t)ESP8266_TCP_GET_AC_NO_PATTERN << 8;
+	ex->node_count = 1;
+
+	//INSERT ALL PATTERNS INTO THE TRIE
+	for(p = 0; p < pattern_count; p++)
+	{
+		str = _esp8266_tcp_get_extractor_pattern(tcp_get, p);
+		ex->json_paths[p] = _esp8266_tcp_get_json_path_hash(str);
+		ex->fields[p].pattern_next = ESP8266_TCP_GET_AC_NO_PATTERN;
+		ex->fields[p].length = os_strlen(str);
+		if(p != ex->terminator_pattern)
+		{
+			data = ex->data[p];
+			ex->fields[p].offset = data->extracted_data_offset_from_match_string;
+			ex->fields[p].char_len = data->extracted_data_char_len;
+			ex->fields[p].terminating_char = data->extracted_data_terminating_char;
+		}
+		if(ex->fields[p].length == 0)
+		{
+			//EMPTY PATTERN NEVER MATCHES
+			continue;
+		}
+
+		u = 0;
+		while(*str != '\0')
+		{
+			v = ESP8266_TCP_GET_AC_CHILD(nodes[u]);
+			while(v != 0 && ESP8266_TCP_GET_AC_CHAR(nodes[v]) != *str)
+			{
+				v = ESP8266_TCP_GET_AC_SIBLING(nodes[v]);
+			}
+			if(v == 0)
+			{
+				//ADD A NEW NODE AS THE FIRST CHILD OF U
+				v = ex->node_count++;
+				nodes[v].match = (uint8_t)*str | ((uint32_t)ESP8266_TCP_GET_AC_NO_PATTERN << 8);
+				nodes[v].links = (uint32_t)ESP8266_TCP_GET_AC_CHILD(nodes[u]) << 16;
+				nodes[u].links = (nodes[u].links & 0xFFFF0000) | v;
+			}
+			u = v;
+			str++;
+		}
+
+		//CHAIN PATTERNS THAT END ON THE SAME NODE (IDENTICAL MATCH STRINGS)
+		ex->fields[p].pattern_next = ESP8266_TCP_GET_AC_PATTERN(nodes[u]);
+		nodes[u].match = (nodes[u].match & 0xFF) | ((uint32_t)p << 8);
+	}
+
+	//BREADTH FIRST PASS TO SET FAILURE AND OUTPUT LINKS
+	head = 0;
+	tail = 0;
+	for(v = ESP8266_TCP_GET_AC_CHILD(nodes[0]); v != 0; v = ESP8266_TCP_GET_AC_SIBLING(nodes[v]))
+	{
+		nodes[v].fail = (ESP8266_TCP_GET_AC_PATTERN(nodes[v]) != ESP8266_TCP_GET_AC_NO_PATTERN) ? ((uint32_t)v << 16) : 0;
+		queue[tail++] = v;
+	}
+	while(head < tail)
+	{
+		u = queue[head++];
+		for(v = ESP8266_TCP_GET_AC_CHILD(nodes[u]); v != 0; v = ESP8266_TCP_GET_AC_SIBLING(nodes[v]))
+		{
+			f = ESP8266_TCP_GET_AC_FAIL(nodes[u]);
+			while(1)
+			{
+				w = _esp8266_tcp_get_extractor_child(tcp_get, f, ESP8266_TCP_GET_AC_CHAR(nodes[v]));
+				if(w != 0 || f == 0)
+				{
+					break;
+				}
+				f = ESP8266_TCP_GET_AC_FAIL(nodes[f]);
+			}
+			nodes[v].fail = w | ((uint32_t)((ESP8266_TCP_GET_AC_PATTERN(nodes[v]) != ESP8266_TCP_GET_AC_NO_PATTERN) ?
+												v : ESP8266_TCP_GET_AC_OUTPUT(nodes[w])) << 16);
+			queue[tail++] = v;
+		}
+	}
+	_esp8266_tcp_get_arena_rewind(tcp_get);
+
+	ESP8266_TCP_GET_LOG_INFO(tcp_get, ESP8266_TCP_GET_LOG_EVENT_EXTRACTOR_COMPILED, pattern_count, ex->node_count);
+	return 1;
+}
+
+const char* ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_pattern(ESP8266_TCP_GET* tcp_get, uint8_t pattern)
+{
+	//RETURN THE MATCH STRING FOR THE SPECIFIED EXTRACTOR PATTERN
+	//THE PACKET TERMINATING CHARS COME FROM THE MAIN CONTAINER (OR THE FIRST SUBSCRIBER)
+
+	ESP8266_TCP_GET_USER_DATA_CONTAINER* container = tcp_get->user_data_container;
+
+	if(pattern == tcp_get->extractor.terminator_pattern)
+	{
+		if(container == NULL && tcp_get->subscribers != NULL)
+		{
+			container = tcp_get->subscribers->container;
+		}
+		return (container != NULL) ? container->tcp_reply_packet_terminating_chars : "";
+	}
+	return tcp_get->extractor.data[pattern]->extracted_data_start_match_string;
+}
+#endif
+
+char ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_pattern_char(ESP8266_TCP_GET* tcp_get, uint8_t pattern, uint8_t i)
+{
+	//RETURN CHARACTER i OF THE MATCH STRING OF THE SPECIFIED EXTRACTOR PATTERN
+	//FLASH STRINGS ARE READ A WORD AT A TIME
+
+	const ESP8266_TCP_GET_RULE_TABLE* table = tcp_get->rule_table;
+	uint32_t at;
+
+#ifndef ESP8266_TCP_GET_FLASH_RULES
+	if(table == NULL)
+	{
+		return _esp8266_tcp_get_extractor_pattern(tcp_get, pattern)[i];
+	}
+#endif
+	at = (ESP8266_TCP_GET_WORD(table->rules[pattern].match) & 0xFFFF) + i;
+	return (char)(ESP8266_TCP_GET_WORD(table->strings[at >> 2]) >> ((at & 3) * 8));
+}
+
+uint16_t ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_child(ESP8266_TCP_GET* tcp_get, uint16_t node, char c)
+{
+	//RETURN THE CHILD OF NODE ON CHARACTER C. 0 IF NONE
+
+	const ESP8266_TCP_GET_AC_NODE* nodes = tcp_get->extractor.nodes;
+	uint16_t v = ESP8266_TCP_GET_AC_CHILD(nodes[node]);
+
+	while(v != 0 && ESP8266_TCP_GET_AC_CHAR(nodes[v]) != c)
+	{
+		v = ESP8266_TCP_GET_AC_SIBLING(nodes[v]);
+	}
+	return v;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_reset(ESP8266_TCP_GET* tcp_get)
+{
+	//RESET THE EXTRACTOR FOR A NEW REPLY
+
+	ESP8266_TCP_GET_EXTRACTOR* ex = &tcp_get->extractor;
+	ESP8266_TCP_GET_SUBSCRIBER* subscriber;
+	uint8_t i;
+
+	ex->current = 0;
+	ex->fields_found = 0;
+	ex->fields_wanted = ex->field_count;
+	ex->active_captures = 0;
+	ex->terminator_found = 0;
+	_esp8266_tcp_get_json_reset(tcp_get);
+	for(i = 0; i < ex->field_count; i++)
+	{
+		ex->fields[i].state = ESP8266_TCP_GET_FIELD_STATE_IDLE;
+	}
+
+	//DOUBLE BUFFERED CONTAINERS ARE EXTRACTED INTO THEIR BACK BUFFER
+	_esp8266_tcp_get_bind_fields(tcp_get, 1);
+
+	//FIELDS OF SUBSCRIBERS THIS REPLY IS NOT FOR ARE MASKED OUT. THEIR DATA IS KEPT
+	for(subscriber = tcp_get->subscribers; subscriber != NULL; subscriber = subscriber->next)
+	{
+		if(!subscriber->due)
+		{
+			for(i = subscriber->field_start; i < subscriber->field_start + subscriber->field_count; i++)
+			{
+				ex->fields[i].state = ESP8266_TCP_GET_FIELD_STATE_DONE;
+			}
+			ex->fields_wanted -= subscriber->field_count;
+		}
+	}
+	for(i = 0; i < ex->field_count; i++)
+	{
+		if(ex->fields[i].state == ESP8266_TCP_GET_FIELD_STATE_IDLE)
+		{
+			ex->data[i]->data_found = 0;
+		}
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_feed(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length)
+{
+	//SCAN A SPAN OF REPLY DATA THROUGH THE EXTRACTOR AUTOMATON
+	//EVERY BYTE IS LOOKED AT ONCE. AUTOMATON STATE AND PARTIALLY CAPTURED
+	//VALUES ARE CARRIED OVER TO THE NEXT SPAN / TCP SEGMENT
+
+	ESP8266_TCP_GET_EXTRACTOR* ex = &tcp_get->extractor;
+	const ESP8266_TCP_GET_AC_NODE* nodes = ex->nodes;
+	uint16_t cur = ex->current;
+	uint16_t i, o, w;
+	uint8_t f, p;
+	char c;
+
+	if(nodes == NULL)
+	{
+		return;
+	}
+
+	for(i = 0; i < length; i++)
+	{
+		c = data[i];
+
+		//ADVANCE VALUES BEING CAPTURED
+		if(ex->active_captures != 0)
+		{
+			for(f = 0; f < ex->field_count; f++)
+			{
+				if(ex->fields[f].state == ESP8266_TCP_GET_FIELD_STATE_SKIP ||
+					ex->fields[f].state == ESP8266_TCP_GET_FIELD_STATE_CAPTURE)
+				{
+					_esp8266_tcp_get_extractor_capture(tcp_get, f, c);
+				}
+			}
+		}
+
+		//AUTOMATON TRANSITION
+		while(1)
+		{
+			w = _esp8266_tcp_get_extractor_child(tcp_get, cur, c);
+			if(w != 0 || cur == 0)
+			{
+				break;
+			}
+			cur = ESP8266_TCP_GET_AC_FAIL(nodes[cur]);
+		}
+		cur = w;
+
+		//REPORT ALL PATTERNS ENDING AT THIS BYTE
+		for(o = ESP8266_TCP_GET_AC_OUTPUT(nodes[cur]); o != 0; o = ESP8266_TCP_GET_AC_OUTPUT(nodes[ESP8266_TCP_GET_AC_FAIL(nodes[o])]))
+		{
+			for(p = ESP8266_TCP_GET_AC_PATTERN(nodes[o]); p != ESP8266_TCP_GET_AC_NO_PATTERN; p = ex->fields[p].pattern_next)
+			{
+				_esp8266_tcp_get_extractor_match(tcp_get, p);
+			}
+		}
+	}
+	ex->current = cur;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_match(ESP8266_TCP_GET* tcp_get, uint8_t pattern)
+{
+	//PATTERN MATCH STRING JUST ENDED. START EXTRACTING ITS DATA
+	//ONLY THE FIRST OCCURRENCE IN A REPLY IS EXTRACTED
+
+	ESP8266_TCP_GET_EXTRACTOR* ex = &tcp_get->extractor;
+	ESP8266_TCP_GET_EXTRACTOR_FIELD* field = &ex->fields[pattern];
+	uint8_t i;
+
+	if(pattern == ex->terminator_pattern)
+	{
+		ex->terminator_found = 1;
+		return;
+	}
+	if(field->state != ESP8266_TCP_GET_FIELD_STATE_IDLE)
+	{
+		return;
+	}
+
+	field->captured = 0;
+	ex->active_captures++;
+
+	//DATA OFFSET IS COUNTED FROM THE START OF THE MATCH STRING
+	if(field->offset >= field->length)
+	{
+		field->skip = field->offset - field->length;
+		field->state = (field->skip != 0) ? ESP8266_TCP_GET_FIELD_STATE_SKIP : ESP8266_TCP_GET_FIELD_STATE_CAPTURE;
+	}
+	else
+	{
+		//DATA STARTS INSIDE THE MATCH STRING
+		field->state = ESP8266_TCP_GET_FIELD_STATE_CAPTURE;
+		for(i = field->offset; i < field->length; i++)
+		{
+			if(field->state == ESP8266_TCP_GET_FIELD_STATE_CAPTURE)
+			{
+				_esp8266_tcp_get_extractor_capture(tcp_get, pattern, _esp8266_tcp_get_extractor_pattern_char(tcp_get, pattern, i));
+			}
+		}
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_capture(ESP8266_TCP_GET* tcp_get, uint8_t pattern, char c)
+{
+	//FEED ONE DATA BYTE TO A FIELD BEING EXTRACTED
+
+	ESP8266_TCP_GET_EXTRACTOR* ex = &tcp_get->extractor;
+	ESP8266_TCP_GET_EXTRACTOR_FIELD* field = &ex->fields[pattern];
+	ESP8266_TCP_GET_EXTRACTED_DATA* data = tcp_get->extractor.data[pattern];
+
+	if(field->state == ESP8266_TCP_GET_FIELD_STATE_SKIP)
+	{
+		if(--field->skip == 0)
+		{
+			field->state = ESP8266_TCP_GET_FIELD_STATE_CAPTURE;
+		}
+		return;
+	}
+
+	if(field->char_len == 0)
+	{
+		//DATA RUNS TILL THE DATA TERMINATING CHARACTER
+		if(c == field->terminating_char)
+		{
+			_esp8266_tcp_get_extractor_field_done(tcp_get, pattern);
+			return;
+		}
+		data->extracted_data[field->captured++] = c;
+	}
+	else
+	{
+		//FIXED LENGTH DATA
+		data->extracted_data[field->captured++] = c;
+		if(field->captured >= field->char_len)
+		{
+			_esp8266_tcp_get_extractor_field_done(tcp_get, pattern);
+			return;
+		}
+	}
+
+	if(field->captured >= sizeof(data->extracted_data) - 1)
+	{
+		//NO MORE SPACE IN THE DATA BUFFER. KEEP WHAT FITS
+		_esp8266_tcp_get_extractor_field_done(tcp_get, pattern);
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_field_done(ESP8266_TCP_GET* tcp_get, uint8_t pattern)
+{
+	//FIELD DATA COMPLETELY EXTRACTED
+
+	ESP8266_TCP_GET_EXTRACTOR* ex = &tcp_get->extractor;
+	ESP8266_TCP_GET_EXTRACTED_DATA* data = tcp_get->extractor.data[pattern];
+
+	data->extracted_data[ex->fields[pattern].captured] = '\0';
+	data->data_found = 1;
+	ex->fields[pattern].state = ESP8266_TCP_GET_FIELD_STATE_DONE;
+	ex->active_captures--;
+	ex->fields_found++;
+
+	ESP8266_TCP_GET_LOG_DEBUG(tcp_get, ESP8266_TCP_GET_LOG_EVENT_DATA_FOUND, pattern, ex->fields[pattern].captured);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_finish(ESP8266_TCP_GET* tcp_get)
+{
+	//END OF REPLY. DATA TERMINATED BY NULL ('\0') RUNS TO THE END OF THE REPLY
+	//SO ANY SUCH DATA STILL BEING CAPTURED IS COMPLETE NOW
+
+	ESP8266_TCP_GET_EXTRACTOR* ex = &tcp_get->extractor;
+	uint8_t f;
+
+	if(tcp_get->json_mode)
+	{
+		_esp8266_tcp_get_json_finish(tcp_get);
+		return;
+	}
+
+	for(f = 0; f < ex->field_count && ex->active_captures != 0; f++)
+	{
+		if(ex->fields[f].state == ESP8266_TCP_GET_FIELD_STATE_CAPTURE &&
+			ex->fields[f].char_len == 0 && ex->fields[f].terminating_char == '\0')
+		{
+			_esp8266_tcp_get_extractor_field_done(tcp_get, f);
+		}
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_body_feed(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length)
+{
+	//PASS A SPAN OF (DE-CHUNKED) REPLY BODY ON, THROUGH THE DECODER IF IT IS COMPRESSED
+
+	if(tcp_get->inflate != NULL)
+	{
+		_esp8266_tcp_get_inflate_feed(tcp_get, data, length);
+		return;
+	}
+	_esp8266_tcp_get_body_extract(tcp_get, data, length);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_body_extract(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length)
+{
+	//PASS A SPAN OF (DECODED) REPLY BODY TO THE BODY SINK AND THE ACTIVE EXTRACTOR
+	//ERROR PAGES NEVER REACH THE SINK
+
+	uint16_t status_code = tcp_get->http_parser.status_code;
+
+	if(tcp_get->body_sink_cb != NULL && status_code >= 200 && status_code < 300 &&
+		!(*tcp_get->body_sink_cb)(tcp_get, data, length))
+	{
+		tcp_get->body_busy = 1;
+	}
+
+	//AN EVENT STREAM IS TAKEN APART INTO EVENTS FIRST
+	if(tcp_get->stream_mode == ESP8266_TCP_GET_STREAM_SSE && status_code >= 200 && status_code < 300)
+	{
+		_esp8266_tcp_get_sse_feed(tcp_get, data, length);
+		return;
+	}
+
+	if(tcp_get->json_mode)
+	{
+		_esp8266_tcp_get_json_feed(tcp_get, data, length);
+		return;
+	}
+	_esp8266_tcp_get_extractor_feed(tcp_get, data, length);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_sse_reset(ESP8266_TCP_GET* tcp_get)
+{
+	//RESET THE SERVER-SENT EVENTS PARSER FOR A NEW STREAM
+	//THE LAST EVENT ID BUFFER STARTS AT THE ID THE STREAM RESUMES FROM
+
+	ESP8266_TCP_GET_SSE* sse = &tcp_get->sse;
+
+	os_memset(sse, 0, sizeof(ESP8266_TCP_GET_SSE));
+	sse->state = ESP8266_TCP_GET_SSE_NAME;
+	sse->field = ESP8266_TCP_GET_SSE_FIELD_IGNORED;
+	os_strcpy(sse->id, tcp_get->last_event_id);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_sse_feed(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length)
+{
+	//SPLIT A SPAN OF AN EVENT STREAM INTO ITS FIELD LINES ("name: value")
+	//data VALUES ARE PASSED ON TO THE EXTRACTOR A RUN AT A TIME. THE OTHER VALUES ARE
+	//READ HERE. A BLANK LINE ENDS AN EVENT. LINES END IN LF OR CRLF
+	//PARSER STATE IS CARRIED OVER TO THE NEXT SPAN / TCP SEGMENT
+
+	ESP8266_TCP_GET_SSE* sse = &tcp_get->sse;
+	uint16_t i = 0;
+	uint16_t start;
+	char c;
+
+	//A DATA READY CALLBACK MAY HAVE ENDED THE STREAM
+	while(i < length && tcp_get->reply_pending)
+	{
+		c = data[i];
+		switch(sse->state)
+		{
+			case ESP8266_TCP_GET_SSE_NAME:
+				if(c == ':')
+				{
+					_esp8266_tcp_get_sse_field(tcp_get);
+					sse->state = ESP8266_TCP_GET_SSE_VALUE_START;
+				}
+				else if(c == '\n')
+				{
+					_esp8266_tcp_get_sse_line_end(tcp_get);
+				}
+				else if(c != '\r' && sse->name_length < ESP8266_TCP_GET_SSE_FIELD_SIZE - 1)
+				{
+					sse->name[sse->name_length++] = c;
+				}
+				i++;
+				break;
+
+			case ESP8266_TCP_GET_SSE_VALUE_START:
+				//ONE SPACE AFTER THE ':' IS NOT PART OF THE VALUE
+				sse->state = ESP8266_TCP_GET_SSE_VALUE;
+				if(c == ' ')
+				{
+					i++;
+				}
+				break;
+
+			case ESP8266_TCP_GET_SSE_VALUE:
+			default:
+				if(c == '\n')
+				{
+					_esp8266_tcp_get_sse_line_end(tcp_get);
+					i++;
+				}
+				else if(c == '\r')
+				{
+					i++;
+				}
+				else if(sse->field == ESP8266_TCP_GET_SSE_FIELD_DATA)
+				{
+					//THE REST OF THE LINE IN THIS SPAN IN ONE GO
+					start = i;
+					while(i < length && data[i] != '\n' && data[i] != '\r')
+					{
+						i++;
+					}
+					_esp8266_tcp_get_sse_data(tcp_get, data + start, i - start);
+				}
+				else if(sse->field == ESP8266_TCP_GET_SSE_FIELD_ID)
+				{
+					if(sse->id_length < ESP8266_TCP_GET_EVENT_ID_SIZE - 1)
+					{
+						sse->id[sse->id_length++] = c;
+					}
+					else
+					{
+						sse->id_overflow = 1;
+					}
+					i++;
+				}
+				else if(sse->field == ESP8266_TCP_GET_SSE_FIELD_RETRY)
+				{
+					if(c >= '0' && c <= '9' && sse->retry < 100000000UL)
+					{
+						sse->retry = (sse->retry * 10) + (c - '0');
+					}
+					else if(c < '0' || c > '9')
+					{
+						sse->retry_valid = 0;
+					}
+					i++;
+				}
+				else
+				{
+					i++;
+				}
+				break;
+		}
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_sse_field(ESP8266_TCP_GET* tcp_get)
+{
+	//FIELD NAME OF THE LINE COMPLETE. GET READY FOR ITS VALUE
+	//A LINE STARTING WITH ':' IS A COMMENT (SERVERS SEND THEM TO KEEP THE STREAM ALIVE)
+
+	ESP8266_TCP_GET_SSE* sse = &tcp_get->sse;
+
+	sse->name[sse->name_length] = '\0';
+	if(os_strcmp(sse->name, "data") == 0)
+	{
+		//THE data LINES OF AN EVENT ARE JOINED WITH '\n'
+		sse->field = ESP8266_TCP_GET_SSE_FIELD_DATA;
+		if(sse->data_lines != 0)
+		{
+			_esp8266_tcp_get_sse_data(tcp_get, "\n", 1);
+		}
+		if(sse->data_lines < 0xFF)
+		{
+			sse->data_lines++;
+		}
+	}
+	else if(os_strcmp(sse->name, "id") == 0)
+	{
+		sse->field = ESP8266_TCP_GET_SSE_FIELD_ID;
+		sse->id_length = 0;
+		sse->id_overflow = 0;
+	}
+	else if(os_strcmp(sse->name, "retry") == 0)
+	{
+		sse->field = ESP8266_TCP_GET_SSE_FIELD_RETRY;
+		sse->retry = 0;
+		sse->retry_valid = 1;
+	}
+	else
+	{
+		sse->field = ESP8266_TCP_GET_SSE_FIELD_IGNORED;
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_sse_data(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length)
+{
+	//PASS A RUN OF EVENT DATA TO THE ACTIVE EXTRACTOR
+
+	if(tcp_get->json_mode)
+	{
+		_esp8266_tcp_get_json_feed(tcp_get, data, length);
+		return;
+	}
+	_esp8266_tcp_get_extractor_feed(tcp_get, data, length);
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_sse_line_end(ESP8266_TCP_GET* tcp_get)
+{
+	//END OF A FIELD LINE. A BLANK LINE ENDS THE EVENT
+
+	ESP8266_TCP_GET_SSE* sse = &tcp_get->sse;
+
+	if(sse->state == ESP8266_TCP_GET_SSE_NAME)
+	{
+		if(sse->name_length == 0)
+		{
+			_esp8266_tcp_get_sse_dispatch(tcp_get);
+			return;
+		}
+
+		//NAME WITHOUT ':'. THE VALUE IS EMPTY
+		_esp8266_tcp_get_sse_field(tcp_get);
+	}
+
+	if(sse->field == ESP8266_TCP_GET_SSE_FIELD_ID)
+	{
+		//AN ID TOO LONG TO KEEP CANNOT BE RESUMED FROM. THE NEXT STREAM STARTS AFRESH
+		if(sse->id_overflow)
+		{
+			sse->id_length = 0;
+		}
+		sse->id[sse->id_length] = '\0';
+	}
+	else if(sse->field == ESP8266_TCP_GET_SSE_FIELD_RETRY && sse->retry_valid && sse->retry != 0)
+	{
+		tcp_get->stream_retry_ms = sse->retry;
+	}
+
+	sse->state = ESP8266_TCP_GET_SSE_NAME;
+	sse->field = ESP8266_TCP_GET_SSE_FIELD_IGNORED;
+	sse->name_length = 0;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_sse_dispatch(ESP8266_TCP_GET* tcp_get)
+{
+	//BLANK LINE. AN EVENT IS COMPLETE
+	//PUBLISH WHAT WAS EXTRACTED FROM ITS data, CALL THE DATA READY CALLBACKS AND GET
+	//THE EXTRACTOR READY FOR THE NEXT EVENT. AN EVENT WITHOUT data IS NOT DELIVERED
+
+	ESP8266_TCP_GET_SSE* sse = &tcp_get->sse;
+	ESP8266_TCP_GET_SUBSCRIBER* subscriber;
+	ESP8266_TCP_GET_SUBSCRIBER* next;
+	uint32_t now = system_get_time();
+	uint8_t notify = 1;
+
+	//THE RESUME POINT MOVES ON WITH EVERY EVENT, WITH OR WITHOUT data
+	if(os_strcmp(tcp_get->last_event_id, sse->id) != 0)
+	{
+		os_strcpy(tcp_get->last_event_id, sse->id);
+		tcp_get->last_event_id_changed = 1;
+	}
+	if(sse->data_lines == 0)
+	{
+		return;
+	}
+	sse->data_lines = 0;
+	tcp_get->stream_events++;
+	tcp_get->stats.events++;
+
+	//DATA RUNNING TO THE END OF THE EVENT IS COMPLETE NOW
+	_esp8266_tcp_get_extractor_finish(tcp_get);
+	tcp_get->stats.fields_found += tcp_get->extractor.fields_found;
+	if(tcp_get->user_data_container != NULL)
+	{
+		tcp_get->user_data_container->tcp_reply_status = ESP8266_TCP_GET_REPLY_NEW_DATA;
+		notify = _esp8266_tcp_get_container_publish(tcp_get->user_data_container, 1);
+	}
+	for(subscriber = tcp_get->subscribers; subscriber != NULL; subscriber = subscriber->next)
+	{
+		if(subscriber->due)
+		{
+			subscriber->container->tcp_reply_status = ESP8266_TCP_GET_REPLY_NEW_DATA;
+			subscriber->notify = _esp8266_tcp_get_container_publish(subscriber->container, 1);
+			subscriber->last_update_time = now;
+			subscriber->has_data = 1;
+		}
+	}
+
+	//BETWEEN EVENTS THE EXTRACTOR FIELDS POINT AT THE PUBLISHED DATA
+	_esp8266_tcp_get_bind_fields(tcp_get, 0);
+
+	ESP8266_TCP_GET_LOG_DEBUG(tcp_get, ESP8266_TCP_GET_LOG_EVENT_STREAM_EVENT, os_strlen(tcp_get->last_event_id), tcp_get->stream_events);
+
+	//CALL USER SPECIFIED DATA READY CALLBACK
+	//NOT IF EVERY FIELD OF THE CONTAINER IS NOTIFY-ON-CHANGE AND NONE CHANGED
+	if(tcp_get->user_data_ready_cb != NULL && notify)
+	{
+		(*tcp_get->user_data_ready_cb)(tcp_get, tcp_get->user_data_container);
+	}
+
+	//A CALLBACK MAY UNSUBSCRIBE ITS OWN SUBSCRIBER
+	for(subscriber = tcp_get->subscribers; subscriber != NULL; subscriber = next)
+	{
+		next = subscriber->next;
+		if(subscriber->due && subscriber->notify)
+		{
+			subscriber->notify = 0;
+			if(subscriber->data_ready_cb != NULL)
+			{
+				(*subscriber->data_ready_cb)(tcp_get, subscriber->container);
+			}
+		}
+	}
+
+	//NEXT EVENT
+	if(tcp_get->reply_pending)
+	{
+		_esp8266_tcp_get_extractor_reset(tcp_get);
+	}
+}
+
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_json_path_hash(const char* path)
+{
+	//HASH A KEY PATH ("main.temp", "list[0].dt", "[2]") THE SAME WAY THE TOKENIZER
+	//HASHES THE PATH OF EACH VALUE IT READS
+
+	uint32_t hash = ESP8266_TCP_GET_FNV_OFFSET_BASIS;
+	uint32_t key_hash;
+	uint16_t index;
+
+	while(*path != '\0')
+	{
+		if(*path == '.')
+		{
+			path++;
+		}
+		else if(*path == '[')
+		{
+			index = 0;
+			path++;
+			while(*path >= '0' && *path <= '9')
+			{
+				index = (index * 10) + (*path - '0');
+				path++;
+			}
+			if(*path == ']')
+			{
+				path++;
+			}
+			hash = _esp8266_tcp_get_json_segment(hash, (index + 1) * 0x9E3779B9UL);
+		}
+		else
+		{
+			key_hash = ESP8266_TCP_GET_FNV_OFFSET_BASIS;
+			while(*path != '\0' && *path != '.' && *path != '[')
+			{
+				key_hash = (key_hash ^ (uint8_t)*path) * ESP8266_TCP_GET_FNV_PRIME;
+				path++;
+			}
+			hash = _esp8266_tcp_get_json_segment(hash, key_hash);
+		}
+	}
+	return hash;
+}
+
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_json_segment(uint32_t parent, uint32_t segment)
+{
+	//EXTEND A KEY PATH HASH BY ONE KEY (FNV HASH OF THE KEY) OR ARRAY INDEX SEGMENT
+
+	return (parent ^ segment) * ESP8266_TCP_GET_FNV_PRIME;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_reset(ESP8266_TCP_GET* tcp_get)
+{
+	//RESET THE JSON TOKENIZER FOR A NEW REPLY BODY
+
+	os_memset(&tcp_get->json, 0, sizeof(ESP8266_TCP_GET_JSON));
+	tcp_get->json.state = ESP8266_TCP_GET_JSON_VALUE;
+	tcp_get->json.capture = ESP8266_TCP_GET_AC_NO_PATTERN;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_feed(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length)
+{
+	//SAX STYLE JSON TOKENIZER. RUNS ONE SPAN OF BODY DATA THROUGH THE STATE MACHINE
+	//TOKENS (KEYS, STRINGS, NUMBERS) MAY BE SPLIT OVER ANY NUMBER OF SPANS
+
+	ESP8266_TCP_GET_JSON* json = &tcp_get->json;
+	uint16_t i = 0;
+	char c;
+
+	while(i < length)
+	{
+		c = data[i];
+		switch(json->state)
+		{
+			case ESP8266_TCP_GET_JSON_VALUE:
+				if(c == ' ' || c == '\t' || c == '\r' || c == '\n')
+				{
+					break;
+				}
+				if(c == ']' && json->depth != 0 && (json->array_mask & (1UL << (json->depth - 1))))
+				{
+					//EMPTY ARRAY (OR TRAILING COMMA)
+					_esp8266_tcp_get_json_close(tcp_get, c);
+					break;
+				}
+				_esp8266_tcp_get_json_value_start(tcp_get, c);
+				if(json->state == ESP8266_TCP_GET_JSON_NUMBER || json->state == ESP8266_TCP_GET_JSON_LITERAL)
+				{
+					//FIRST CHARACTER IS PART OF THE VALUE
+					continue;
+				}
+				break;
+
+			case ESP8266_TCP_GET_JSON_KEY:
+				if(c == '"')
+				{
+					json->in_key = 1;
+					json->key_hash = ESP8266_TCP_GET_FNV_OFFSET_BASIS;
+					json->state = ESP8266_TCP_GET_JSON_STRING;
+				}
+				else if(c == '}')
+				{
+					_esp8266_tcp_get_json_close(tcp_get, c);
+				}
+				else if(c != ' ' && c != '\t' && c != '\r' && c != '\n')
+				{
+					json->state = ESP8266_TCP_GET_JSON_ERROR;
+				}
+				break;
+
+			case ESP8266_TCP_GET_JSON_COLON:
+				if(c == ':')
+				{
+					json->state = ESP8266_TCP_GET_JSON_VALUE;
+				}
+				else if(c != ' ' && c != '\t' && c != '\r' && c != '\n')
+				{
+					json->state = ESP8266_TCP_GET_JSON_ERROR;
+				}
+				break;
+
+			case ESP8266_TCP_GET_JSON_AFTER_VALUE:
+				if(c == ',')
+				{
+					if(json->array_mask & (1UL << (json->depth - 1)))
+					{
+						if(json->depth <= ESP8266_TCP_GET_JSON_MAX_DEPTH)
+						{
+							json->index[json->depth - 1]++;
+						}
+						json->state = ESP8266_TCP_GET_JSON_VALUE;
+					}
+					else
+					{
+						json->state = ESP8266_TCP_GET_JSON_KEY;
+					}
+				}
+				else if(c == '}' || c == ']')
+				{
+					_esp8266_tcp_get_json_close(tcp_get, c);
+				}
+				else if(c != ' ' && c != '\t' && c != '\r' && c != '\n')
+				{
+					json->state = ESP8266_TCP_GET_JSON_ERROR;
+				}
+				break;
+
+			case ESP8266_TCP_GET_JSON_STRING:
+				if(json->unicode_skip != 0)
+				{
+					//HEX DIGITS OF A \uXXXX ESCAPE
+					json->unicode_skip--;
+					if(json->in_key)
+					{
+						json->key_hash = (json->key_hash ^ (uint8_t)c) * ESP8266_TCP_GET_FNV_PRIME;
+					}
+				}
+				else if(c == '\\')
+				{
+					json->state = ESP8266_TCP_GET_JSON_STRING_ESCAPE;
+				}
+				else if(c == '"')
+				{
+					if(json->in_key)
+					{
+						json->in_key = 0;
+						json->state = ESP8266_TCP_GET_JSON_COLON;
+					}
+					else
+					{
+						_esp8266_tcp_get_json_value_end(tcp_get);
+					}
+				}
+				else if(json->in_key)
+				{
+					json->key_hash = (json->key_hash ^ (uint8_t)c) * ESP8266_TCP_GET_FNV_PRIME;
+				}
+				else
+				{
+					_esp8266_tcp_get_json_capture(tcp_get, c);
+				}
+				break;
+
+			case ESP8266_TCP_GET_JSON_STRING_ESCAPE:
+				json->state = ESP8266_TCP_GET_JSON_STRING;
+				if(c == 'u')
+				{
+					//NON ASCII CHARACTER. CAPTURED AS '?'
+					json->unicode_skip = 4;
+					c = '?';
+				}
+				else if(c == 'n')
+				{
+					c = '\n';
+				}
+				else if(c == 't')
+				{
+					c = '\t';
+				}
+				else if(c == 'r')
+				{
+					c = '\r';
+				}
+				else if(c == 'b')
+				{
+					c = '\b';
+				}
+				else if(c == 'f')
+				{
+					c = '\f';
+				}
+				if(json->in_key)
+				{
+					json->key_hash = (json->key_hash ^ (uint8_t)c) * ESP8266_TCP_GET_FNV_PRIME;
+				}
+				else
+				{
+					_esp8266_tcp_get_json_capture(tcp_get, c);
+				}
+				break;
+
+			case ESP8266_TCP_GET_JSON_NUMBER:
+				if((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')
+				{
+					_esp8266_tcp_get_json_number(tcp_get, c);
+					_esp8266_tcp_get_json_capture(tcp_get, c);
+					break;
+				}
+				//END OF NUMBER. THIS CHARACTER BELONGS TO WHAT FOLLOWS
+				_esp8266_tcp_get_json_value_end(tcp_get);
+				continue;
+
+			case ESP8266_TCP_GET_JSON_LITERAL:
+				if(c >= 'a' && c <= 'z')
+				{
+					_esp8266_tcp_get_json_capture(tcp_get, c);
+					break;
+				}
+				//END OF true / false / null
+				_esp8266_tcp_get_json_value_end(tcp_get);
+				continue;
+
+			case ESP8266_TCP_GET_JSON_DONE:
+			case ESP8266_TCP_GET_JSON_ERROR:
+			default:
+				//NOTHING MORE TO EXTRACT FROM THIS BODY
+				return;
+		}
+		i++;
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_value_start(ESP8266_TCP_GET* tcp_get, char c)
+{
+	//A VALUE STARTS WITH CHARACTER C. WORK OUT ITS KEY PATH AND WHETHER A FIELD
+	//WANTS IT, THEN ENTER THE STATE FOR ITS TYPE
+
+	ESP8266_TCP_GET_JSON* json = &tcp_get->json;
+	ESP8266_TCP_GET_EXTRACTOR* ex = &tcp_get->extractor;
+	uint32_t hash = ESP8266_TCP_GET_FNV_OFFSET_BASIS;
+	uint8_t level = json->depth;
+	uint8_t f;
+
+	json->capture = ESP8266_TCP_GET_AC_NO_PATTERN;
+	if(level > ESP8266_TCP_GET_JSON_MAX_DEPTH)
+	{
+		//TOO DEEP TO MATCH
+		level = 0xFF;
+	}
+	else if(level != 0)
+	{
+		if(json->array_mask & (1UL << (level - 1)))
+		{
+			hash = _esp8266_tcp_get_json_segment(json->hash[level - 1], (json->index[level - 1] + 1) * 0x9E3779B9UL);
+		}
+		else
+		{
+			hash = _esp8266_tcp_get_json_segment(json->hash[level - 1], json->key_hash);
+		}
+	}
+
+	if(c == '{' || c == '[')
+	{
+		//CONTAINER. REMEMBER ITS PATH FOR THE VALUES INSIDE IT
+		if(json->depth >= ESP8266_TCP_GET_JSON_MAX_NESTING)
+		{
+			json->state = ESP8266_TCP_GET_JSON_ERROR;
+			return;
+		}
+		if(json->depth < ESP8266_TCP_GET_JSON_MAX_DEPTH)
+		{
+			json->hash[json->depth] = hash;
+			json->index[json->depth] = 0;
+		}
+		if(c == '[')
+		{
+			json->array_mask |= (1UL << json->depth);
+			json->state = ESP8266_TCP_GET_JSON_VALUE;
+		}
+		else
+		{
+			json->array_mask &= ~(1UL << json->depth);
+			json->state = ESP8266_TCP_GET_JSON_KEY;
+		}
+		json->depth++;
+		return;
+	}
+
+	//SCALAR. CAPTURE IT IF IT IS AT THE PATH OF A FIELD NOT FOUND YET
+	if(level != 0xFF && ex->json_paths != NULL)
+	{
+		for(f = 0; f < ex->field_count; f++)
+		{
+			if(ex->json_paths[f] == hash && ex->fields[f].state == ESP8266_TCP_GET_FIELD_STATE_IDLE)
+			{
+				json->capture = f;
+				ex->fields[f].state = ESP8266_TCP_GET_FIELD_STATE_CAPTURE;
+				ex->fields[f].captured = 0;
+				ex->active_captures++;
+				break;
+			}
+		}
+	}
+
+	json->number = 0;
+	json->negative = 0;
+	json->fraction = 0;
+	json->fraction_digits = 0;
+	json->dropped_digits = 0;
+	json->exponent_part = 0;
+	json->exponent_negative = 0;
+	json->exponent = 0;
+
+	if(c == '"')
+	{
+		json->in_key = 0;
+		json->state = ESP8266_TCP_GET_JSON_STRING;
+	}
+	else if(c == '-' || (c >= '0' && c <= '9'))
+	{
+		json->state = ESP8266_TCP_GET_JSON_NUMBER;
+	}
+	else if(c == 't' || c == 'f' || c == 'n')
+	{
+		json->number = (c == 't');
+		json->state = ESP8266_TCP_GET_JSON_LITERAL;
+	}
+	else
+	{
+		json->state = ESP8266_TCP_GET_JSON_ERROR;
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_value_end(ESP8266_TCP_GET* tcp_get)
+{
+	//A SCALAR VALUE ENDED. COMPLETE ITS FIELD (IF CAPTURED) AND MOVE ON
+
+	ESP8266_TCP_GET_JSON* json = &tcp_get->json;
+	ESP8266_TCP_GET_EXTRACTED_DATA* data;
+	int16_t scale;
+
+	if(json->capture != ESP8266_TCP_GET_AC_NO_PATTERN)
+	{
+		data = tcp_get->extractor.data[json->capture];
+		if(json->state == ESP8266_TCP_GET_JSON_NUMBER)
+		{
+			//NUMBER = DIGITS * 10^(EXPONENT - FRACTION DIGITS + DROPPED DIGITS)
+			//SCALE TO THE REQUESTED DECIMALS, SATURATING ON OVERFLOW
+			scale = data->extracted_value_decimals - json->fraction_digits + json->dropped_digits;
+			scale += json->exponent_negative ? -(int16_t)json->exponent : (int16_t)json->exponent;
+			while(scale > 0 && json->number != 0)
+			{
+				if(json->number > (0x7FFFFFFF / 10))
+				{
+					json->number = 0x7FFFFFFF;
+					break;
+				}
+				json->number *= 10;
+				scale--;
+			}
+			while(scale < 0 && json->number != 0)
+			{
+				json->number /= 10;
+				scale++;
+			}
+			data->extracted_value = json->negative ? -json->number : json->number;
+		}
+		else if(json->state == ESP8266_TCP_GET_JSON_LITERAL)
+		{
+			data->extracted_value = json->number;
+		}
+		else
+		{
+			data->extracted_value = 0;
+		}
+		_esp8266_tcp_get_extractor_field_done(tcp_get, json->capture);
+		json->capture = ESP8266_TCP_GET_AC_NO_PATTERN;
+	}
+
+	if(json->depth == 0)
+	{
+		//SCALAR DOCUMENT
+		json->state = ESP8266_TCP_GET_JSON_DONE;
+		tcp_get->extractor.terminator_found = 1;
+		return;
+	}
+	json->state = ESP8266_TCP_GET_JSON_AFTER_VALUE;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_close(ESP8266_TCP_GET* tcp_get, char c)
+{
+	//CLOSING BRACKET C OF THE CURRENT OBJECT / ARRAY
+
+	ESP8266_TCP_GET_JSON* json = &tcp_get->json;
+	uint8_t is_array;
+
+	if(json->depth == 0)
+	{
+		json->state = ESP8266_TCP_GET_JSON_ERROR;
+		return;
+	}
+	is_array = (json->array_mask & (1UL << (json->depth - 1))) != 0;
+	if(is_array != (c == ']'))
+	{
+		json->state = ESP8266_TCP_GET_JSON_ERROR;
+		return;
+	}
+
+	json->depth--;
+	if(json->depth == 0)
+	{
+		//END OF THE DOCUMENT. A BODY WITHOUT FRAMING CAN END HERE
+		json->state = ESP8266_TCP_GET_JSON_DONE;
+		tcp_get->extractor.terminator_found = 1;
+		return;
+	}
+	json->state = ESP8266_TCP_GET_JSON_AFTER_VALUE;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_capture(ESP8266_TCP_GET* tcp_get, char c)
+{
+	//COPY ONE CHARACTER OF THE CURRENT VALUE TO ITS FIELD (IF IT IS CAPTURED)
+	//TEXT BEYOND THE FIELD BUFFER (OR THE FIELD CHAR LEN) IS DROPPED
+
+	ESP8266_TCP_GET_EXTRACTOR_FIELD* field;
+	ESP8266_TCP_GET_EXTRACTED_DATA* data;
+	uint8_t limit;
+
+	if(tcp_get->json.capture == ESP8266_TCP_GET_AC_NO_PATTERN)
+	{
+		return;
+	}
+
+	field = &tcp_get->extractor.fields[tcp_get->json.capture];
+	data = tcp_get->extractor.data[tcp_get->json.capture];
+	limit = sizeof(data->extracted_data) - 1;
+	if(field->char_len != 0 && field->char_len < limit)
+	{
+		limit = field->char_len;
+	}
+	if(field->captured < limit)
+	{
+		data->extracted_data[field->captured++] = c;
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_number(ESP8266_TCP_GET* tcp_get, char c)
+{
+	//ACCUMULATE ONE CHARACTER OF A NUMBER BEING CAPTURED
+	//DIGITS ARE KEPT AS LONG AS THEY FIT 31 BITS. FURTHER INTEGER DIGITS ONLY
+	//SCALE THE VALUE, FURTHER FRACTION DIGITS ARE DROPPED
+
+	ESP8266_TCP_GET_JSON* json = &tcp_get->json;
+
+	if(json->capture == ESP8266_TCP_GET_AC_NO_PATTERN)
+	{
+		return;
+	}
+
+	if(c == '-')
+	{
+		if(json->exponent_part)
+		{
+			json->exponent_negative = 1;
+		}
+		else
+		{
+			json->negative = 1;
+		}
+	}
+	else if(c == '.')
+	{
+		json->fraction = 1;
+	}
+	else if(c == 'e' || c == 'E')
+	{
+		json->exponent_part = 1;
+	}
+	else if(c >= '0' && c <= '9')
+	{
+		if(json->exponent_part)
+		{
+			if(json->exponent < 1000)
+			{
+				json->exponent = (json->exponent * 10) + (c - '0');
+			}
+		}
+		else if(json->number <= ((0x7FFFFFFF - 9) / 10))
+		{
+			json->number = (json->number * 10) + (c - '0');
+			if(json->fraction)
+			{
+				json->fraction_digits++;
+			}
+		}
+		else if(!json->fraction && json->dropped_digits < 0xFF)
+		{
+			json->dropped_digits++;
+		}
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_finish(ESP8266_TCP_GET* tcp_get)
 {
-	//ESP8266 DATA ACQUISITION TIMER CALLABCK
-	if(_esp8266_tcp_get_debug)
+	//END OF BODY. A NUMBER OR LITERAL AT THE VERY END HAS NO DELIMITER AFTER IT
+
+	if(tcp_get->json.state == ESP8266_TCP_GET_JSON_NUMBER || tcp_get->json.state == ESP8266_TCP_GET_JSON_LITERAL)
 	{
-	    os_printf("ESP8266 TCP : STARTING DATA ACQUISITION CYCLE = %d\n", _esp8266_tcp_get_data_acquisition_count++);
+		_esp8266_tcp_get_json_value_end(tcp_get);
 	}
+}
 
-	//INITIATE A NEW TCP CONNECTION
-	espconn_connect(&_esp8266_tcp_get_espconn);
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_start(ESP8266_TCP_GET* tcp_get)
+{
+	//TAKE THE DECODER AND ITS WINDOW FROM THE ARENA SCRATCH SPACE FOR THE BODY OF THIS REPLY
+	//RETURNS 0 (REPLY FAILS) FOR AN UNSUPPORTED CONTENT CODING OR IF THE ARENA IS TOO SMALL
+
+	ESP8266_TCP_GET_CONTENT_ENCODING encoding = tcp_get->http_parser.content_encoding;
+	ESP8266_TCP_GET_INFLATE* inf;
+	uint8_t* window;
+
+	if(encoding == ESP8266_TCP_GET_CONTENT_ENCODING_UNSUPPORTED)
+	{
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_ENCODING_UNSUPPORTED, 0, 0);
+		return 0;
+	}
+
+	inf = (ESP8266_TCP_GET_INFLATE*)_esp8266_tcp_get_arena_alloc(tcp_get, sizeof(ESP8266_TCP_GET_INFLATE), 0);
+	window = (uint8_t*)_esp8266_tcp_get_arena_alloc(tcp_get, tcp_get->inflate_window_size, 0);
+	if(inf == NULL || window == NULL)
+	{
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_DECODER_NO_ARENA, 0, sizeof(ESP8266_TCP_GET_INFLATE) + tcp_get->inflate_window_size);
+		return 0;
+	}
+
+	inf->encoding = encoding;
+	if(encoding == ESP8266_TCP_GET_CONTENT_ENCODING_GZIP)
+	{
+		inf->state = ESP8266_TCP_GET_INFLATE_GZIP_HEADER;
+		inf->count = 10;
+		inf->trailer_length = 8;
+	}
+	else
+	{
+		inf->state = ESP8266_TCP_GET_INFLATE_ZLIB_HEADER;
+	}
+	inf->window = window;
+	inf->window_mask = tcp_get->inflate_window_size - 1;
+	tcp_get->inflate = inf;
+	return 1;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_feed(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length)
+{
+	//DECODE A SPAN OF COMPRESSED BODY. EVERYTHING DECODED FROM IT IS PASSED TO THE
+	//EXTRACTOR BEFORE RETURNING. ONLY THE WINDOW AND THE DECODER STATE ARE CARRIED
+	//OVER TO THE NEXT SPAN / TCP SEGMENT
+
+	ESP8266_TCP_GET_INFLATE* inf = tcp_get->inflate;
+
+	inf->in = (const uint8_t*)data;
+	inf->in_length = length;
+	while(_esp8266_tcp_get_inflate_step(tcp_get))
+	{
+	}
+	_esp8266_tcp_get_inflate_flush(tcp_get);
+
+	if(inf->state == ESP8266_TCP_GET_INFLATE_WINDOW_TOO_SMALL)
+	{
+		//THE SERVER'S COMPRESSOR REFERS FURTHER BACK THAN THE WINDOW REACHES. ASK FOR
+		//UNCOMPRESSED REPLIES FROM NOW ON RATHER THAN FAILING EVERY CYCLE
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_WINDOW_TOO_SMALL, 0, inf->window_mask + 1);
+		tcp_get->compression = 0;
+		_esp8266_tcp_get_build_request(tcp_get);
+	}
+	if(inf->state == ESP8266_TCP_GET_INFLATE_ERROR || inf->state == ESP8266_TCP_GET_INFLATE_WINDOW_TOO_SMALL)
+	{
+		ESP8266_TCP_GET_LOG_ERROR(tcp_get, ESP8266_TCP_GET_LOG_EVENT_INFLATE_FAILED, 0, 0);
+		tcp_get->http_parser.state = ESP8266_TCP_GET_HTTP_PARSER_ERROR;
+	}
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_step(ESP8266_TCP_GET* tcp_get)
+{
+	//RUN THE DECODER STATE MACHINE ONE STEP
+	//RETURNS 0 WHEN IT NEEDS MORE INPUT OR HAS ENDED (DONE / ERROR)
+
+	ESP8266_TCP_GET_INFLATE* inf = tcp_get->inflate;
+	uint16_t n;
+	uint8_t b;
+	int16_t symbol;
+
+	switch(inf->state)
+	{
+		case ESP8266_TCP_GET_INFLATE_GZIP_HEADER:
+			//ID1 ID2 CM FLG MTIME(4) XFL OS
+			if(!_esp8266_tcp_get_inflate_need(inf, 8))
+			{
+				return 0;
+			}
+			b = _esp8266_tcp_get_inflate_take(inf, 8);
+			if((inf->count == 10 && b != 0x1F) || (inf->count == 9 && b != 0x8B) || (inf->count == 8 && b != 8) ||
+				(inf->count == 7 && (b & 0xE0) != 0))
+			{
+				inf->state = ESP8266_TCP_GET_INFLATE_ERROR;
+				return 0;
+			}
+			if(inf->count == 7)
+			{
+				inf->gzip_flags = b;
+			}
+			if(--inf->count == 0)
+			{
+				inf->state = ESP8266_TCP_GET_INFLATE_GZIP_EXTRA_LENGTH;
+			}
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_GZIP_EXTRA_LENGTH:
+			//OPTIONAL HEADER FIELDS. ALL SKIPPED
+			if(inf->gzip_flags & 0x04)
+			{
+				if(!_esp8266_tcp_get_inflate_need(inf, 16))
+				{
+					return 0;
+				}
+				inf->count = _esp8266_tcp_get_inflate_take(inf, 16);
+			}
+			inf->state = ESP8266_TCP_GET_INFLATE_GZIP_EXTRA;
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_GZIP_EXTRA:
+			while(inf->count != 0)
+			{
+				if(!_esp8266_tcp_get_inflate_need(inf, 8))
+				{
+					return 0;
+				}
+				_esp8266_tcp_get_inflate_take(inf, 8);
+				inf->count--;
+			}
+			inf->state = ESP8266_TCP_GET_INFLATE_GZIP_NAME;
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_GZIP_NAME:
+		case ESP8266_TCP_GET_INFLATE_GZIP_COMMENT:
+			//NULL TERMINATED STRINGS
+			if(inf->gzip_flags & ((inf->state == ESP8266_TCP_GET_INFLATE_GZIP_NAME) ? 0x08 : 0x10))
+			{
+				do
+				{
+					if(!_esp8266_tcp_get_inflate_need(inf, 8))
+					{
+						return 0;
+					}
+				} while(_esp8266_tcp_get_inflate_take(inf, 8) != 0);
+			}
+			inf->state = (inf->state == ESP8266_TCP_GET_INFLATE_GZIP_NAME) ? ESP8266_TCP_GET_INFLATE_GZIP_COMMENT :
+																			ESP8266_TCP_GET_INFLATE_GZIP_HEADER_CRC;
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_GZIP_HEADER_CRC:
+			if(inf->gzip_flags & 0x02)
+			{
+				if(!_esp8266_tcp_get_inflate_need(inf, 16))
+				{
+					return 0;
+				}
+				_esp8266_tcp_get_inflate_take(inf, 16);
+			}
+			inf->state = ESP8266_TCP_GET_INFLATE_BLOCK_HEADER;
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_ZLIB_HEADER:
+			//"deflate" SHOULD BE ZLIB WRAPPED BUT SOME SERVERS SEND RAW DEFLATE. A VALID
+			//ZLIB HEADER (CM = 8, NO PRESET DICTIONARY, CHECK BITS) TELLS THEM APART
+			if(!_esp8266_tcp_get_inflate_need(inf, 16))
+			{
+				return 0;
+			}
+			b = inf->bit_buffer & 0xFF;
+			n = (b << 8) | ((inf->bit_buffer >> 8) & 0xFF);
+			if((b & 0x0F) == 8 && (b >> 4) <= 7 && (n & 0x20) == 0 && (n % 31) == 0)
+			{
+				_esp8266_tcp_get_inflate_take(inf, 16);
+				inf->trailer_length = 4;
+			}
+			inf->state = ESP8266_TCP_GET_INFLATE_BLOCK_HEADER;
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_BLOCK_HEADER:
+			//BFINAL(1) BTYPE(2)
+			if(!_esp8266_tcp_get_inflate_need(inf, 3))
+			{
+				return 0;
+			}
+			inf->final_block = _esp8266_tcp_get_inflate_take(inf, 1);
+			b = _esp8266_tcp_get_inflate_take(inf, 2);
+			if(b == 0)
+			{
+				//STORED. LENGTHS START ON THE NEXT BYTE BOUNDARY
+				_esp8266_tcp_get_inflate_take(inf, inf->bit_count & 7);
+				inf->state = ESP8266_TCP_GET_INFLATE_STORED_LENGTH;
+			}
+			else if(b == 1)
+			{
+				//FIXED HUFFMAN CODES
+				os_memset(inf->lengths, 8, 144);
+				os_memset(inf->lengths + 144, 9, 112);
+				os_memset(inf->lengths + 256, 7, 24);
+				os_memset(inf->lengths + 280, 8, 8);
+				os_memset(inf->lengths + 288, 5, 30);
+				_esp8266_tcp_get_inflate_build(inf->literal_counts, inf->literal_symbols, inf->lengths, 288);
+				_esp8266_tcp_get_inflate_build(inf->distance_counts, inf->distance_symbols, inf->lengths + 288, 30);
+				inf->state = ESP8266_TCP_GET_INFLATE_SYMBOL;
+			}
+			else if(b == 2)
+			{
+				inf->state = ESP8266_TCP_GET_INFLATE_TABLE_SIZES;
+			}
+			else
+			{
+				inf->state = ESP8266_TCP_GET_INFLATE_ERROR;
+				return 0;
+			}
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_STORED_LENGTH:
+			//LEN, NLEN (ONE'S COMPLEMENT OF LEN)
+			if(!_esp8266_tcp_get_inflate_need(inf, 32))
+			{
+				return 0;
+			}
+			inf->length = _esp8266_tcp_get_inflate_take(inf, 16);
+			if((uint16_t)~_esp8266_tcp_get_inflate_take(inf, 16) != inf->length)
+			{
+				inf->state = ESP8266_TCP_GET_INFLATE_ERROR;
+				return 0;
+			}
+			inf->state = ESP8266_TCP_GET_INFLATE_STORED;
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_STORED:
+			while(inf->length != 0)
+			{
+				if(!_esp8266_tcp_get_inflate_need(inf, 8))
+				{
+					return 0;
+				}
+				_esp8266_tcp_get_inflate_put(tcp_get, _esp8266_tcp_get_inflate_take(inf, 8));
+				inf->length--;
+			}
+			break;
+
+		case ESP8266_TCP_GET_INFLATE_TABLE_SIZES:
+			//HLIT(5) HDIST(5) HCLEN(4)
+			if(!_esp8266_tcp_get_inflate_need(inf, 14))
+			{
+				return 0;
+			}
+			inf->literal_codes = _esp8266_tcp_get_inflate_take(inf, 5) + 257;
+			inf->distance_codes = _esp8266_tcp_get_inflate_take(inf, 5) + 1;
+			inf->length_codes = _esp8266_tcp_get_inflate_take(inf, 4) + 4;
+			if(inf->literal_codes > 286 || inf->distance_codes > 30)
+			{
+				inf->state = ESP8266_TCP_GET_INFLATE_ERROR;
+				return 0;
+			}
+			os_memset(inf->lengths, 0, 19);
+			inf->index = 0;
+			inf->state = ESP8266_TCP_GET_INFLATE_CODE_LENGTH_LENGTHS;
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_CODE_LENGTH_LENGTHS:
+			//3 BIT LENGTHS OF THE CODE LENGTH CODE, IN A FIXED SYMBOL ORDER
+			while(inf->index < inf->length_codes)
+			{
+				if(!_esp8266_tcp_get_inflate_need(inf, 3))
+				{
+					return 0;
+				}
+				inf->lengths[_esp8266_tcp_get_inflate_code_length_order[inf->index++]] = _esp8266_tcp_get_inflate_take(inf, 3);
+			}
+			if(!_esp8266_tcp_get_inflate_build(inf->distance_counts, inf->distance_symbols, inf->lengths, 19))
+			{
+				inf->state = ESP8266_TCP_GET_INFLATE_ERROR;
+				return 0;
+			}
+			inf->index = 0;
+			inf->state = ESP8266_TCP_GET_INFLATE_CODE_LENGTHS;
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_CODE_LENGTHS:
+			//LITERAL / LENGTH AND DISTANCE CODE LENGTHS, CODED WITH THE CODE LENGTH CODE
+			while(inf->index < inf->literal_codes + inf->distance_codes)
+			{
+				symbol = _esp8266_tcp_get_inflate_decode(inf, inf->distance_counts, inf->distance_symbols);
+				if(symbol == -1)
+				{
+					return 0;
+				}
+				if(symbol < 0)
+				{
+					inf->state = ESP8266_TCP_GET_INFLATE_ERROR;
+					return 0;
+				}
+				if(symbol >= 16)
+				{
+					inf->symbol = symbol;
+					inf->state = ESP8266_TCP_GET_INFLATE_CODE_LENGTHS_REPEAT;
+					return 1;
+				}
+				inf->lengths[inf->index++] = symbol;
+			}
+			//END OF BLOCK MUST HAVE A CODE
+			if(inf->lengths[256] == 0 ||
+				!_esp8266_tcp_get_inflate_build(inf->literal_counts, inf->literal_symbols, inf->lengths, inf->literal_codes) ||
+				!_esp8266_tcp_get_inflate_build(inf->distance_counts, inf->distance_symbols,
+												inf->lengths + inf->literal_codes, inf->distance_codes))
+			{
+				inf->state = ESP8266_TCP_GET_INFLATE_ERROR;
+				return 0;
+			}
+			inf->state = ESP8266_TCP_GET_INFLATE_SYMBOL;
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_CODE_LENGTHS_REPEAT:
+			//16 = PREVIOUS LENGTH 3-6 TIMES, 17 = ZERO 3-10 TIMES, 18 = ZERO 11-138 TIMES
+			b = (inf->symbol == 16) ? 2 : ((inf->symbol == 17) ? 3 : 7);
+			if(!_esp8266_tcp_get_inflate_need(inf, b))
+			{
+				return 0;
+			}
+			n = _esp8266_tcp_get_inflate_take(inf, b) + ((inf->symbol == 18) ? 11 : 3);
+			if((inf->symbol == 16 && inf->index == 0) || inf->index + n > inf->literal_codes + inf->distance_codes)
+			{
+				inf->state = ESP8266_TCP_GET_INFLATE_ERROR;
+				return 0;
+			}
+			b = (inf->symbol == 16) ? inf->lengths[inf->index - 1] : 0;
+			os_memset(inf->lengths + inf->index, b, n);
+			inf->index += n;
+			inf->state = ESP8266_TCP_GET_INFLATE_CODE_LENGTHS;
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_SYMBOL:
+			symbol = _esp8266_tcp_get_inflate_decode(inf, inf->literal_counts, inf->literal_symbols);
+			if(symbol == -1)
+			{
+				return 0;
+			}
+			if(symbol < 0 || symbol > 285)
+			{
+				inf->state = ESP8266_TCP_GET_INFLATE_ERROR;
+				return 0;
+			}
+			if(symbol < 256)
+			{
+				_esp8266_tcp_get_inflate_put(tcp_get, symbol);
+				return 1;
+			}
+			if(symbol == 256)
+			{
+				break;
+			}
+			//LENGTH CODES 257-284 COVER 3-257 IN RUNS OF 4 CODES PER EXTRA BIT. 285 = 258
+			n = symbol - 257;
+			if(n < 8)
+			{
+				inf->length = n + 3;
+				inf->symbol = 0;
+			}
+			else if(n == 28)
+			{
+				inf->length = 258;
+				inf->symbol = 0;
+			}
+			else
+			{
+				inf->symbol = (n - 4) >> 2;
+				inf->length = ((4 + (n & 3)) << inf->symbol) + 3;
+			}
+			inf->state = ESP8266_TCP_GET_INFLATE_LENGTH_EXTRA;
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_LENGTH_EXTRA:
+			if(!_esp8266_tcp_get_inflate_need(inf, inf->symbol))
+			{
+				return 0;
+			}
+			inf->length += _esp8266_tcp_get_inflate_take(inf, inf->symbol);
+			inf->state = ESP8266_TCP_GET_INFLATE_DISTANCE;
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_DISTANCE:
+			symbol = _esp8266_tcp_get_inflate_decode(inf, inf->distance_counts, inf->distance_symbols);
+			if(symbol == -1)
+			{
+				return 0;
+			}
+			if(symbol < 0 || symbol > 29)
+			{
+				inf->state = ESP8266_TCP_GET_INFLATE_ERROR;
+				return 0;
+			}
+			//DISTANCE CODES 0-3 = 1-4, THEN RUNS OF 2 CODES PER EXTRA BIT
+			if(symbol < 4)
+			{
+				inf->distance = symbol + 1;
+				inf->symbol = 0;
+			}
+			else
+			{
+				inf->symbol = (symbol - 2) >> 1;
+				inf->distance = ((2 + (symbol & 1)) << inf->symbol) + 1;
+			}
+			inf->state = ESP8266_TCP_GET_INFLATE_DISTANCE_EXTRA;
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_DISTANCE_EXTRA:
+			if(!_esp8266_tcp_get_inflate_need(inf, inf->symbol))
+			{
+				return 0;
+			}
+			inf->distance += _esp8266_tcp_get_inflate_take(inf, inf->symbol);
+			if(inf->distance > inf->total_out)
+			{
+				inf->state = ESP8266_TCP_GET_INFLATE_ERROR;
+				return 0;
+			}
+			if(inf->distance > (uint32_t)inf->window_mask + 1)
+			{
+				inf->state = ESP8266_TCP_GET_INFLATE_WINDOW_TOO_SMALL;
+				return 0;
+			}
+			inf->state = ESP8266_TCP_GET_INFLATE_COPY;
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_COPY:
+			//COPY FROM THE WINDOW. THE SOURCE MAY OVERLAP THE BYTES BEING WRITTEN
+			while(inf->length != 0)
+			{
+				_esp8266_tcp_get_inflate_put(tcp_get, inf->window[(uint16_t)(inf->window_pos - inf->distance) & inf->window_mask]);
+				inf->length--;
+			}
+			inf->state = ESP8266_TCP_GET_INFLATE_SYMBOL;
+			return 1;
+
+		case ESP8266_TCP_GET_INFLATE_TRAILER:
+			//CHECK VALUES ARE NOT VERIFIED (TCP ALREADY CHECKSUMS THE DATA), EXCEPT
+			//THE GZIP ISIZE (UNCOMPRESSED LENGTH) WHICH CATCHES A MISMATCHED STREAM
+			while(inf->count != 0)
+			{
+				if(!_esp8266_tcp_get_inflate_need(inf, 8))
+				{
+					return 0;
+				}
+				b = _esp8266_tcp_get_inflate_take(inf, 8);
+				if(inf->count <= 4)
+				{
+					inf->check |= (uint32_t)b << (8 * (4 - inf->count));
+				}
+				inf->count--;
+			}
+			if(inf->encoding == ESP8266_TCP_GET_CONTENT_ENCODING_GZIP && inf->check != inf->total_out)
+			{
+				inf->state = ESP8266_TCP_GET_INFLATE_ERROR;
+				return 0;
+			}
+			inf->state = ESP8266_TCP_GET_INFLATE_DONE;
+			return 0;
+
+		default:
+			return 0;
+	}
+
+	//END OF BLOCK. THE TRAILER STARTS ON THE NEXT BYTE BOUNDARY
+	if(inf->final_block)
+	{
+		_esp8266_tcp_get_inflate_take(inf, inf->bit_count & 7);
+		inf->count = inf->trailer_length;
+		inf->state = ESP8266_TCP_GET_INFLATE_TRAILER;
+	}
+	else
+	{
+		inf->state = ESP8266_TCP_GET_INFLATE_BLOCK_HEADER;
+	}
+	return 1;
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_need(ESP8266_TCP_GET_INFLATE* inf, uint8_t bits)
+{
+	//MAKE AT LEAST bits BITS (MAX 32 ON A BYTE BOUNDARY, OTHERWISE 16) AVAILABLE
+	//RETURNS 0 IF THE INPUT RUNS OUT FIRST. THE BITS READ SO FAR ARE KEPT
+
+	while(inf->bit_count < bits)
+	{
+		if(inf->in_length == 0)
+		{
+			return 0;
+		}
+		inf->bit_buffer |= (uint32_t)(*inf->in++) << inf->bit_count;
+		inf->in_length--;
+		inf->bit_count += 8;
+	}
+	return 1;
+}
+
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_take(ESP8266_TCP_GET_INFLATE* inf, uint8_t bits)
+{
+	//REMOVE bits (MAX 16) AVAILABLE BITS FROM THE BIT BUFFER, LEAST SIGNIFICANT FIRST
+
+	uint32_t value = inf->bit_buffer & ((1UL << bits) - 1);
+
+	inf->bit_buffer >>= bits;
+	inf->bit_count -= bits;
+	return value;
+}
+
+int16_t ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_decode(ESP8266_TCP_GET_INFLATE* inf, const uint16_t* counts, const uint16_t* symbols)
+{
+	//DECODE ONE HUFFMAN CODED SYMBOL. BITS ARE READ ONE AT A TIME SO A CODE CAN BE
+	//SPLIT ACROSS TCP SEGMENTS
+	//RETURNS THE SYMBOL, -1 IF THE INPUT RAN OUT (PARTIAL CODE KEPT), -2 FOR AN INVALID CODE
+
+	uint16_t symbol;
+
+	while(_esp8266_tcp_get_inflate_need(inf, 1))
+	{
+		inf->code = (inf->code << 1) | _esp8266_tcp_get_inflate_take(inf, 1);
+		inf->code_length++;
+		inf->code_index += counts[inf->code_length];
+		inf->code -= counts[inf->code_length];
+		if(inf->code < 0)
+		{
+			symbol = symbols[inf->code_index + inf->code];
+			inf->code = 0;
+			inf->code_length = 0;
+			inf->code_index = 0;
+			return symbol;
+		}
+		if(inf->code_length == 15)
+		{
+			return -2;
+		}
+	}
+	return -1;
+}
+
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_build(uint16_t* counts, uint16_t* symbols, const uint8_t* lengths, uint16_t count)
+{
+	//BUILD A CANONICAL HUFFMAN DECODING TABLE FROM THE CODE LENGTH OF EACH SYMBOL
+	//(0 = SYMBOL NOT USED). RETURNS 0 FOR AN OVER-SUBSCRIBED CODE
+
+	uint16_t offsets[16];
+	int32_t left = 1;
+	uint16_t i;
+
+	os_memset(counts, 0, 16 * sizeof(uint16_t));
+	for(i = 0; i < count; i++)
+	{
+		counts[lengths[i]]++;
+	}
+	counts[0] = 0;
+
+	offsets[1] = 0;
+	for(i = 1; i < 16; i++)
+	{
+		left = (left << 1) - counts[i];
+		if(left < 0)
+		{
+			return 0;
+		}
+		if(i < 15)
+		{
+			offsets[i + 1] = offsets[i] + counts[i];
+		}
+	}
+
+	for(i = 0; i < count; i++)
+	{
+		if(lengths[i] != 0)
+		{
+			symbols[offsets[lengths[i]]++] = i;
+		}
+	}
+	return 1;
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_put(ESP8266_TCP_GET* tcp_get, uint8_t c)
+{
+	//APPEND ONE DECODED BYTE TO THE WINDOW. THE WINDOW IS PASSED TO THE EXTRACTOR
+	//BEFORE IT WRAPS, SO NO DECODED BYTE IS OVERWRITTEN UNSEEN
+
+	ESP8266_TCP_GET_INFLATE* inf = tcp_get->inflate;
+
+	inf->window[inf->window_pos++] = c;
+	inf->total_out++;
+	if(inf->window_pos > inf->window_mask)
+	{
+		_esp8266_tcp_get_inflate_flush(tcp_get);
+		inf->window_pos = 0;
+		inf->flush_start = 0;
+	}
+}
+
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_flush(ESP8266_TCP_GET* tcp_get)
+{
+	//PASS THE BYTES DECODED INTO THE WINDOW SINCE THE LAST FLUSH TO THE EXTRACTOR
+
+	ESP8266_TCP_GET_INFLATE* inf = tcp_get->inflate;
+
+	if(inf->window_pos > inf->flush_start)
+	{
+		_esp8266_tcp_get_body_extract(tcp_get, (char*)inf->window + inf->flush_start, inf->window_pos - inf->flush_start);
+	}
+	inf->flush_start = inf->window_pos;
 }
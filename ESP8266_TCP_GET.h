@@ -20,10 +20,116 @@
 #include "ip_addr.h"
 #include "espconn.h"
 #include "os_type.h"
+#include "user_interface.h"
 
 #define ESP8266_TCP_GET_DNS_MAX_TRIES		5
+#define ESP8266_TCP_GET_DNS_RETRY_MS		1000
+#define ESP8266_TCP_GET_DNS_CACHE_TTL_S		300
+#define ESP8266_TCP_GET_DNS_CACHE_MAX_TTL_S	3600
+#define ESP8266_TCP_GET_DNS_STALE_RETRY_MS	30000
 #define ESP8266_TCP_GET_REPLY_TIMEOUT_MS	5000
+#define ESP8266_TCP_GET_CONNECT_TIMEOUT_MS	4000
+#define ESP8266_TCP_GET_CONNECT_STAGGER_MS	300
+#define ESP8266_TCP_GET_MAX_ADDRESSES		4
+#define ESP8266_TCP_GET_ADDRESS_UNTRIED_MS	0xFFFF
+#define ESP8266_TCP_GET_BACKOFF_MAX_MS		300000
+#define ESP8266_TCP_GET_BACKOFF_MAX_SHIFT	10
+#define ESP8266_TCP_GET_JITTER_PERCENT		10
+#define ESP8266_TCP_GET_STATS_BUCKET_COUNT	14
 #define ESP8266_TCP_GET_GET_REQUEST_STRING "GET %s HTTP/1.1\r\nHost: %s\r\n\r\n"
+#define ESP8266_TCP_GET_KEEP_ALIVE_REQUEST_STRING "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: keep-alive\r\n\r\n"
+#define ESP8266_TCP_GET_UPLOAD_REQUEST_STRING "%s %s HTTP/1.1\r\nHost: %s\r\nContent-Type: %s\r\nTransfer-Encoding: chunked\r\n\r\n"
+#define ESP8266_TCP_GET_KEEP_ALIVE_UPLOAD_REQUEST_STRING "%s %s HTTP/1.1\r\nHost: %s\r\nConnection: keep-alive\r\nContent-Type: %s\r\nTransfer-Encoding: chunked\r\n\r\n"
+#define ESP8266_TCP_GET_UPLOAD_DEFAULT_CONTENT_TYPE "text/plain"
+#define ESP8266_TCP_GET_UPLOAD_CHUNK_SIZE		512
+#define ESP8266_TCP_GET_ACCEPT_ENCODING_STRING "Accept-Encoding: gzip, deflate\r\n"
+#define ESP8266_TCP_GET_KEEP_ALIVE_IDLE_TIMEOUT_MS	30000
+#define ESP8266_TCP_GET_STREAM_IDLE_TIMEOUT_MS	60000
+#define ESP8266_TCP_GET_STREAM_RETRY_MS		3000
+#define ESP8266_TCP_GET_SSE_ACCEPT_STRING "Accept: text/event-stream\r\nCache-Control: no-cache\r\n"
+#define ESP8266_TCP_GET_SSE_FIELD_SIZE		8
+#define ESP8266_TCP_GET_EVENT_ID_SIZE			48
+#define ESP8266_TCP_GET_HTTP_LINE_BUFFER_SIZE	128
+#define ESP8266_TCP_GET_ETAG_SIZE				64
+#define ESP8266_TCP_GET_LAST_MODIFIED_SIZE		32
+#define ESP8266_TCP_GET_AC_NO_PATTERN			0xFF
+#define ESP8266_TCP_GET_MAX_CONCURRENT_CONNECTIONS	4
+#define ESP8266_TCP_GET_SUBSCRIBER_MAX_STALENESS_MS	3600000
+#define ESP8266_TCP_GET_JSON_MAX_DEPTH			8
+#define ESP8266_TCP_GET_JSON_MAX_NESTING		32
+#define ESP8266_TCP_GET_FNV_OFFSET_BASIS		2166136261UL
+#define ESP8266_TCP_GET_FNV_PRIME				16777619UL
+#define ESP8266_TCP_GET_ARENA_DEFAULT_SIZE		1536
+#define ESP8266_TCP_GET_ARENA_ALIGN			4
+#define ESP8266_TCP_GET_INFLATE_DEFAULT_WINDOW	4096
+#define ESP8266_TCP_GET_INFLATE_MIN_WINDOW		256
+#define ESP8266_TCP_GET_INFLATE_MAX_WINDOW		32768
+#define ESP8266_TCP_GET_SECURE_DEFAULT_BUFFER	4096
+#define ESP8266_TCP_GET_SNAPSHOT_MAGIC			0x54475331UL
+#define ESP8266_TCP_GET_SNAPSHOT_VALUE_BYTES	252
+#define ESP8266_TCP_GET_SNAPSHOT_DNS_WAKES		16
+#define ESP8266_TCP_GET_RTC_USER_BLOCK_FIRST	64
+#define ESP8266_TCP_GET_RTC_USER_BLOCK_LAST	191
+#define ESP8266_TCP_GET_TASK_QUEUE_LENGTH		2
+#define ESP8266_TCP_GET_DEFERRED_DEFAULT_DEPTH	16
+#define ESP8266_TCP_GET_DEFERRED_DEFAULT_BYTES	4096
+#define ESP8266_TCP_GET_RULE_TABLE_VERSION		1
+#define ESP8266_TCP_GET_WHEEL_TICK_MS			10
+#define ESP8266_TCP_GET_WHEEL_LEVELS			4
+#define ESP8266_TCP_GET_WHEEL_SLOT_BITS		5
+#define ESP8266_TCP_GET_WHEEL_SLOTS			(1 << ESP8266_TCP_GET_WHEEL_SLOT_BITS)
+#define ESP8266_TCP_GET_WHEEL_SLACK_SHIFT		4
+#define ESP8266_TCP_GET_WHEEL_MAX_SLACK_MS		1000
+#define ESP8266_TCP_GET_WHEEL_MAX_SLEEP_MS		1800000
+#define ESP8266_TCP_GET_LOG_RECORDS			64
+#define ESP8266_TCP_GET_LOG_DRAIN_BATCH		8
+#define ESP8266_TCP_GET_LOG_SYNC_0			0xA5
+#define ESP8266_TCP_GET_LOG_SYNC_1			0x5A
+#define ESP8266_TCP_GET_LOG_FRAME_SIZE		15
+
+//BUILD FLAG ESP8266_TCP_GET_FLASH_RULES (-DESP8266_TCP_GET_FLASH_RULES)
+//ALL USER DATA RULES COME FROM FLASH TABLES MADE BY tools/esp8266_tcp_get_rules.py
+//(ESP8266_TCP_GET_SetRuleTable). THE MATCH STRINGS, OFFSETS, LENGTHS AND TERMINATING
+//CHARS ARE THEN LEFT OUT OF THE RAM STRUCTURES AND THE RUNTIME COMPILER IS NOT BUILT
+
+//BUILD FLAG ESP8266_TCP_GET_LOG_LEVEL (-DESP8266_TCP_GET_LOG_LEVEL=n)
+//TRACE POINTS ABOVE THE LEVEL ARE NOT COMPILED IN. AT ESP8266_TCP_GET_LOG_LEVEL_NONE
+//THE LOG RING AND ITS TASK ARE LEFT OUT AS WELL
+#define ESP8266_TCP_GET_LOG_LEVEL_NONE		0
+#define ESP8266_TCP_GET_LOG_LEVEL_ERROR		1
+#define ESP8266_TCP_GET_LOG_LEVEL_INFO		2
+#define ESP8266_TCP_GET_LOG_LEVEL_DEBUG		3
+#ifndef ESP8266_TCP_GET_LOG_LEVEL
+#define ESP8266_TCP_GET_LOG_LEVEL			ESP8266_TCP_GET_LOG_LEVEL_INFO
+#endif
+
+//A TRACE POINT ONLY WRITES A BINARY RECORD (EVENT, TIME, TWO NUMBERS) TO THE LOG RING
+#if ESP8266_TCP_GET_LOG_LEVEL >= ESP8266_TCP_GET_LOG_LEVEL_ERROR
+#define ESP8266_TCP_GET_LOG_ERROR(tcp_get, event, a, b)	_esp8266_tcp_get_log((tcp_get), (event), (uint16_t)(a), (uint32_t)(b))
+#else
+#define ESP8266_TCP_GET_LOG_ERROR(tcp_get, event, a, b)
+#endif
+#if ESP8266_TCP_GET_LOG_LEVEL >= ESP8266_TCP_GET_LOG_LEVEL_INFO
+#define ESP8266_TCP_GET_LOG_INFO(tcp_get, event, a, b)	_esp8266_tcp_get_log((tcp_get), (event), (uint16_t)(a), (uint32_t)(b))
+#else
+#define ESP8266_TCP_GET_LOG_INFO(tcp_get, event, a, b)
+#endif
+#if ESP8266_TCP_GET_LOG_LEVEL >= ESP8266_TCP_GET_LOG_LEVEL_DEBUG
+#define ESP8266_TCP_GET_LOG_DEBUG(tcp_get, event, a, b)	_esp8266_tcp_get_log((tcp_get), (event), (uint16_t)(a), (uint32_t)(b))
+#else
+#define ESP8266_TCP_GET_LOG_DEBUG(tcp_get, event, a, b)
+#endif
+
+//FLASH (IROM) CAN ONLY BE READ 32 BITS AT A TIME FROM AN ALIGNED ADDRESS. TABLES
+//THAT MAY LIVE THERE ARE MADE OF uint32_t WORDS, READ WHOLE THROUGH THIS MACRO SO
+//THE COMPILER NEVER NARROWS THE LOAD
+#define ESP8266_TCP_GET_WORD(word)			(*(const volatile uint32_t*)&(word))
+#define ESP8266_TCP_GET_AC_CHILD(node)		((uint16_t)ESP8266_TCP_GET_WORD((node).links))
+#define ESP8266_TCP_GET_AC_SIBLING(node)	((uint16_t)(ESP8266_TCP_GET_WORD((node).links) >> 16))
+#define ESP8266_TCP_GET_AC_FAIL(node)		((uint16_t)ESP8266_TCP_GET_WORD((node).fail))
+#define ESP8266_TCP_GET_AC_OUTPUT(node)		((uint16_t)(ESP8266_TCP_GET_WORD((node).fail) >> 16))
+#define ESP8266_TCP_GET_AC_CHAR(node)		((char)ESP8266_TCP_GET_WORD((node).match))
+#define ESP8266_TCP_GET_AC_PATTERN(node)	((uint8_t)(ESP8266_TCP_GET_WORD((node).match) >> 8))
 
 //CUSTOM VARIABLE STRUCTURES/////////////////////////////
 typedef enum
@@ -33,52 +139,863 @@ typedef enum
 	ESP8266_TCP_GET_STATE_OK
 } ESP8266_TCP_GET_STATE;
 
+typedef enum
+{
+	ESP8266_TCP_GET_DNS_CACHE_EMPTY,
+	ESP8266_TCP_GET_DNS_CACHE_FRESH,
+	ESP8266_TCP_GET_DNS_CACHE_STALE
+} ESP8266_TCP_GET_DNS_CACHE_STATE;
+
+typedef enum
+{
+	ESP8266_TCP_GET_HTTP_PARSER_STATUS_LINE,
+	ESP8266_TCP_GET_HTTP_PARSER_HEADERS,
+	ESP8266_TCP_GET_HTTP_PARSER_BODY_IDENTITY,
+	ESP8266_TCP_GET_HTTP_PARSER_BODY_UNTIL_CLOSE,
+	ESP8266_TCP_GET_HTTP_PARSER_CHUNK_SIZE,
+	ESP8266_TCP_GET_HTTP_PARSER_CHUNK_DATA,
+	ESP8266_TCP_GET_HTTP_PARSER_CHUNK_DATA_END,
+	ESP8266_TCP_GET_HTTP_PARSER_CHUNK_TRAILER,
+	ESP8266_TCP_GET_HTTP_PARSER_DONE,
+	ESP8266_TCP_GET_HTTP_PARSER_ERROR
+} ESP8266_TCP_GET_HTTP_PARSER_STATE;
+
+typedef enum
+{
+	ESP8266_TCP_GET_CONTENT_ENCODING_IDENTITY,
+	ESP8266_TCP_GET_CONTENT_ENCODING_GZIP,
+	ESP8266_TCP_GET_CONTENT_ENCODING_DEFLATE, //ZLIB WRAPPED (OR RAW, AS SOME SERVERS SEND IT)
+	ESP8266_TCP_GET_CONTENT_ENCODING_UNSUPPORTED
+} ESP8266_TCP_GET_CONTENT_ENCODING;
+
+//REQUEST METHOD. POST / PUT SEND A CHUNKED BODY (ESP8266_TCP_GET_SetRequestMethod)
+typedef enum
+{
+	ESP8266_TCP_GET_METHOD_GET,
+	ESP8266_TCP_GET_METHOD_POST,
+	ESP8266_TCP_GET_METHOD_PUT
+} ESP8266_TCP_GET_METHOD;
+
+typedef enum
+{
+	ESP8266_TCP_GET_UPLOAD_IDLE, //NO BODY (GET) OR NO REQUEST IN PROGRESS
+	ESP8266_TCP_GET_UPLOAD_BODY, //SENDING BODY CHUNKS
+	ESP8266_TCP_GET_UPLOAD_LAST, //LAST CHUNK QUEUED
+	ESP8266_TCP_GET_UPLOAD_DONE //WHOLE REQUEST SENT
+} ESP8266_TCP_GET_UPLOAD_STATE;
+
+//STREAMING MODE (ESP8266_TCP_GET_SetStreamMode)
+typedef enum
+{
+	ESP8266_TCP_GET_STREAM_OFF, //INTERVAL POLLING
+	ESP8266_TCP_GET_STREAM_SSE, //ONE OPEN text/event-stream REPLY. EXTRACTED AND DELIVERED PER EVENT
+	ESP8266_TCP_GET_STREAM_LONG_POLL //SERVER HOLDS THE REQUEST UNTIL THERE IS NEWS. NEXT REQUEST RIGHT AFTER THE REPLY
+} ESP8266_TCP_GET_STREAM_MODE;
+
+typedef enum
+{
+	ESP8266_TCP_GET_SSE_NAME, //READING THE FIELD NAME OF A LINE
+	ESP8266_TCP_GET_SSE_VALUE_START, //JUST AFTER THE ':'. ONE SPACE IS SKIPPED
+	ESP8266_TCP_GET_SSE_VALUE
+} ESP8266_TCP_GET_SSE_STATE;
+
+typedef enum
+{
+	ESP8266_TCP_GET_SSE_FIELD_DATA,
+	ESP8266_TCP_GET_SSE_FIELD_ID,
+	ESP8266_TCP_GET_SSE_FIELD_RETRY,
+	ESP8266_TCP_GET_SSE_FIELD_IGNORED //COMMENTS, event AND UNKNOWN FIELDS
+} ESP8266_TCP_GET_SSE_FIELD;
+
+//SERVER-SENT EVENTS PARSER
+//THE VALUES OF data LINES GO STRAIGHT TO THE EXTRACTOR AS THEY ARRIVE (SEVERAL
+//data LINES ARE JOINED WITH '\n'), SO AN EVENT IS NEVER BUFFERED AS A WHOLE
+typedef struct
+{
+	ESP8266_TCP_GET_SSE_STATE state;
+	ESP8266_TCP_GET_SSE_FIELD field;
+	char name[ESP8266_TCP_GET_SSE_FIELD_SIZE]; //FIELD NAME OF THE CURRENT LINE (TRUNCATED)
+	uint8_t name_length;
+	uint8_t data_lines; //data LINES OF THE CURRENT EVENT
+	uint8_t id_length;
+	uint8_t id_overflow; //id VALUE TOO LONG FOR id. DROPPED
+	uint8_t retry_valid; //retry VALUE IS ALL DIGITS SO FAR
+	uint32_t retry;
+	char id[ESP8266_TCP_GET_EVENT_ID_SIZE]; //LAST EVENT ID BUFFER. TAKES EFFECT WHEN AN EVENT ENDS
+}ESP8266_TCP_GET_SSE;
+
+//READINGS WAITING TO BE UPLOADED (ESP8266_TCP_GET_Initialize_UploadQueue)
+//EACH READING IS KEPT IN buffer FOLLOWED BY A '\n'. THE READINGS OF THE REQUEST IN
+//PROGRESS (THE FIRST sending BYTES) ARE REMOVED ONLY WHEN THE SERVER ACCEPTS THEM
+typedef struct
+{
+	char* buffer;
+	uint16_t size;
+	uint16_t length; //BYTES QUEUED
+	uint16_t count; //READINGS QUEUED
+	uint16_t sending; //BYTES IN THE REQUEST IN PROGRESS
+	uint16_t sending_count; //READINGS IN THE REQUEST IN PROGRESS
+	uint16_t cursor; //BYTES OF THE REQUEST ALREADY IN THE BODY
+	uint16_t batch_count;
+	uint32_t batch_ms;
+	uint32_t first_time; //system_get_time() WHEN THE OLDEST QUEUED READING ARRIVED
+	uint32_t next_first_time; //SAME FOR THE OLDEST READING NOT IN THE REQUEST
+}ESP8266_TCP_GET_UPLOAD_QUEUE;
+
+typedef struct
+{
+	ESP8266_TCP_GET_HTTP_PARSER_STATE state;
+	ESP8266_TCP_GET_CONTENT_ENCODING content_encoding;
+	uint16_t status_code;
+	uint8_t chunked;
+	uint8_t content_length_present;
+	uint8_t keep_alive; //SERVER KEEPS THE CONNECTION OPEN AFTER THIS REPLY
+	uint32_t content_length;
+	uint32_t body_remaining;
+	uint32_t body_received;
+	uint16_t line_length;
+	char line[ESP8266_TCP_GET_HTTP_LINE_BUFFER_SIZE];
+	char etag[ESP8266_TCP_GET_ETAG_SIZE]; //VALIDATORS OF THIS REPLY. EMPTY IF NOT SENT
+	char last_modified[ESP8266_TCP_GET_LAST_MODIFIED_SIZE];
+}ESP8266_TCP_GET_HTTP_PARSER;
+
+typedef enum
+{
+	ESP8266_TCP_GET_REPLY_NEW_DATA,
+	ESP8266_TCP_GET_REPLY_UNCHANGED
+} ESP8266_TCP_GET_REPLY_STATUS;
+
 typedef struct
 {
 	uint8_t data_found;
+#ifndef ESP8266_TCP_GET_FLASH_RULES
 	char extracted_data_start_match_string[50];
 	uint8_t extracted_data_offset_from_match_string;
 	uint8_t extracted_data_char_len;
 	char extracted_data_terminating_char; //SHOULD BE NULL TERMINATED
+#endif
 	char extracted_data[50];
+	uint8_t extracted_value_decimals; //JSON MODE : FIXED POINT DECIMALS OF extracted_value
+	int32_t extracted_value; //JSON MODE : NUMBER * 10^decimals (true = 1, false / null / string = 0)
+	uint8_t notify_only_on_change; //DO NOT CALL THE DATA READY CALLBACK FOR THIS FIELD IF IT DID NOT CHANGE
+	uint8_t changed; //SET BY THE LIBRARY. FOUND FLAG OR VALUE DIFFERS FROM THE PREVIOUS REPLY
+	uint32_t hash; //SET BY THE LIBRARY. FNV-1A OF THE FOUND FLAG AND THE VALUE
 }ESP8266_TCP_GET_EXTRACTED_DATA;
 
+typedef enum
+{
+	ESP8266_TCP_GET_FIELD_STATE_IDLE,
+	ESP8266_TCP_GET_FIELD_STATE_SKIP,
+	ESP8266_TCP_GET_FIELD_STATE_CAPTURE,
+	ESP8266_TCP_GET_FIELD_STATE_DONE
+} ESP8266_TCP_GET_FIELD_STATE;
+
+//EXTRACTOR AUTOMATON NODE. SAME LAYOUT IN THE ARENA AND IN FLASH RULE TABLES
+//READ WITH THE ESP8266_TCP_GET_AC_ MACROS
+typedef struct
+{
+	uint32_t links; //FIRST CHILD NODE (BITS 0-15) | NEXT SIBLING NODE (BITS 16-31)
+	uint32_t fail; //FAILURE LINK (BITS 0-15) | NEAREST NODE ON THE FAILURE CHAIN (INCLUDING THIS ONE) WHERE A PATTERN ENDS, 0 = NONE (BITS 16-31)
+	uint32_t match; //CHARACTER (BITS 0-7) | FIRST PATTERN ENDING AT THIS NODE (BITS 8-15)
+}ESP8266_TCP_GET_AC_NODE;
+
+//FLASH RULE OF ONE EXTRACTOR PATTERN
+typedef struct
+{
+	uint32_t match; //MATCH STRING OFFSET IN strings (BITS 0-15) | LENGTH (BITS 16-23) | NEXT PATTERN ENDING AT THE SAME NODE (BITS 24-31)
+	uint32_t data; //DATA OFFSET FROM THE MATCH STRING START (BITS 0-7) | DATA CHAR LEN (BITS 8-15) | DATA TERMINATING CHAR (BITS 16-23)
+	uint32_t json_path; //KEY PATH HASH OF THE MATCH STRING (JSON MODE)
+}ESP8266_TCP_GET_RULE;
+
+//PRECOMPILED EXTRACTOR RULES. GENERATED BY tools/esp8266_tcp_get_rules.py
+//AS const ICACHE_RODATA_ATTR DATA AND USED IN PLACE
+typedef struct
+{
+	const ESP8266_TCP_GET_AC_NODE* nodes;
+	const ESP8266_TCP_GET_RULE* rules; //ONE PER USER DATA FIELD (MAIN CONTAINER, THEN SUBSCRIBERS), THEN THE PACKET TERMINATOR
+	const uint32_t* strings; //MATCH STRINGS, 4 CHARS PER WORD (LITTLE ENDIAN)
+	uint32_t node_count;
+	uint32_t field_count;
+	uint32_t version; //ESP8266_TCP_GET_RULE_TABLE_VERSION OF THE GENERATOR
+}ESP8266_TCP_GET_RULE_TABLE;
+
+typedef struct
+{
+	uint8_t state;
+	uint8_t pattern_next; //NEXT PATTERN ENDING AT THE SAME NODE
+	uint8_t length; //MATCH STRING LENGTH
+	uint8_t captured; //DATA BYTES CAPTURED SO FAR
+	uint16_t skip; //BYTES STILL TO SKIP BEFORE THE DATA STARTS
+	uint8_t offset; //DATA OFFSET FROM THE START OF THE MATCH STRING
+	uint8_t char_len; //FIXED DATA LENGTH. 0 = DATA RUNS TILL terminating_char
+	char terminating_char;
+}ESP8266_TCP_GET_EXTRACTOR_FIELD;
+
+typedef struct
+{
+	const ESP8266_TCP_GET_AC_NODE* nodes; //ARENA, OR THE FLASH RULE TABLE
+	ESP8266_TCP_GET_EXTRACTOR_FIELD* fields;
+	uint16_t node_count;
+	uint16_t current; //AUTOMATON STATE CARRIED BETWEEN TCP SEGMENTS
+	uint8_t field_count;
+	uint8_t fields_found;
+	uint8_t fields_wanted; //FIELDS NOT MASKED OUT FOR THIS REPLY
+	uint8_t active_captures;
+	uint8_t terminator_pattern;
+	uint8_t terminator_found;
+	uint32_t* json_paths; //KEY PATH HASH OF EACH FIELD (JSON MODE)
+	ESP8266_TCP_GET_EXTRACTED_DATA** data; //USER DATA OF EACH FIELD. MAIN CONTAINER FIRST, THEN EACH SUBSCRIBER
+}ESP8266_TCP_GET_EXTRACTOR;
+
+typedef enum
+{
+	ESP8266_TCP_GET_JSON_VALUE, //EXPECTING A VALUE (OR ']' OF AN EMPTY ARRAY)
+	ESP8266_TCP_GET_JSON_KEY, //EXPECTING A KEY (OR '}' OF AN EMPTY OBJECT)
+	ESP8266_TCP_GET_JSON_COLON,
+	ESP8266_TCP_GET_JSON_AFTER_VALUE, //EXPECTING ',' OR A CLOSING BRACKET
+	ESP8266_TCP_GET_JSON_STRING,
+	ESP8266_TCP_GET_JSON_STRING_ESCAPE,
+	ESP8266_TCP_GET_JSON_NUMBER,
+	ESP8266_TCP_GET_JSON_LITERAL,
+	ESP8266_TCP_GET_JSON_DONE,
+	ESP8266_TCP_GET_JSON_ERROR
+} ESP8266_TCP_GET_JSON_STATE;
+
+//STREAMING JSON TOKENIZER
+//THE KEY PATH OF THE CURRENT VALUE IS KEPT AS ONE HASH PER NESTING LEVEL, SO
+//MEMORY DOES NOT GROW WITH THE DOCUMENT
+typedef struct
+{
+	ESP8266_TCP_GET_JSON_STATE state;
+	uint8_t depth;
+	uint8_t in_key;
+	uint8_t unicode_skip;
+	uint8_t capture; //FIELD THE CURRENT VALUE IS CAPTURED TO. ESP8266_TCP_GET_AC_NO_PATTERN = NONE
+	uint8_t negative;
+	uint8_t fraction;
+	uint8_t exponent_part;
+	uint8_t exponent_negative;
+	uint8_t fraction_digits;
+	uint8_t dropped_digits;
+	uint16_t exponent;
+	int32_t number;
+	uint32_t key_hash; //HASH OF THE LAST KEY IN THE CURRENT OBJECT
+	uint32_t array_mask; //BIT d SET => CONTAINER AT NESTING LEVEL d IS AN ARRAY
+	uint32_t hash[ESP8266_TCP_GET_JSON_MAX_DEPTH]; //KEY PATH HASH OF THE CONTAINER AT EACH LEVEL
+	uint16_t index[ESP8266_TCP_GET_JSON_MAX_DEPTH]; //CURRENT ELEMENT INDEX OF AN ARRAY
+}ESP8266_TCP_GET_JSON;
+
+typedef enum
+{
+	ESP8266_TCP_GET_INFLATE_GZIP_HEADER,
+	ESP8266_TCP_GET_INFLATE_GZIP_EXTRA_LENGTH,
+	ESP8266_TCP_GET_INFLATE_GZIP_EXTRA,
+	ESP8266_TCP_GET_INFLATE_GZIP_NAME,
+	ESP8266_TCP_GET_INFLATE_GZIP_COMMENT,
+	ESP8266_TCP_GET_INFLATE_GZIP_HEADER_CRC,
+	ESP8266_TCP_GET_INFLATE_ZLIB_HEADER,
+	ESP8266_TCP_GET_INFLATE_BLOCK_HEADER,
+	ESP8266_TCP_GET_INFLATE_STORED_LENGTH,
+	ESP8266_TCP_GET_INFLATE_STORED,
+	ESP8266_TCP_GET_INFLATE_TABLE_SIZES,
+	ESP8266_TCP_GET_INFLATE_CODE_LENGTH_LENGTHS,
+	ESP8266_TCP_GET_INFLATE_CODE_LENGTHS,
+	ESP8266_TCP_GET_INFLATE_CODE_LENGTHS_REPEAT,
+	ESP8266_TCP_GET_INFLATE_SYMBOL,
+	ESP8266_TCP_GET_INFLATE_LENGTH_EXTRA,
+	ESP8266_TCP_GET_INFLATE_DISTANCE,
+	ESP8266_TCP_GET_INFLATE_DISTANCE_EXTRA,
+	ESP8266_TCP_GET_INFLATE_COPY,
+	ESP8266_TCP_GET_INFLATE_TRAILER,
+	ESP8266_TCP_GET_INFLATE_DONE,
+	ESP8266_TCP_GET_INFLATE_ERROR,
+	ESP8266_TCP_GET_INFLATE_WINDOW_TOO_SMALL //BACK REFERENCE FURTHER THAN THE WINDOW
+} ESP8266_TCP_GET_INFLATE_STATE;
+
+//STREAMING DEFLATE DECODER (RFC 1950 / 1951 / 1952)
+//DECODING STOPS WHEREVER A TCP SEGMENT ENDS AND CONTINUES WITH THE NEXT ONE,
+//DOWN TO A SINGLE BIT OF A HUFFMAN CODE. THE OUTPUT IS WRITTEN TO THE WINDOW
+//(NEEDED FOR BACK REFERENCES) AND PASSED ON FROM THERE, SO THE DECOMPRESSED
+//BODY IS NEVER BUFFERED AS A WHOLE
+typedef struct
+{
+	ESP8266_TCP_GET_INFLATE_STATE state;
+	ESP8266_TCP_GET_CONTENT_ENCODING encoding;
+	uint8_t final_block;
+	uint8_t gzip_flags;
+	uint8_t trailer_length; //GZIP = 8 (CRC32, ISIZE), ZLIB = 4 (ADLER32), RAW = 0
+	uint8_t bit_count;
+	uint8_t code_length; //BITS READ OF THE HUFFMAN CODE BEING DECODED
+	int16_t code; //HUFFMAN CODE BEING DECODED (RELATIVE TO THE FIRST CODE OF ITS LENGTH)
+	uint16_t code_index; //SYMBOL INDEX OF THE FIRST CODE OF THE CURRENT LENGTH
+	uint16_t count; //BYTES LEFT IN THE CURRENT HEADER / TRAILER FIELD
+	uint16_t literal_codes;
+	uint16_t distance_codes;
+	uint16_t length_codes;
+	uint16_t index; //CODE LENGTHS READ SO FAR
+	uint16_t symbol;
+	uint16_t length; //MATCH LENGTH OR STORED BYTES LEFT
+	uint16_t distance;
+	uint32_t bit_buffer;
+	uint32_t check; //GZIP ISIZE READ FROM THE TRAILER
+	uint32_t total_out;
+	const uint8_t* in;
+	uint16_t in_length;
+	uint8_t* window;
+	uint16_t window_mask;
+	uint16_t window_pos;
+	uint16_t flush_start; //FIRST WINDOW BYTE NOT YET PASSED TO THE EXTRACTOR
+	//CANONICAL HUFFMAN DECODING TABLES
+	//counts[n] = NUMBER OF CODES OF LENGTH n, symbols = SYMBOLS IN CODE ORDER
+	uint16_t literal_counts[16]; //LITERAL / LENGTH CODE
+	uint16_t literal_symbols[288];
+	uint16_t distance_counts[16]; //DISTANCE CODE (CODE LENGTH CODE WHILE READING THE TABLES)
+	uint16_t distance_symbols[32];
+	uint8_t lengths[320]; //CODE LENGTHS OF THE TABLES BEING BUILT
+}ESP8266_TCP_GET_INFLATE;
+
+//RESOLVED HOST ADDRESS CACHE
+//THE LAST GOOD ADDRESS IS SERVED UNTIL A REFRESH SUCCEEDS, EVEN IF DNS IS DOWN
+typedef struct
+{
+	ESP8266_TCP_GET_DNS_CACHE_STATE state;
+	ip_addr_t ip;
+	ip_addr_t lookup_ip;
+	uint32_t ttl_s;
+	uint8_t lookup_pending;
+	uint8_t refreshing;
+}ESP8266_TCP_GET_DNS_CACHE;
+
+//CANDIDATE SERVER ADDRESS
+//ENTRY 0 IS THE RESOLVED (OR USER SUPPLIED) HOST ADDRESS, THE OTHERS COME FROM
+//ESP8266_TCP_GET_AddServerAddress. EACH CYCLE TRIES THEM FEWEST FAILURES IN A ROW
+//FIRST, THEN FASTEST CONNECT FIRST. ADDRESSES NEVER TRIED COME AFTER THE GOOD ONES
+typedef struct
+{
+	ip_addr_t ip;
+	uint8_t fail_streak; //CONNECT ATTEMPTS FAILED IN A ROW
+	uint16_t connect_ms; //AVERAGE CONNECT TIME. ESP8266_TCP_GET_ADDRESS_UNTRIED_MS = NEVER CONNECTED
+	uint32_t successes;
+	uint32_t failures; //ERRORS AND STALLS (NOT CONNECTED WITHIN THE STAGGER DELAY OR THE DEADLINE)
+}ESP8266_TCP_GET_ADDRESS;
+
+//CONNECT ATTEMPT ON ONE OF THE TWO ESPCONNS OF AN INSTANCE
+typedef struct
+{
+	uint8_t connecting;
+	uint8_t aborting; //GIVEN UP. THE ESPCONN IS NOT REUSED UNTIL THE CALLBACK OF THE ABORT HAS COME
+	uint8_t address; //INDEX IN addresses
+	uint32_t start_time;
+}ESP8266_TCP_GET_ATTEMPT;
+
+//WARM STATE KEPT IN RTC USER MEMORY ACROSS DEEP SLEEP
+//SIZE IS A MULTIPLE OF 4 BYTES (RTC MEMORY BLOCK SIZE)
+//values = PER FIELD : FOUND, DECIMALS, DATA LENGTH, extracted_value (4 BYTES), DATA
+typedef struct
+{
+	uint32_t magic;
+	uint32_t checksum; //FNV-1A OF THE SNAPSHOT WITH THIS FIELD 0
+	uint32_t config_hash; //HOST, PATH, PORT AND FIELDS THE SNAPSHOT WAS TAKEN FOR
+	uint32_t ip;
+	uint32_t last_data_hash;
+	uint32_t current_interval;
+	uint8_t consecutive_failures;
+	uint8_t dns_wakes; //WAKES SINCE THE ADDRESS WAS LAST CONFIRMED BY A LOOKUP
+	uint8_t value_count;
+	uint8_t value_bytes;
+	char etag[ESP8266_TCP_GET_ETAG_SIZE];
+	char last_modified[ESP8266_TCP_GET_LAST_MODIFIED_SIZE];
+	uint8_t values[ESP8266_TCP_GET_SNAPSHOT_VALUE_BYTES];
+}ESP8266_TCP_GET_SNAPSHOT;
+
+//CYCLE PHASES TIMED BY THE STATISTICS
+typedef enum
+{
+	ESP8266_TCP_GET_PHASE_DNS, //LOOKUP START TO ADDRESS
+	ESP8266_TCP_GET_PHASE_CONNECT, //espconn_connect TO CONNECTED
+	ESP8266_TCP_GET_PHASE_SEND, //REQUEST QUEUED TO SENT CALLBACK
+	ESP8266_TCP_GET_PHASE_FIRST_BYTE, //REQUEST SENT TO FIRST REPLY BYTE (SERVER TIME)
+	ESP8266_TCP_GET_PHASE_TRANSFER, //FIRST TO LAST REPLY BYTE
+	ESP8266_TCP_GET_PHASE_PARSE, //TIME SPENT IN THE PARSER / EXTRACTOR FOR ONE REPLY
+	ESP8266_TCP_GET_PHASE_TOTAL, //CYCLE START TO LAST REPLY BYTE
+	ESP8266_TCP_GET_PHASE_COUNT
+} ESP8266_TCP_GET_PHASE;
+
+//STATISTICS
+//HISTOGRAM BUCKET 0 = UNDER 1ms, BUCKET k = 2^(k-1) TO 2^k ms, LAST BUCKET = EVERYTHING LONGER
 typedef struct
 {
-	char tcp_reply_packet_terminating_chars[10]; //SHOULD BE NULL TERMINATED
+	uint32_t cycles;
+	uint32_t cycles_ok;
+	uint32_t timeouts;
+	uint32_t connect_timeouts; //NO ADDRESS CONNECTED BEFORE THE CONNECT DEADLINE
+	uint32_t events; //SERVER-SENT EVENTS DELIVERED
+	uint32_t connection_errors;
+	uint32_t failovers; //CYCLES CONNECTED TO AN ADDRESS OTHER THAN THE FIRST ONE TRIED
+	uint32_t dns_failures;
+	uint32_t bytes_received;
+	uint32_t fields_found;
+	uint32_t tls_full_handshakes; //NEW TLS CONNECTIONS
+	uint32_t tls_cycles_on_open_connection; //CYCLES SENT ON A TLS CONNECTION ALREADY OPEN (NO HANDSHAKE)
+	uint32_t segments_dropped; //DEFERRED PROCESSING QUEUE FULL
+	uint32_t upload_requests; //POST / PUT REQUESTS SENT
+	uint32_t upload_readings; //QUEUED READINGS ACCEPTED BY THE SERVER (2XX)
+	uint32_t upload_dropped; //READINGS NOT QUEUED (QUEUE FULL) OR REJECTED BY THE SERVER (4XX)
+	uint32_t last_us[ESP8266_TCP_GET_PHASE_COUNT];
+	uint16_t histogram[ESP8266_TCP_GET_PHASE_COUNT][ESP8266_TCP_GET_STATS_BUCKET_COUNT];
+}ESP8266_TCP_GET_STATS;
+
+//PER INSTANCE MEMORY ARENA
+//ONE HEAP BLOCK RESERVED AT INITIALIZATION. BUFFERS THAT LIVE AS LONG AS THE
+//INSTANCE ARE TAKEN FROM THE BOTTOM (PERSISTENT). THE EXTRACTOR TABLES, BUILT
+//AGAIN WHENEVER THE FIELDS CHANGE, ARE TAKEN DOWN FROM THE TOP. PER-CYCLE SCRATCH
+//IS TAKEN BETWEEN THE TWO AND RETURNED AT THE START OF EVERY CYCLE
+typedef struct
+{
+	uint8_t* base;
+	uint32_t size;
+	uint32_t persistent;
+	uint32_t used;
+	uint32_t tables; //START OF THE EXTRACTOR TABLES (size WHEN THERE ARE NONE)
+	uint32_t high_water;
+}ESP8266_TCP_GET_ARENA;
+
+typedef struct
+{
+#ifndef ESP8266_TCP_GET_FLASH_RULES
+	char tcp_reply_packet_terminating_chars[10]; //SHOULD BE NULL TERMINATED. ONLY USED FOR REPLIES WITHOUT CONTENT-LENGTH / CHUNKED FRAMING
+#endif
 	uint8_t tcp_reply_extracted_data_count;
 	ESP8266_TCP_GET_EXTRACTED_DATA* tcp_reply_extracted_data;
+	ESP8266_TCP_GET_REPLY_STATUS tcp_reply_status; //SET BY THE LIBRARY. UNCHANGED => EXTRACTED DATA IS FROM AN EARLIER REPLY
+	ESP8266_TCP_GET_EXTRACTED_DATA* tcp_reply_back_data; //SET BY ESP8266_TCP_GET_SetDoubleBuffer. NULL = SINGLE BUFFER
+	uint32_t tcp_reply_sequence; //SET BY THE LIBRARY. INCREMENTED EVERY TIME NEW DATA IS PUBLISHED
 }ESP8266_TCP_GET_USER_DATA_CONTAINER;
+
+//ESP8266 TCP GET INSTANCE
+//ONE PER POLLED ENDPOINT. PASSED TO EVERY LIBRARY FUNCTION
+//FIELDS ARE INTERNAL TO THE LIBRARY. USE THE GET PARAMETERS FUNCTIONS TO READ THEM
+typedef struct ESP8266_TCP_GET ESP8266_TCP_GET;
+
+//DEFERRED PROCESSING
+//ESPCONN EVENTS WAITING FOR THE WORKER TASK. RECEIVED DATA IS COPIED INTO A BYTE RING
+typedef enum
+{
+	ESP8266_TCP_GET_EVENT_DATA,
+	ESP8266_TCP_GET_EVENT_DISCONNECT,
+	ESP8266_TCP_GET_EVENT_ERROR
+} ESP8266_TCP_GET_EVENT_TYPE;
+
+typedef struct
+{
+	ESP8266_TCP_GET* tcp_get;
+	uint16_t offset; //DATA IN THE BYTE RING
+	uint16_t length;
+	uint8_t type;
+}ESP8266_TCP_GET_EVENT;
+
+typedef struct
+{
+	uint16_t depth; //EVENTS THE QUEUE HOLDS
+	uint16_t count; //EVENTS WAITING NOW
+	uint16_t high_water;
+	uint16_t bytes_size; //BYTE RING SIZE
+	uint32_t drops; //SEGMENTS DROPPED (QUEUE OR BYTE RING FULL)
+}ESP8266_TCP_GET_QUEUE_STATS;
+
+typedef struct
+{
+	ESP8266_TCP_GET_EVENT* events;
+	uint8_t* bytes;
+	uint16_t first; //OLDEST EVENT
+	uint16_t bytes_in; //NEXT FREE BYTE
+	uint16_t bytes_out; //END OF THE OLDEST DATA ALREADY HANDLED
+	uint8_t wrapped; //NEW DATA IS WRITTEN BEFORE bytes_out
+	ESP8266_TCP_GET_QUEUE_STATS stats;
+}ESP8266_TCP_GET_EVENT_QUEUE;
+
+//LIBRARY DEADLINES
+//EVERY DEADLINE OF EVERY INSTANCE IS A TIMER ON ONE HIERARCHICAL TIMER WHEEL,
+//DRIVEN BY A SINGLE os_timer ARMED FOR THE EARLIEST OF THEM
+typedef enum
+{
+	ESP8266_TCP_GET_DEADLINE_DNS, //DNS RETRY / CACHE REFRESH
+	ESP8266_TCP_GET_DEADLINE_CYCLE, //NEXT DATA ACQUISITION CYCLE
+	ESP8266_TCP_GET_DEADLINE_REPLY, //REPLY TIMEOUT (LONGEST SILENCE ON A STREAM)
+	ESP8266_TCP_GET_DEADLINE_IDLE, //KEEP-ALIVE IDLE LIMIT
+	ESP8266_TCP_GET_DEADLINE_CONNECT //CONNECT STAGGER DELAY / DEADLINE
+} ESP8266_TCP_GET_DEADLINE_TYPE;
+
+typedef struct ESP8266_TCP_GET_TIMER ESP8266_TCP_GET_TIMER;
+struct ESP8266_TCP_GET_TIMER
+{
+	ESP8266_TCP_GET_TIMER* next;
+	ESP8266_TCP_GET_TIMER** pprev; //POINTER THAT POINTS AT THIS TIMER IN ITS SLOT. NULL = NOT PENDING
+	uint32_t expires; //WHEEL TICK
+	uint8_t slot; //LEVEL * ESP8266_TCP_GET_WHEEL_SLOTS + SLOT
+	uint8_t type; //ESP8266_TCP_GET_DEADLINE_TYPE
+	void (*fn)(void*);
+	void* arg;
+};
+
+//LEVEL k SLOTS ARE ESP8266_TCP_GET_WHEEL_SLOTS^k TICKS WIDE. A TIMER SITS IN THE
+//LOWEST LEVEL ITS DELAY FITS AND MOVES DOWN (CASCADES) WHEN ITS SLOT COMES UP
+typedef struct
+{
+	ESP8266_TCP_GET_TIMER* slots[ESP8266_TCP_GET_WHEEL_LEVELS * ESP8266_TCP_GET_WHEEL_SLOTS];
+	uint32_t occupied[ESP8266_TCP_GET_WHEEL_LEVELS]; //ONE BIT PER NON EMPTY SLOT
+	uint32_t now; //LAST TICK PROCESSED
+	uint32_t clock; //TICKS ELAPSED (system_get_time)
+	uint32_t clock_us; //system_get_time() AT THE START OF TICK clock
+	uint32_t wake; //TICK THE os_timer IS ARMED FOR
+	uint16_t pending; //TIMERS ON THE WHEEL
+	uint8_t armed; //os_timer ARMED
+	uint8_t running; //EXPIRING TIMERS. THE os_timer IS ARMED AFTERWARDS
+	uint8_t started;
+	uint32_t wakes; //os_timer CALLBACKS
+}ESP8266_TCP_GET_WHEEL;
+
+//PENDING DEADLINE (ESP8266_TCP_GET_GetDeadlines)
+typedef struct
+{
+	ESP8266_TCP_GET* tcp_get;
+	ESP8266_TCP_GET_DEADLINE_TYPE type;
+	uint32_t remaining_ms;
+}ESP8266_TCP_GET_DEADLINE;
+
+//LOG EVENTS
+//THE NUMBERS ARE WHAT IS SENT. tools/esp8266_tcp_get_log.py READS THIS ENUM AND
+//PRINTS THE COMMENT OF EACH EVENT WITH {a} AND {b} REPLACED BY THE RECORD NUMBERS
+//({sa} = a SIGNED, {ip} = b AS AN IP ADDRESS). KEEP EACH ENTRY ON ONE LINE AND
+//NEVER REUSE A NUMBER
+typedef enum
+{
+	ESP8266_TCP_GET_LOG_EVENT_DROPPED = 0, //{b} LOG RECORDS LOST. LOG RING FULL
+	ESP8266_TCP_GET_LOG_EVENT_EXTRACTOR_NOT_SET_UP = 1, //DATA EXTRACTOR NOT SET UP (ARENA TOO SMALL OR RULE TABLE MISMATCH)
+	ESP8266_TCP_GET_LOG_EVENT_QUEUE_ALLOC_FAILED = 2, //COULD NOT ALLOCATE THE DEFERRED PROCESSING QUEUE
+	ESP8266_TCP_GET_LOG_EVENT_DNS_CACHED = 3, //HOSTNAME USING CACHED IP {ip}. REFRESHING IN BACKGROUND
+	ESP8266_TCP_GET_LOG_EVENT_ACQUISITION_START = 4, //DATA AQUISITION CYCLE START
+	ESP8266_TCP_GET_LOG_EVENT_ACQUISITION_TIMER = 5, //STARTING ACQUISITION TIMER WITH INTERVAL = {b}ms
+	ESP8266_TCP_GET_LOG_EVENT_ACQUISITION_STOP = 6, //DATA ACQUISITION STOPPED AT CYCLE {b}
+	ESP8266_TCP_GET_LOG_EVENT_UPLOAD_QUEUE_FULL = 7, //UPLOAD QUEUE FULL. READING DROPPED
+	ESP8266_TCP_GET_LOG_EVENT_SNAPSHOT_INVALID = 8, //NO VALID SNAPSHOT IN RTC MEMORY
+	ESP8266_TCP_GET_LOG_EVENT_SNAPSHOT_RESTORED = 9, //SNAPSHOT RESTORED. {a} VALUES, WAKE {b} SINCE DNS LOOKUP
+	ESP8266_TCP_GET_LOG_EVENT_DNS_MAX_TRIES = 10, //DNS MAX RETRY EXCEEDED. DNS UNSUCCESSFULL
+	ESP8266_TCP_GET_LOG_EVENT_DNS_RETRY = 11, //DNS RESOLVE TIMER EXPIRED. RETRY {a}
+	ESP8266_TCP_GET_LOG_EVENT_DNS_NOT_RESOLVED = 12, //HOSTNAME COULD NOT BE RESOLVED
+	ESP8266_TCP_GET_LOG_EVENT_CONNECTED = 13, //TCP CONNECTED
+	ESP8266_TCP_GET_LOG_EVENT_DISCONNECTED = 14, //TCP DISCONNECTED
+	ESP8266_TCP_GET_LOG_EVENT_SENT = 15, //TCP DATA SENT
+	ESP8266_TCP_GET_LOG_EVENT_RECEIVED = 16, //TCP DATA RECEIVED ({a} BYTES)
+	ESP8266_TCP_GET_LOG_EVENT_SEGMENT_DROPPED = 17, //DEFERRED PROCESSING QUEUE FULL. {a} BYTE SEGMENT DROPPED
+	ESP8266_TCP_GET_LOG_EVENT_ALL_FOUND = 18, //ALL USER DATA FOUND. ENDING REPLY EARLY
+	ESP8266_TCP_GET_LOG_EVENT_REPLY_TIMEOUT = 19, //TCP GET REPLY TIMEOUT !
+	ESP8266_TCP_GET_LOG_EVENT_CYCLE_SKIPPED = 20, //PREVIOUS CYCLE IN PROGRESS. SKIPPING CYCLE
+	ESP8266_TCP_GET_LOG_EVENT_UPLOAD_EMPTY = 21, //UPLOAD QUEUE EMPTY. SKIPPING CYCLE
+	ESP8266_TCP_GET_LOG_EVENT_CYCLE_START = 22, //STARTING DATA ACQUISITION CYCLE = {b} (KEEP-ALIVE = {a})
+	ESP8266_TCP_GET_LOG_EVENT_CONNECTION_ERROR = 23, //TCP CONNECTION ERROR ({sa})
+	ESP8266_TCP_GET_LOG_EVENT_IDLE_DISCONNECT = 24, //KEEP-ALIVE CONNECTION IDLE. DISCONNECTING
+	ESP8266_TCP_GET_LOG_EVENT_CONNECT_TIMEOUT = 25, //NO ADDRESS CONNECTED WITHIN {b}ms
+	ESP8266_TCP_GET_LOG_EVENT_CONNECT_STALLED = 26, //CONNECT STALLED. TRYING THE NEXT ADDRESS
+	ESP8266_TCP_GET_LOG_EVENT_DNS_RESOLVED = 27, //HOSTNAME RESOLVED. IP = {ip}
+	ESP8266_TCP_GET_LOG_EVENT_DNS_REFRESH_FAILED = 28, //HOSTNAME REFRESH FAILED. USING LAST KNOWN IP
+	ESP8266_TCP_GET_LOG_EVENT_REQUEST_BUFFER_SMALL = 29, //REQUEST BUFFER TOO SMALL. NEED {b} BYTES
+	ESP8266_TCP_GET_LOG_EVENT_CONDITIONAL_BUFFER_SMALL = 30, //REQUEST BUFFER TOO SMALL FOR CONDITIONAL GET. NEED {b} BYTES
+	ESP8266_TCP_GET_LOG_EVENT_REQUEST_BUILT = 31, //GET STRING BUILT. {b} BYTES
+	ESP8266_TCP_GET_LOG_EVENT_SLOTS_BUSY = 32, //ALL {a} CONNECTION SLOTS BUSY. WAITING
+	ESP8266_TCP_GET_LOG_EVENT_TLS_BUSY = 33, //TLS CONNECTION BUSY. WAITING
+	ESP8266_TCP_GET_LOG_EVENT_CONNECT_FAILED = 34, //espconn_connect FAILED (SECURE = {a})
+	ESP8266_TCP_GET_LOG_EVENT_ADDRESS_FAILED = 35, //CONNECT TO {ip} FAILED ({a} IN A ROW)
+	ESP8266_TCP_GET_LOG_EVENT_UPLOAD_NO_CHUNK = 36, //ARENA TOO SMALL FOR THE UPLOAD CHUNK BUFFER
+	ESP8266_TCP_GET_LOG_EVENT_READINGS_REJECTED = 37, //{a} READINGS REJECTED BY THE SERVER
+	ESP8266_TCP_GET_LOG_EVENT_UPLOAD_DUE = 38, //UPLOAD BATCH DUE. NEXT CYCLE IN {b}ms
+	ESP8266_TCP_GET_LOG_EVENT_ARENA_FAILED = 39, //COULD NOT RESERVE {b} BYTE ARENA
+	ESP8266_TCP_GET_LOG_EVENT_ARENA_RESERVED = 40, //RESERVED {b} BYTE ARENA
+	ESP8266_TCP_GET_LOG_EVENT_ARENA_FULL = 41, //ARENA FULL. {b} BYTES USED, {a} REQUESTED
+	ESP8266_TCP_GET_LOG_EVENT_CYCLE_FAILED = 42, //CYCLE FAILED ({a} IN A ROW). BACKING OFF
+	ESP8266_TCP_GET_LOG_EVENT_NEXT_CYCLE = 43, //NEXT CYCLE IN {b}ms
+	ESP8266_TCP_GET_LOG_EVENT_REPLY_DONE = 44, //TCP GET REPLY DONE. HTTP STATUS = {a}, BODY BYTES = {b}
+	ESP8266_TCP_GET_LOG_EVENT_RULE_TABLE_VERSION = 45, //RULE TABLE VERSION {b} NOT SUPPORTED
+	ESP8266_TCP_GET_LOG_EVENT_RULE_TABLE_FIELDS = 46, //RULE TABLE HAS {b} FIELDS, CONTAINERS HAVE {a}. NOT EXTRACTING
+	ESP8266_TCP_GET_LOG_EVENT_EXTRACTOR_LOADED = 47, //DATA EXTRACTOR LOADED FROM FLASH. {a} PATTERNS, {b} NODES
+	ESP8266_TCP_GET_LOG_EVENT_EXTRACTOR_COMPILED = 48, //DATA EXTRACTOR COMPILED. {a} PATTERNS, {b} NODES
+	ESP8266_TCP_GET_LOG_EVENT_DATA_FOUND = 49, //DATA FOUND. PATTERN {a}, {b} CHARS
+	ESP8266_TCP_GET_LOG_EVENT_STREAM_EVENT = 50, //EVENT {b} OF THE STREAM RECEIVED. LAST EVENT ID {a} CHARS
+	ESP8266_TCP_GET_LOG_EVENT_ENCODING_UNSUPPORTED = 51, //UNSUPPORTED CONTENT-ENCODING
+	ESP8266_TCP_GET_LOG_EVENT_DECODER_NO_ARENA = 52, //ARENA TOO SMALL FOR THE DECODER. NEED {b} BYTES OF SCRATCH
+	ESP8266_TCP_GET_LOG_EVENT_WINDOW_TOO_SMALL = 53, //REPLY NEEDS MORE THAN THE {b} BYTE WINDOW. COMPRESSION OFF
+	ESP8266_TCP_GET_LOG_EVENT_INFLATE_FAILED = 54, //COMPRESSED BODY COULD NOT BE DECODED
+	ESP8266_TCP_GET_LOG_EVENT_SECURE_KEEP_ALIVE = 55 //TLS ON. KEEP-ALIVE TURNED ON TO REUSE THE TLS CONNECTION, IDLE LIMIT {b}ms
+} ESP8266_TCP_GET_LOG_EVENT;
+
+//LOG RECORD (12 BYTES)
+//SENT AS A FRAME OF ESP8266_TCP_GET_LOG_SYNC_0, ESP8266_TCP_GET_LOG_SYNC_1, THE RECORD
+//(LITTLE ENDIAN) AND THE LOW BYTE OF THE SUM OF THE RECORD BYTES
+typedef struct
+{
+	uint32_t time; //system_get_time()
+	uint8_t event; //ESP8266_TCP_GET_LOG_EVENT
+	uint8_t instance; //ESP8266_TCP_GET_Initialize ORDER, FROM 1. 0 = NOT ABOUT AN INSTANCE
+	uint16_t a;
+	uint32_t b;
+}ESP8266_TCP_GET_LOG_RECORD;
+
+//LOG RING. TRACE POINTS ONLY WRITE TO RAM. A system_os_task SENDS THE RECORDS
+//TO THE USER WRITE FUNCTION (UART) WHEN NOTHING MORE URGENT IS RUNNING
+typedef struct
+{
+	ESP8266_TCP_GET_LOG_RECORD records[ESP8266_TCP_GET_LOG_RECORDS];
+	uint16_t first; //OLDEST RECORD
+	uint16_t count;
+	uint32_t drops; //RECORDS LOST TO A FULL RING, NOT REPORTED YET
+	uint8_t instances; //INSTANCES INITIALIZED
+	void (*write_fn)(uint8_t*, uint16_t);
+	uint8_t task_on;
+	uint8_t task_priority;
+	uint8_t task_posted;
+}ESP8266_TCP_GET_LOG;
+
+//SUBSCRIBER TO THE DATA OF AN INSTANCE
+//MEMORY OWNED BY THE USER (STATIC OR GLOBAL). FIELDS ARE INTERNAL TO THE LIBRARY
+typedef struct ESP8266_TCP_GET_SUBSCRIBER ESP8266_TCP_GET_SUBSCRIBER;
+struct ESP8266_TCP_GET_SUBSCRIBER
+{
+	ESP8266_TCP_GET_USER_DATA_CONTAINER* container;
+	void (*data_ready_cb)(ESP8266_TCP_GET*, ESP8266_TCP_GET_USER_DATA_CONTAINER*);
+	uint32_t max_staleness_ms;
+	uint32_t last_update_time; //system_get_time() OF THE LAST REPLY DELIVERED
+	uint8_t has_data;
+	uint8_t due; //THE CURRENT CYCLE FETCHES FOR THIS SUBSCRIBER
+	uint8_t notify; //THE CURRENT REPLY CHANGED A FIELD THE SUBSCRIBER WANTS TO HEAR ABOUT
+	uint8_t field_start; //FIRST EXTRACTOR FIELD OF THIS SUBSCRIBER
+	uint8_t field_count;
+	ESP8266_TCP_GET_SUBSCRIBER* next;
+};
+
+struct ESP8266_TCP_GET
+{
+	//TCP RELATED
+	//A SECOND ESPCONN RACES A STALLED CONNECT AGAINST THE NEXT ADDRESS
+	struct espconn espconn;
+	esp_tcp user_tcp;
+	struct espconn race_espconn;
+	esp_tcp race_tcp;
+	struct espconn* conn; //ESPCONN OF THE CONNECTION IN USE (espconn OR race_espconn)
+	uint8_t connected;
+	uint8_t closing; //CLOSE OF conn UNDER WAY. SET UNTIL ITS CALLBACK HAS BEEN PROCESSED
+	uint8_t start_on_close; //A CYCLE CAME DUE WHILE closing. IT STARTS ONCE THE CLOSE IS DONE
+
+	//IP / HOSTNAME RELATED
+	const char* host_name;
+	const char* host_ip;
+	ip_addr_t resolved_host_ip;
+	const char* host_path;
+	uint16_t host_port;
+	ESP8266_TCP_GET_DNS_CACHE dns_cache;
+
+	//FAILOVER RELATED
+	ESP8266_TCP_GET_ADDRESS addresses[ESP8266_TCP_GET_MAX_ADDRESSES];
+	uint8_t address_count;
+	uint8_t address_order[ESP8266_TCP_GET_MAX_ADDRESSES]; //ORDER OF THE CURRENT CYCLE
+	uint8_t address_order_count;
+	uint8_t address_next; //NEXT POSITION IN address_order
+	ESP8266_TCP_GET_ATTEMPT attempts[2]; //ONE PER ESPCONN (espconn, race_espconn)
+	uint32_t connect_timeout_ms;
+	uint32_t connect_stagger_ms;
+	uint32_t connect_deadline; //system_get_time() THE CONNECT PHASE OF THE CYCLE ENDS
+
+	//TIMER RELATED
+	//DEADLINES ON THE LIBRARY TIMER WHEEL
+	ESP8266_TCP_GET_TIMER dns_timer;
+	ESP8266_TCP_GET_TIMER timer;
+	uint32_t timer_interval;
+	ESP8266_TCP_GET_TIMER reply_timeout_timer;
+	ESP8266_TCP_GET_TIMER idle_timer;
+	ESP8266_TCP_GET_TIMER connect_timer;
+
+	//SCHEDULER RELATED
+	//ONE CYCLE AT A TIME. THE NEXT CYCLE IS SCHEDULED WHEN THE CURRENT ONE ENDS
+	uint8_t acquisition_running;
+	uint8_t cycle_active;
+	uint8_t consecutive_failures;
+	uint32_t interval_min;
+	uint32_t interval_max;
+	uint32_t current_interval;
+	uint32_t last_data_hash;
+	uint8_t snapshot_restored; //KEEP THE RESTORED INTERVAL AND BACKOFF ON START
+	uint32_t next_cycle_time; //system_get_time() THE ACQUISITION TIMER IS ARMED FOR
+	uint8_t dns_wakes;
+
+	//COUNTERS
+	uint16_t dns_retry_count;
+	uint32_t data_acquisition_count;
+
+	//STATISTICS RELATED (system_get_time() TIMESTAMPS OF THE CURRENT CYCLE)
+	ESP8266_TCP_GET_STATS stats;
+	uint32_t dns_start_time;
+	uint32_t cycle_start_time;
+	uint32_t connect_start_time;
+	uint32_t send_start_time;
+	uint32_t sent_time;
+	uint32_t first_byte_time;
+	uint32_t parse_time;
+	uint8_t first_byte_received;
+
+	//MEMORY RELATED
+	ESP8266_TCP_GET_ARENA arena;
+
+	//TCP OBJECT STATE
+	char* get_request_buffer;
+	uint32_t get_request_buffer_size;
+	uint32_t get_request_length;
+	uint32_t get_request_prefix_length; //REQUEST WITHOUT THE CONDITIONAL HEADERS AND THE FINAL CRLF
+
+	//UPLOAD RELATED
+	ESP8266_TCP_GET_METHOD method;
+	const char* content_type;
+	uint16_t (*upload_producer_cb)(ESP8266_TCP_GET*, char*, uint16_t);
+	ESP8266_TCP_GET_UPLOAD_STATE upload_state;
+	char* upload_chunk; //CHUNK BUFFER OF THE REQUEST IN PROGRESS (ARENA SCRATCH)
+	ESP8266_TCP_GET_UPLOAD_QUEUE upload_queue;
+
+	//CONDITIONAL GET RELATED
+	uint8_t conditional_get;
+	char etag[ESP8266_TCP_GET_ETAG_SIZE];
+	char last_modified[ESP8266_TCP_GET_LAST_MODIFIED_SIZE];
+	ESP8266_TCP_GET_STATE state;
+
+	//KEEP-ALIVE RELATED
+	uint8_t keep_alive;
+	uint32_t keep_alive_idle_timeout_ms;
+
+	//TLS RELATED
+	uint8_t secure;
+
+	//STREAMING RELATED
+	ESP8266_TCP_GET_STREAM_MODE stream_mode;
+	uint32_t stream_idle_timeout_ms;
+	uint32_t stream_retry_ms; //RECONNECT DELAY. SSE SERVERS CAN CHANGE IT (retry FIELD)
+	uint32_t stream_events; //EVENTS OF THE CURRENT STREAM
+	char last_event_id[ESP8266_TCP_GET_EVENT_ID_SIZE]; //SENT AS Last-Event-ID ON RECONNECT
+	uint8_t last_event_id_changed;
+	ESP8266_TCP_GET_SSE sse;
+
+	//CONNECTION SLOT SCHEDULER RELATED
+	uint8_t holds_slot;
+	uint8_t waiting_for_slot;
+	ESP8266_TCP_GET* next_waiting;
+
+	//HTTP REPLY RELATED
+	ESP8266_TCP_GET_HTTP_PARSER http_parser;
+	uint8_t reply_pending;
+	uint8_t queue_overflow; //A SEGMENT OF THIS REPLY WAS DROPPED (DEFERRED PROCESSING)
+
+	//CALLBACK FUNCTION VARIABLES
+	void (*dns_cb_function)(ESP8266_TCP_GET*, ip_addr_t*);
+	void (*tcp_conn_cb)(void*);
+	void (*tcp_discon_cb)(void*);
+	void (*tcp_send_cb)(void*);
+	void (*tcp_recv_cb)(void*, char*, unsigned short);
+	void (*user_data_ready_cb)(ESP8266_TCP_GET*, ESP8266_TCP_GET_USER_DATA_CONTAINER*);
+	uint8_t (*body_sink_cb)(ESP8266_TCP_GET*, char*, uint16_t);
+
+	//BODY SINK FLOW CONTROL RELATED
+	uint8_t body_busy; //SINK RETURNED 0. HOLD THE NEXT SEGMENTS
+	uint8_t body_held; //espconn_recv_hold IN EFFECT
+
+	//USER DATA RELATED
+	ESP8266_TCP_GET_USER_DATA_CONTAINER* user_data_container;
+	ESP8266_TCP_GET_SUBSCRIBER* subscribers;
+	uint8_t recompile_pending; //SUBSCRIPTIONS CHANGED DURING A REPLY
+	const ESP8266_TCP_GET_RULE_TABLE* rule_table; //NULL = COMPILE THE RULES OF THE CONTAINERS AT RUNTIME
+	ESP8266_TCP_GET_EXTRACTOR extractor;
+	uint8_t stop_when_all_found;
+	uint8_t json_mode;
+	ESP8266_TCP_GET_JSON json;
+
+	//COMPRESSION RELATED
+	uint8_t compression;
+	uint32_t inflate_window_size;
+	ESP8266_TCP_GET_INFLATE* inflate; //DECODER OF THE CURRENT REPLY (ARENA SCRATCH). NULL = IDENTITY
+
+	//LOG RELATED
+	uint8_t log_id; //INSTANCE NUMBER IN THE LOG RECORDS
+};
 //END CUSTOM VARIABLE STRUCTURES/////////////////////////
 
 //FUNCTION PROTOTYPES/////////////////////////////////////
 //CONFIGURATION FUNCTIONS
 void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetDebug(uint8_t debug_on);
-void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Initialize(const char* hostname,
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Initialize(ESP8266_TCP_GET* tcp_get, const char* hostname,
 													const char* host_ip,
 													uint16_t host_port,
 													const char* host_path,
 													uint32_t tcp_connection_interval_ms);
-void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Intialize_Request_Buffer(uint32_t buffer_size);
-void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Initialize_UserDataContainer(ESP8266_TCP_GET_USER_DATA_CONTAINER* container);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Initialize_Arena(ESP8266_TCP_GET* tcp_get, uint32_t arena_size);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Intialize_Request_Buffer(ESP8266_TCP_GET* tcp_get, uint32_t buffer_size);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetIntervalBounds(ESP8266_TCP_GET* tcp_get, uint32_t min_interval_ms, uint32_t max_interval_ms);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetKeepAlive(ESP8266_TCP_GET* tcp_get, uint8_t keep_alive_on, uint32_t idle_timeout_ms);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetConditionalGet(ESP8266_TCP_GET* tcp_get, uint8_t conditional_on);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetCompression(ESP8266_TCP_GET* tcp_get, uint8_t compression_on, uint32_t window_size);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetSecure(ESP8266_TCP_GET* tcp_get, uint8_t secure_on, uint16_t buffer_size);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetStreamMode(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_STREAM_MODE mode, uint32_t idle_timeout_ms);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetRequestMethod(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_METHOD method,
+														const char* content_type,
+														uint16_t (*producer_cb)(ESP8266_TCP_GET*, char*, uint16_t));
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Initialize_UploadQueue(ESP8266_TCP_GET* tcp_get, uint16_t queue_bytes,
+																uint16_t batch_count,
+																uint32_t batch_ms);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Initialize_UserDataContainer(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_USER_DATA_CONTAINER* container);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Subscribe(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_SUBSCRIBER* subscriber,
+													ESP8266_TCP_GET_USER_DATA_CONTAINER* container,
+													uint32_t max_staleness_ms,
+													void (*data_ready_cb)(ESP8266_TCP_GET*, ESP8266_TCP_GET_USER_DATA_CONTAINER*));
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_Unsubscribe(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_SUBSCRIBER* subscriber);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetDoubleBuffer(ESP8266_TCP_GET_USER_DATA_CONTAINER* container, ESP8266_TCP_GET_EXTRACTED_DATA* back_data);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetRuleTable(ESP8266_TCP_GET* tcp_get, const ESP8266_TCP_GET_RULE_TABLE* rule_table);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetStopWhenAllDataFound(ESP8266_TCP_GET* tcp_get, uint8_t stop_on);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetJsonMode(ESP8266_TCP_GET* tcp_get, uint8_t json_on);
 void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetDnsServer(char num_dns, ip_addr_t* dns);
-void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetCallbackFunctions(void (*tcp_con_cb)(void*),
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetDnsCacheTtl(ESP8266_TCP_GET* tcp_get, uint32_t ttl_s);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SeedDnsCache(ESP8266_TCP_GET* tcp_get, ip_addr_t* ip);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetConnectTimeout(ESP8266_TCP_GET* tcp_get, uint32_t timeout_ms, uint32_t stagger_ms);
+uint8_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_AddServerAddress(ESP8266_TCP_GET* tcp_get, ip_addr_t* ip);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetMaxConcurrentConnections(uint8_t max_connections);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetDeferredProcessing(uint8_t task_priority, uint16_t queue_depth, uint16_t queue_bytes);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetLogDrain(uint8_t task_priority, void (*write_fn)(uint8_t*, uint16_t));
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetCallbackFunctions(ESP8266_TCP_GET* tcp_get, void (*tcp_con_cb)(void*),
 															void (*tcp_discon_cb)(void*),
 															void (tcp_send_cb)(void*),
 															void (tcp_recv_cb)(void*, char*, unsigned short),
-															void (user_data_ready_cb)(ESP8266_TCP_GET_USER_DATA_CONTAINER*));
+															void (user_data_ready_cb)(ESP8266_TCP_GET*, ESP8266_TCP_GET_USER_DATA_CONTAINER*));
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_SetBodySink(ESP8266_TCP_GET* tcp_get, uint8_t (*body_sink_cb)(ESP8266_TCP_GET*, char*, uint16_t));
 
 //GET PARAMETERS FUNCTIONS
-uint32_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetDataAcquisitionInterval(void);
-const char* ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetSourceHost(void);
-const char* ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetSourcePath(void);
-uint16_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetSourcePort(void);
-ESP8266_TCP_GET_STATE ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetState(void);
+uint32_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetDataAcquisitionInterval(ESP8266_TCP_GET* tcp_get);
+const char* ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetSourceHost(ESP8266_TCP_GET* tcp_get);
+const char* ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetSourcePath(ESP8266_TCP_GET* tcp_get);
+uint16_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetSourcePort(ESP8266_TCP_GET* tcp_get);
+ESP8266_TCP_GET_STATE ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetState(ESP8266_TCP_GET* tcp_get);
+uint16_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetReplyStatusCode(ESP8266_TCP_GET* tcp_get);
+ESP8266_TCP_GET_DNS_CACHE_STATE ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetDnsCacheEntry(ESP8266_TCP_GET* tcp_get, ip_addr_t* ip);
+const char* ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetLastEventId(ESP8266_TCP_GET* tcp_get);
+uint8_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetServerAddresses(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_ADDRESS* addresses, uint8_t max_addresses);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetStats(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_STATS* stats);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_ResetStats(ESP8266_TCP_GET* tcp_get);
+uint32_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetArenaSize(ESP8266_TCP_GET* tcp_get);
+uint32_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetArenaHighWaterMark(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetQueueStats(ESP8266_TCP_GET_QUEUE_STATS* stats);
+uint8_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_GetDeadlines(ESP8266_TCP_GET_DEADLINE* deadlines, uint8_t max_deadlines, uint32_t* wakes);
+uint16_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_ReadLog(uint8_t* buffer, uint16_t size);
 
 //CONTROL FUNCTIONS
-void ICACHE_FLASH_ATTR ESP8266_TCP_GET_ResolveHostName(void (*user_dns_cb_fn)(ip_addr_t*));
-void ICACHE_FLASH_ATTR ESP8266_TCP_GET_StartDataAcqusition(void);
-void ICACHE_FLASH_ATTR ESP8266_TCP_GET_StopDataAcquisition(void);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_ResolveHostName(ESP8266_TCP_GET* tcp_get, void (*user_dns_cb_fn)(ESP8266_TCP_GET*, ip_addr_t*));
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_StartDataAcqusition(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_StopDataAcquisition(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR ESP8266_TCP_GET_ResumeBody(ESP8266_TCP_GET* tcp_get);
+uint8_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_QueueReading(ESP8266_TCP_GET* tcp_get, const char* reading, uint16_t length);
+uint8_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_SaveSnapshot(ESP8266_TCP_GET* tcp_get, uint8_t rtc_block);
+uint8_t ICACHE_FLASH_ATTR ESP8266_TCP_GET_RestoreSnapshot(ESP8266_TCP_GET* tcp_get, uint8_t rtc_block);
 
 //INTERNAL CALLBACK FUNCTIONS
 void ICACHE_FLASH_ATTR _esp8266_tcp_get_dns_timer_cb(void* arg);
@@ -87,7 +1004,163 @@ void ICACHE_FLASH_ATTR _esp8266_tcp_get_connect_cb(void* arg);
 void ICACHE_FLASH_ATTR _esp8266_tcp_get_disconnect_cb(void* arg);
 void ICACHE_FLASH_ATTR _esp8266_tcp_get_send_cb(void* arg);
 void ICACHE_FLASH_ATTR _esp8266_tcp_get_receive_cb(void* arg, char* pusrdata, unsigned short length);
-void ICACHE_FLASH_ATTR _esp8266_tcp_get_receive_timeout_cb(void);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_receive_timeout_cb(void* arg);
 void ICACHE_FLASH_ATTR _esp8266_tcp_get_data_acquisition_timer_cb(void* arg);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_reconnect_cb(void* arg, sint8 err);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_idle_timeout_cb(void* arg);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_connect_timer_cb(void* arg);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_task(os_event_t* event);
+
+//INTERNAL DEFERRED PROCESSING FUNCTIONS
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_defer(ESP8266_TCP_GET* tcp_get, uint8_t type, char* data, uint16_t length);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_receive_process(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_disconnect_process(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_reconnect_process(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_close_done(ESP8266_TCP_GET* tcp_get);
+
+//INTERNAL DNS CACHE FUNCTIONS
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_dns_lookup(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_dns_refresh(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_dns_resolved(ESP8266_TCP_GET* tcp_get, ip_addr_t* ip);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_dns_failed(ESP8266_TCP_GET* tcp_get);
+
+//INTERNAL CONNECTION FUNCTIONS
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_build_request(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_build_conditional(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_connect(ESP8266_TCP_GET* tcp_get);
+struct espconn* ICACHE_FLASH_ATTR _esp8266_tcp_get_attempt_espconn(ESP8266_TCP_GET* tcp_get, uint8_t index);
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_attempt_index(ESP8266_TCP_GET* tcp_get, struct espconn* pespconn);
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_attempt_start(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_attempt_abort(ESP8266_TCP_GET* tcp_get, uint8_t index);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_attempt_failed(ESP8266_TCP_GET* tcp_get, uint8_t index);
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_attempt_callback(ESP8266_TCP_GET* tcp_get, struct espconn* pespconn);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_connect_arm(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_connect_failed(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_addresses_order(ESP8266_TCP_GET* tcp_get);
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_address_score(ESP8266_TCP_GET_ADDRESS* address);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_slot_enqueue(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_slot_dequeue(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_slot_release(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_disconnect(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_send_request(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_send(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_release_connection(ESP8266_TCP_GET* tcp_get, uint8_t reusable);
+
+//INTERNAL UPLOAD FUNCTIONS
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_upload_start(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_upload_chunk(ESP8266_TCP_GET* tcp_get);
+uint16_t ICACHE_FLASH_ATTR _esp8266_tcp_get_upload_queue_read(ESP8266_TCP_GET* tcp_get, char* buffer, uint16_t size);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_upload_done(ESP8266_TCP_GET* tcp_get, uint8_t success);
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_upload_next(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_upload_pull(ESP8266_TCP_GET* tcp_get);
+
+//INTERNAL TIMER WHEEL FUNCTIONS
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_timer_setup(ESP8266_TCP_GET_TIMER* timer, void (*fn)(void*), void* arg, uint8_t type);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_timer_arm(ESP8266_TCP_GET_TIMER* timer, uint32_t ms);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_timer_cancel(ESP8266_TCP_GET_TIMER* timer);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_insert(ESP8266_TCP_GET_TIMER* timer);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_remove(ESP8266_TCP_GET_TIMER* timer);
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_clock(void);
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_first(uint8_t level);
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_next(uint32_t* tick, uint8_t exact);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_advance(uint32_t target);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_program(void);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_sleep(uint32_t tick);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_wheel_cb(void* arg);
+
+//INTERNAL LOG FUNCTIONS
+#if ESP8266_TCP_GET_LOG_LEVEL > ESP8266_TCP_GET_LOG_LEVEL_NONE
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_log(ESP8266_TCP_GET* tcp_get, uint8_t event, uint16_t a, uint32_t b);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_log_frame(uint8_t* frame);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_log_task(os_event_t* event);
+#endif
+
+//INTERNAL STATISTICS FUNCTIONS
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_stats_record(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_PHASE phase, uint32_t duration_us);
+
+//INTERNAL SCHEDULER FUNCTIONS
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_cycle_done(ESP8266_TCP_GET* tcp_get, uint8_t success, uint8_t changed);
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_data_hash(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_subscribers_mark_due(ESP8266_TCP_GET* tcp_get);
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_subscribers_next(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_subscribers_changed(ESP8266_TCP_GET* tcp_get);
+
+//INTERNAL SNAPSHOT FUNCTIONS
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_fnv(uint32_t hash, const uint8_t* data, uint32_t length);
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_config_hash(ESP8266_TCP_GET* tcp_get);
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_rtc_block_valid(uint8_t rtc_block);
+
+//INTERNAL RESULT PUBLISHING FUNCTIONS
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_field_hash(ESP8266_TCP_GET_EXTRACTED_DATA* data);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_bind_fields(ESP8266_TCP_GET* tcp_get, uint8_t back);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_bind_container(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_USER_DATA_CONTAINER* container,
+														uint8_t start, uint8_t count, uint8_t back);
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_container_publish(ESP8266_TCP_GET_USER_DATA_CONTAINER* container, uint8_t new_data);
+
+//INTERNAL ARENA FUNCTIONS
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_arena_reserve(ESP8266_TCP_GET* tcp_get, uint32_t arena_size);
+void* ICACHE_FLASH_ATTR _esp8266_tcp_get_arena_alloc(ESP8266_TCP_GET* tcp_get, uint32_t size, uint8_t persistent);
+void* ICACHE_FLASH_ATTR _esp8266_tcp_get_arena_alloc_table(ESP8266_TCP_GET* tcp_get, uint32_t size);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_arena_rewind(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_arena_tables_free(ESP8266_TCP_GET* tcp_get);
+
+//INTERNAL HTTP REPLY PARSER FUNCTIONS
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_http_parser_reset(ESP8266_TCP_GET* tcp_get);
+uint16_t ICACHE_FLASH_ATTR _esp8266_tcp_get_http_parse(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_http_process_line(ESP8266_TCP_GET* tcp_get);
+const char* ICACHE_FLASH_ATTR _esp8266_tcp_get_http_header_value(const char* line, const char* name);
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_match_lower(const char* str, const char* lower);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_http_copy_value(char* dest, const char* value, uint16_t size);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_reply_done(ESP8266_TCP_GET* tcp_get, uint8_t success);
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_reply_timeout(ESP8266_TCP_GET* tcp_get);
+
+//INTERNAL SERVER-SENT EVENTS FUNCTIONS
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_sse_reset(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_sse_feed(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_sse_field(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_sse_data(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_sse_line_end(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_sse_dispatch(ESP8266_TCP_GET* tcp_get);
+
+//INTERNAL USER DATA EXTRACTOR FUNCTIONS
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_compile(ESP8266_TCP_GET* tcp_get);
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_load(ESP8266_TCP_GET* tcp_get);
+#ifndef ESP8266_TCP_GET_FLASH_RULES
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_build(ESP8266_TCP_GET* tcp_get);
+const char* ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_pattern(ESP8266_TCP_GET* tcp_get, uint8_t pattern);
+#endif
+char ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_pattern_char(ESP8266_TCP_GET* tcp_get, uint8_t pattern, uint8_t i);
+uint16_t ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_child(ESP8266_TCP_GET* tcp_get, uint16_t node, char c);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_reset(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_feed(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_match(ESP8266_TCP_GET* tcp_get, uint8_t pattern);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_capture(ESP8266_TCP_GET* tcp_get, uint8_t pattern, char c);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_field_done(ESP8266_TCP_GET* tcp_get, uint8_t pattern);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_extractor_finish(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_body_feed(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_body_extract(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length);
+
+//INTERNAL JSON EXTRACTOR FUNCTIONS
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_json_path_hash(const char* path);
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_json_segment(uint32_t parent, uint32_t segment);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_reset(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_feed(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_value_start(ESP8266_TCP_GET* tcp_get, char c);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_value_end(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_close(ESP8266_TCP_GET* tcp_get, char c);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_capture(ESP8266_TCP_GET* tcp_get, char c);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_number(ESP8266_TCP_GET* tcp_get, char c);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_json_finish(ESP8266_TCP_GET* tcp_get);
+
+//INTERNAL CONTENT DECODING FUNCTIONS
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_start(ESP8266_TCP_GET* tcp_get);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_feed(ESP8266_TCP_GET* tcp_get, char* data, uint16_t length);
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_step(ESP8266_TCP_GET* tcp_get);
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_need(ESP8266_TCP_GET_INFLATE* inf, uint8_t bits);
+uint32_t ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_take(ESP8266_TCP_GET_INFLATE* inf, uint8_t bits);
+int16_t ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_decode(ESP8266_TCP_GET_INFLATE* inf, const uint16_t* counts, const uint16_t* symbols);
+uint8_t ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_build(uint16_t* counts, uint16_t* symbols, const uint8_t* lengths, uint16_t count);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_put(ESP8266_TCP_GET* tcp_get, uint8_t c);
+void ICACHE_FLASH_ATTR _esp8266_tcp_get_inflate_flush(ESP8266_TCP_GET* tcp_get);
 //END FUNCTION PROTOTYPES/////////////////////////////////
 #endif
@@ -0,0 +1,463 @@
+//ESP8266_TCP_GET HOST HARNESS
+//RECEIVE PATH BENCHMARK
+//
+//REPLAYS RECORDED REPLIES (fixtures/*.http) THROUGH _esp8266_tcp_get_receive_cb, ONE
+//SEGMENT AT A TIME, AND REPORTS FOR EACH SCENARIO
+//	ns/byte		FASTEST OF THE REPETITIONS, WHOLE REPLY INCLUDING THE DATA READY CALLBACK
+//	heap		BYTES os_zalloc'ED FOR THE INSTANCE (ALL AT INITIALIZATION)
+//	arena		ESP8266_TCP_GET_GetArenaHighWaterMark AFTER THE REPLIES
+//	fields		FOR EACH FIELD, THE BYTE AND THE TIME INTO THE REPLY AT WHICH IT WAS FOUND
+//
+//EVERY REPLY MUST YIELD THE EXPECTED VALUES, AND os_zalloc MUST NOT BE CALLED AFTER
+//INITIALIZATION. A SCENARIO OVER ONE OF ITS THRESHOLDS IS A REGRESSION AND THE
+//PROGRAM EXITS WITH 1
+//
+//usage: bench [-s segment_size] [-r repetitions] [-t threshold_scale] [scenario ...]
+//	-s	REPLAY EVERY SCENARIO WITH THIS SEGMENT SIZE. THE ns/byte THRESHOLDS HOLD FOR THE
+//		SEGMENT SIZE OF EACH SCENARIO ONLY, SO THEY ARE NOT CHECKED
+//	-t	MULTIPLY THE ns/byte THRESHOLDS (FOR A SLOWER HOST, OR A DEBUG BUILD)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ESP8266_TCP_GET.h"
+#include "host.h"
+#include "espconn_stub.h"
+
+#define BENCH_MAX_FIELDS			4
+#define BENCH_MAX_SCENARIOS			16
+#define BENCH_MAX_FIXTURE			32768
+#define BENCH_DEFAULT_REPETITIONS	200
+#define BENCH_CONNECT_WAIT_MS		600000
+
+typedef struct
+{
+	const char* match; //MATCH STRING, OR THE KEY PATH IN JSON MODE
+	char terminator; //TEXT MODE. THE VALUE STARTS RIGHT AFTER THE MATCH STRING
+	const char* expected;
+}BENCH_FIELD;
+
+typedef struct
+{
+	const char* name;
+	const char* fixture;
+	uint8_t json_mode;
+	uint16_t compression_window; //0 = COMPRESSION OFF
+	uint32_t arena_size; //0 = ESP8266_TCP_GET_ARENA_DEFAULT_SIZE
+	uint16_t segment_size;
+	BENCH_FIELD fields[BENCH_MAX_FIELDS];
+	double max_ns_per_byte;
+	uint32_t max_heap_bytes;
+	uint32_t max_arena_bytes;
+}BENCH_SCENARIO;
+
+typedef struct
+{
+	uint32_t byte; //END OF THE SEGMENT IN WHICH THE FIELD WAS FOUND. 0 = NOT FOUND
+	uint64_t ns;
+}BENCH_FIELD_TIME;
+
+//THE ns/byte THRESHOLDS ARE ABOUT 4 TIMES WHAT AN x86-64 DEVELOPMENT HOST MEASURES
+//AT -O2, SO ONLY A REAL REGRESSION TRIPS THEM. HEAP AND ARENA DO NOT DEPEND ON THE
+//SPEED OF THE HOST, ONLY ON ITS POINTER SIZE. THEIRS ARE FOR A 64 BIT HOST, ABOUT 10%
+//OVER WHAT IT MEASURES
+static const BENCH_SCENARIO _bench_scenarios[] =
+{
+	{
+		"weather-length", "fixtures/weather_length.http", 0, 0, 0, 1460,
+		{
+			{"\"temp\":", ',', "281.52"},
+			{"\"humidity\":", '}', "93"},
+			{"\"description\":\"", '"', "overcast clouds"},
+			{"\"name\":\"", '"', "London"}
+		},
+		30.0, 1600, 1100
+	},
+	{
+		"weather-length-1", "fixtures/weather_length.http", 0, 0, 0, 1,
+		{
+			{"\"temp\":", ',', "281.52"},
+			{"\"humidity\":", '}', "93"},
+			{"\"description\":\"", '"', "overcast clouds"},
+			{"\"name\":\"", '"', "London"}
+		},
+		120.0, 1600, 1100
+	},
+	{
+		"weather-chunked", "fixtures/weather_chunked.http", 0, 0, 0, 536,
+		{
+			{"\"temp\":", ',', "281.52"},
+			{"\"humidity\":", '}', "93"},
+			{"\"description\":\"", '"', "overcast clouds"},
+			{"\"name\":\"", '"', "London"}
+		},
+		30.0, 1600, 1100
+	},
+	{
+		"weather-json", "fixtures/weather_length.http", 1, 0, 0, 1460,
+		{
+			{"main.temp", 0, "281.52"},
+			{"main.humidity", 0, "93"},
+			{"weather[0].description", 0, "overcast clouds"},
+			{"name", 0, "London"}
+		},
+		20.0, 1600, 1200
+	},
+	{
+		"weather-gzip", "fixtures/weather_gzip.http", 0, 1024, 4096, 1460,
+		{
+			{"\"temp\":", ',', "281.52"},
+			{"\"humidity\":", '}', "93"},
+			{"\"description\":\"", '"', "overcast clouds"},
+			{"\"name\":\"", '"', "London"}
+		},
+		100.0, 4200, 3300
+	},
+	{
+		"forecast-json", "fixtures/forecast_chunked.http", 1, 0, 0, 1460,
+		{
+			{"cnt", 0, "40"},
+			{"list[0].main.temp", 0, "282.59"},
+			{"list[3].dt_txt", 0, "2023-10-17 09:00:00"},
+			{"city.name", 0, "London"}
+		},
+		20.0, 1600, 1100
+	},
+	{
+		"status-close", "fixtures/status_close.http", 0, 0, 0, 1460,
+		{
+			{"uptime=", ';', "1234567"},
+			{"load=", ';', "0.42"},
+			{"cpu_temp=", ';', "51.3"},
+			{NULL, 0, NULL}
+		},
+		30.0, 1600, 800
+	}
+};
+
+#define BENCH_SCENARIO_COUNT	(sizeof(_bench_scenarios) / sizeof(_bench_scenarios[0]))
+
+static ESP8266_TCP_GET _bench_instances[BENCH_MAX_SCENARIOS];
+static ESP8266_TCP_GET_EXTRACTED_DATA _bench_fields[BENCH_MAX_SCENARIOS][BENCH_MAX_FIELDS];
+static ESP8266_TCP_GET_USER_DATA_CONTAINER _bench_containers[BENCH_MAX_SCENARIOS];
+static char _bench_fixture[BENCH_MAX_FIXTURE];
+static char _bench_segment[BENCH_MAX_FIXTURE];
+static uint32_t _bench_replies;
+static uint32_t _bench_failed_replies;
+
+static uint64_t _bench_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void _bench_data_ready_cb(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_USER_DATA_CONTAINER* container)
+{
+	//A NULL CONTAINER IS A FAILED REPLY
+	if(container == NULL)
+	{
+		_bench_failed_replies++;
+		return;
+	}
+	_bench_replies++;
+}
+
+static uint32_t _bench_load(const char* path)
+{
+	FILE* f = fopen(path, "rb");
+	size_t length;
+
+	if(f == NULL)
+	{
+		fprintf(stderr, "bench: can not open %s (run from the host directory)\n", path);
+		exit(2);
+	}
+	length = fread(_bench_fixture, 1, sizeof(_bench_fixture), f);
+	fclose(f);
+	if(length == 0 || length == sizeof(_bench_fixture))
+	{
+		fprintf(stderr, "bench: %s is empty or larger than %d bytes\n", path, BENCH_MAX_FIXTURE);
+		exit(2);
+	}
+	return (uint32_t)length;
+}
+
+static uint8_t _bench_field_count(const BENCH_SCENARIO* s)
+{
+	uint8_t count = 0;
+
+	while(count < BENCH_MAX_FIELDS && s->fields[count].match != NULL)
+	{
+		count++;
+	}
+	return count;
+}
+
+static void _bench_setup(uint8_t index, const BENCH_SCENARIO* s)
+{
+	//SET UP AN INSTANCE AS AN APPLICATION WOULD
+	ESP8266_TCP_GET* tcp_get = &_bench_instances[index];
+	ESP8266_TCP_GET_EXTRACTED_DATA* fields = _bench_fields[index];
+	uint8_t count = _bench_field_count(s);
+	uint8_t i;
+
+	ESP8266_TCP_GET_Initialize(tcp_get, "api.example.com", NULL, 80, "/data", 1000);
+	ESP8266_TCP_GET_SetDebug(0); //NO DEBUG OUTPUT IN THE TIMED REPLIES
+	if(s->arena_size != 0)
+	{
+		ESP8266_TCP_GET_Initialize_Arena(tcp_get, s->arena_size);
+	}
+	ESP8266_TCP_GET_Intialize_Request_Buffer(tcp_get, 256);
+	ESP8266_TCP_GET_SetJsonMode(tcp_get, s->json_mode);
+	ESP8266_TCP_GET_SetCompression(tcp_get, s->compression_window != 0, s->compression_window);
+	for(i = 0; i < count; i++)
+	{
+		strcpy(fields[i].extracted_data_start_match_string, s->fields[i].match);
+		fields[i].extracted_data_offset_from_match_string = (uint8_t)strlen(s->fields[i].match);
+		fields[i].extracted_data_terminating_char = s->fields[i].terminator;
+	}
+	_bench_containers[index].tcp_reply_extracted_data_count = count;
+	_bench_containers[index].tcp_reply_extracted_data = fields;
+	ESP8266_TCP_GET_Initialize_UserDataContainer(tcp_get, &_bench_containers[index]);
+	ESP8266_TCP_GET_SetCallbackFunctions(tcp_get, NULL, NULL, NULL, NULL, _bench_data_ready_cb);
+	ESP8266_TCP_GET_ResolveHostName(tcp_get, NULL);
+	ESP8266_TCP_GET_StartDataAcqusition(tcp_get);
+}
+
+static uint64_t _bench_reply(uint8_t index, uint32_t length, uint16_t segment_size, uint8_t field_count,
+								BENCH_FIELD_TIME* found)
+{
+	//RUN ONE CYCLE OF THE INSTANCE AND ANSWER IT WITH THE FIXTURE
+	//RETURNS THE ns SPENT IN THE RECEIVE CALLBACKS
+	ESP8266_TCP_GET_EXTRACTED_DATA* fields = _bench_fields[index];
+	struct espconn* conn;
+	uint64_t start;
+	uint64_t waited = 0;
+	uint32_t offset;
+	uint16_t n;
+	uint8_t i;
+
+	//FOUND FLAGS OF THE PREVIOUS REPLY STAY UNTIL THE LIBRARY REACHES THE BODY
+	for(i = 0; i < field_count; i++)
+	{
+		fields[i].data_found = 0;
+	}
+
+	while(espconn_stub.connecting == NULL)
+	{
+		if(waited >= BENCH_CONNECT_WAIT_MS)
+		{
+			fprintf(stderr, "bench: instance did not connect within %d ms\n", BENCH_CONNECT_WAIT_MS);
+			exit(2);
+		}
+		host_run_for(100);
+		waited += 100;
+	}
+	conn = espconn_stub.connecting;
+	espconn_stub.connecting = NULL;
+	_esp8266_tcp_get_connect_cb(conn);
+
+	//THE LIBRARY MAY NOT KEEP POINTERS INTO A SEGMENT, SO EACH REPLY IS REPLAYED
+	//FROM A FRESH COPY, AS THE SDK HANDS OUT EACH pbuf ONCE
+	memcpy(_bench_segment, _bench_fixture, length);
+	memset(found, 0, field_count * sizeof(BENCH_FIELD_TIME));
+
+	start = _bench_ns();
+	for(offset = 0; offset < length; offset += n)
+	{
+		n = (length - offset < segment_size) ? (uint16_t)(length - offset) : segment_size;
+		_esp8266_tcp_get_receive_cb(conn, _bench_segment + offset, n);
+		for(i = 0; i < field_count; i++)
+		{
+			if(found[i].byte == 0 && fields[i].data_found)
+			{
+				found[i].byte = offset + n;
+				found[i].ns = _bench_ns() - start;
+			}
+		}
+	}
+	start = _bench_ns() - start;
+
+	//THE SERVER (OR THE LIBRARY'S espconn_disconnect) CLOSES THE CONNECTION
+	_esp8266_tcp_get_disconnect_cb(conn);
+	return start;
+}
+
+static uint8_t _bench_run(uint8_t index, const BENCH_SCENARIO* s, uint16_t segment_size, uint32_t repetitions,
+							double threshold_scale, uint8_t check_time)
+{
+	//RUN A SCENARIO, PRINT ITS REPORT. RETURNS 1 IF IT FAILED
+	ESP8266_TCP_GET* tcp_get = &_bench_instances[index];
+	ESP8266_TCP_GET_EXTRACTED_DATA* fields = _bench_fields[index];
+	uint8_t field_count = _bench_field_count(s);
+	BENCH_FIELD_TIME found[BENCH_MAX_FIELDS];
+	BENCH_FIELD_TIME best_found[BENCH_MAX_FIELDS];
+	uint64_t best = (uint64_t)-1;
+	uint64_t ns;
+	uint32_t heap_before = host_heap.bytes;
+	uint32_t heap;
+	uint32_t arena;
+	uint32_t length = _bench_load(s->fixture);
+	uint32_t r;
+	uint8_t failed = 0;
+	uint8_t i;
+	double ns_per_byte;
+	double max_ns_per_byte = s->max_ns_per_byte * threshold_scale;
+
+	_bench_setup(index, s);
+	heap = host_heap.bytes - heap_before;
+	host_heap_mark();
+	_bench_replies = 0;
+	_bench_failed_replies = 0;
+
+	for(r = 0; r < repetitions; r++)
+	{
+		ns = _bench_reply(index, length, segment_size, field_count, found);
+		for(i = 0; i < field_count; i++)
+		{
+			if(strcmp(fields[i].extracted_data, s->fields[i].expected) != 0 || found[i].byte == 0)
+			{
+				if(!failed)
+				{
+					printf("%-18s FIELD %s = \"%s\" (found %d), EXPECTED \"%s\"\n", s->name, s->fields[i].match,
+							fields[i].extracted_data, fields[i].data_found, s->fields[i].expected);
+				}
+				failed = 1;
+			}
+		}
+		if(ns < best)
+		{
+			best = ns;
+			memcpy(best_found, found, sizeof(found));
+		}
+	}
+	ESP8266_TCP_GET_StopDataAcquisition(tcp_get);
+
+	arena = ESP8266_TCP_GET_GetArenaHighWaterMark(tcp_get);
+	ns_per_byte = (double)best / length;
+	if(_bench_replies != repetitions || _bench_failed_replies != 0)
+	{
+		printf("%-18s %u OF %u REPLIES OK, %u FAILED\n", s->name, _bench_replies, repetitions, _bench_failed_replies);
+		failed = 1;
+	}
+	if(host_heap.calls != 0)
+	{
+		printf("%-18s %u os_zalloc CALLS AFTER INITIALIZATION\n", s->name, host_heap.calls);
+		failed = 1;
+	}
+
+	printf("%-18s %6u %5u %8.1f %s%7.1f %6u %s%6u %6u %s%6u\n", s->name, length, segment_size,
+			ns_per_byte, (check_time && ns_per_byte > max_ns_per_byte) ? "!" : " ", max_ns_per_byte,
+			heap, (heap > s->max_heap_bytes) ? "!" : " ", s->max_heap_bytes,
+			arena, (arena > s->max_arena_bytes) ? "!" : " ", s->max_arena_bytes);
+	for(i = 0; i < field_count; i++)
+	{
+		printf("    %-24s byte %6u %10.2f us\n", s->fields[i].match, best_found[i].byte, best_found[i].ns / 1000.0);
+	}
+
+	if((check_time && ns_per_byte > max_ns_per_byte) || heap > s->max_heap_bytes || arena > s->max_arena_bytes)
+	{
+		failed = 1;
+	}
+	return failed;
+}
+
+static void _bench_usage(void)
+{
+	fprintf(stderr, "usage: bench [-s segment_size] [-r repetitions] [-t threshold_scale] [scenario ...]\n");
+	exit(2);
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t repetitions = BENCH_DEFAULT_REPETITIONS;
+	uint16_t segment_size = 0;
+	double threshold_scale = 1.0;
+	uint32_t failures = 0;
+	uint32_t runs = 0;
+	int first_name = argc;
+	int i;
+	uint8_t s;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(argv[i][0] != '-')
+		{
+			first_name = i;
+			break;
+		}
+		if(i + 1 == argc)
+		{
+			_bench_usage();
+		}
+		if(strcmp(argv[i], "-s") == 0)
+		{
+			segment_size = (uint16_t)atoi(argv[++i]);
+			if(segment_size == 0)
+			{
+				_bench_usage();
+			}
+		}
+		else if(strcmp(argv[i], "-r") == 0)
+		{
+			repetitions = (uint32_t)atol(argv[++i]);
+			if(repetitions == 0)
+			{
+				_bench_usage();
+			}
+		}
+		else if(strcmp(argv[i], "-t") == 0)
+		{
+			threshold_scale = atof(argv[++i]);
+			if(threshold_scale <= 0)
+			{
+				_bench_usage();
+			}
+		}
+		else
+		{
+			_bench_usage();
+		}
+	}
+
+	printf("%-18s %6s %5s %8s %8s %6s %7s %6s %7s\n", "scenario", "bytes", "seg", "ns/byte", "(max)",
+			"heap", "(max)", "arena", "(max)");
+	for(s = 0; s < BENCH_SCENARIO_COUNT; s++)
+	{
+		const BENCH_SCENARIO* scenario = &_bench_scenarios[s];
+
+		if(first_name < argc)
+		{
+			for(i = first_name; i < argc; i++)
+			{
+				if(strcmp(argv[i], scenario->name) == 0)
+				{
+					break;
+				}
+			}
+			if(i == argc)
+			{
+				continue;
+			}
+		}
+		failures += _bench_run(s, scenario, (segment_size != 0) ? segment_size : scenario->segment_size,
+								repetitions, threshold_scale, segment_size == 0);
+		runs++;
+	}
+
+	if(runs == 0)
+	{
+		fprintf(stderr, "bench: no such scenario\n");
+		return 2;
+	}
+	if(segment_size != 0)
+	{
+		printf("ns/byte thresholds not checked with -s\n");
+	}
+	printf("%u of %u scenarios within their thresholds\n", runs - failures, runs);
+	return (failures != 0) ? 1 : 0;
+}
@@ -0,0 +1,509 @@
+//ESP8266_TCP_GET HOST HARNESS
+//espconn STAND-INS ON REAL LOOPBACK TCP SOCKETS (SEE espconn_socket.h)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include "espconn_socket.h"
+
+typedef enum
+{
+	ESPCONN_SOCKET_IDLE,
+	ESPCONN_SOCKET_CONNECTING,
+	ESPCONN_SOCKET_CONNECTED
+} ESPCONN_SOCKET_STATE;
+
+typedef enum
+{
+	ESPCONN_SOCKET_CALLBACK_RECONNECT,
+	ESPCONN_SOCKET_CALLBACK_DISCONNECT
+} ESPCONN_SOCKET_CALLBACK_TYPE;
+
+typedef struct
+{
+	struct espconn* espconn;
+	int fd;
+	uint32_t generation; //SOCKETS OPENED FOR THE espconn. A NEW ONE MAY REUSE THE fd
+	ESPCONN_SOCKET_STATE state;
+	uint8_t secure; //CONNECTED WITH espconn_secure_connect
+	uint8_t held; //espconn_recv_hold
+	uint8_t sending; //DATA PASSED TO espconn_sent, sent_callback NOT CALLED YET
+	uint8_t out[ESPCONN_SOCKET_SEND_BUFFER];
+	uint16_t out_length;
+	uint16_t out_written;
+}ESPCONN_SOCKET_CONN;
+
+typedef struct
+{
+	struct espconn* espconn;
+	ESPCONN_SOCKET_CALLBACK_TYPE type;
+	sint8 err;
+}ESPCONN_SOCKET_CALLBACK;
+
+ESPCONN_SOCKET_STATS espconn_socket_stats;
+uint16_t (*espconn_socket_route)(struct espconn* espconn, uint32_t ip, int port);
+void (*espconn_socket_sent_hook)(struct espconn* espconn, uint8* data, uint16 length);
+
+static ESPCONN_SOCKET_CONN _espconn_socket_conns[ESPCONN_SOCKET_MAX_CONNS];
+static ESPCONN_SOCKET_CALLBACK _espconn_socket_callbacks[ESPCONN_SOCKET_MAX_CALLBACKS];
+static uint8_t _espconn_socket_callback_head;
+static uint8_t _espconn_socket_callback_count;
+static uint32_t _espconn_socket_source;
+
+static ESPCONN_SOCKET_CONN* _espconn_socket_find(struct espconn* espconn)
+{
+	//THE ENTRY OF AN espconn. A NEW ONE THE FIRST TIME IT IS SEEN
+	ESPCONN_SOCKET_CONN* free_conn = NULL;
+	int i;
+
+	for(i = 0; i < ESPCONN_SOCKET_MAX_CONNS; i++)
+	{
+		if(_espconn_socket_conns[i].espconn == espconn)
+		{
+			return &_espconn_socket_conns[i];
+		}
+		if(free_conn == NULL && _espconn_socket_conns[i].espconn == NULL)
+		{
+			free_conn = &_espconn_socket_conns[i];
+		}
+	}
+	if(free_conn == NULL)
+	{
+		fprintf(stderr, "espconn_socket: more than %d espconns\n", ESPCONN_SOCKET_MAX_CONNS);
+		abort();
+	}
+	free_conn->espconn = espconn;
+	free_conn->fd = -1;
+	return free_conn;
+}
+
+static void _espconn_socket_queue(struct espconn* espconn, ESPCONN_SOCKET_CALLBACK_TYPE type, sint8 err)
+{
+	ESPCONN_SOCKET_CALLBACK* cb;
+
+	if(_espconn_socket_callback_count == ESPCONN_SOCKET_MAX_CALLBACKS)
+	{
+		fprintf(stderr, "espconn_socket: more than %d callbacks queued\n", ESPCONN_SOCKET_MAX_CALLBACKS);
+		abort();
+	}
+	cb = &_espconn_socket_callbacks[(_espconn_socket_callback_head + _espconn_socket_callback_count) %
+										ESPCONN_SOCKET_MAX_CALLBACKS];
+	cb->espconn = espconn;
+	cb->type = type;
+	cb->err = err;
+	_espconn_socket_callback_count++;
+}
+
+static void _espconn_socket_close(ESPCONN_SOCKET_CONN* conn, uint8_t reset)
+{
+	//CLOSE THE SOCKET. A RESET SENDS RST INSTEAD OF FIN
+	struct linger linger = {1, 0};
+
+	if(conn->fd >= 0)
+	{
+		if(reset)
+		{
+			setsockopt(conn->fd, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+		}
+		close(conn->fd);
+		conn->fd = -1;
+		espconn_socket_stats.open--;
+	}
+	conn->state = ESPCONN_SOCKET_IDLE;
+	conn->held = 0;
+	conn->sending = 0;
+	conn->out_length = 0;
+	conn->out_written = 0;
+}
+
+static uint8_t _espconn_socket_api(ESPCONN_SOCKET_CONN* conn, uint8_t secure)
+{
+	//THE SECURE API ONLY ON A SECURE CONNECTION, THE PLAIN API ONLY ON A PLAIN ONE
+	if(conn->state != ESPCONN_SOCKET_IDLE && conn->secure != secure)
+	{
+		espconn_socket_stats.bad_secure++;
+		return 0;
+	}
+	return 1;
+}
+
+static void _espconn_socket_call(ESPCONN_SOCKET_CALLBACK* cb)
+{
+	struct espconn* espconn = cb->espconn;
+
+	if(cb->type == ESPCONN_SOCKET_CALLBACK_RECONNECT)
+	{
+		(*espconn->proto.tcp->reconnect_callback)(espconn, cb->err);
+	}
+	else
+	{
+		(*espconn->proto.tcp->disconnect_callback)(espconn);
+	}
+}
+
+//espconn API///////////////////////////////////////////
+
+static sint8 _espconn_socket_connect(struct espconn* espconn, uint8_t secure)
+{
+	ESPCONN_SOCKET_CONN* conn = _espconn_socket_find(espconn);
+	struct sockaddr_in source;
+	struct sockaddr_in target;
+	uint32_t ip;
+	int one = 1;
+	int i;
+
+	if(conn->state != ESPCONN_SOCKET_IDLE)
+	{
+		espconn_socket_stats.bad_connect++;
+		return ESPCONN_ISCONN;
+	}
+	for(i = 0; secure && i < ESPCONN_SOCKET_MAX_CONNS; i++)
+	{
+		if(_espconn_socket_conns[i].secure && _espconn_socket_conns[i].state != ESPCONN_SOCKET_IDLE)
+		{
+			//THE SDK TLS CLIENT HAS ROOM FOR ONE CONNECTION
+			espconn_socket_stats.bad_secure++;
+			return ESPCONN_ISCONN;
+		}
+	}
+	conn->secure = secure;
+
+	conn->fd = socket(AF_INET, SOCK_STREAM, 0);
+	if(conn->fd < 0)
+	{
+		perror("espconn_socket: socket");
+		abort();
+	}
+	espconn_socket_stats.open++;
+	conn->generation++;
+	fcntl(conn->fd, F_SETFL, O_NONBLOCK);
+	setsockopt(conn->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+	//EACH CONNECTION FROM ITS OWN 127.1.x.y, SO THE TIME_WAIT SOCKETS OF MILLIONS OF
+	//CYCLES DO NOT USE UP THE LOCAL PORTS
+	memset(&source, 0, sizeof(source));
+	source.sin_family = AF_INET;
+	source.sin_addr.s_addr = htonl(0x7f010001 + (_espconn_socket_source++ % 0xfffe));
+	bind(conn->fd, (struct sockaddr*)&source, sizeof(source));
+
+	memcpy(&ip, espconn->proto.tcp->remote_ip, 4);
+	memset(&target, 0, sizeof(target));
+	target.sin_family = AF_INET;
+	target.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	target.sin_port = htons(espconn_socket_route(espconn, ip, espconn->proto.tcp->remote_port));
+	conn->state = ESPCONN_SOCKET_CONNECTING;
+	espconn_socket_stats.connects++;
+	if(connect(conn->fd, (struct sockaddr*)&target, sizeof(target)) != 0 && errno != EINPROGRESS)
+	{
+		//REFUSED AT ONCE. THE SDK REPORTS IT FROM ITS OWN CONTEXT
+		_espconn_socket_close(conn, 0);
+		espconn_socket_stats.connect_failures++;
+		_espconn_socket_queue(espconn, ESPCONN_SOCKET_CALLBACK_RECONNECT, ESPCONN_CONN);
+	}
+	return ESPCONN_OK;
+}
+
+static sint8 _espconn_socket_disconnect(struct espconn* espconn, uint8_t secure)
+{
+	ESPCONN_SOCKET_CONN* conn = _espconn_socket_find(espconn);
+
+	if(!_espconn_socket_api(conn, secure))
+	{
+		return ESPCONN_ARG;
+	}
+	//THE SDK HAS NO SECURE ABORT. ITS SECURE DISCONNECT ALSO ENDS A HANDSHAKE IN PROGRESS
+	if(conn->state != ESPCONN_SOCKET_CONNECTED && !(secure && conn->state == ESPCONN_SOCKET_CONNECTING))
+	{
+		espconn_socket_stats.bad_disconnect++;
+		return ESPCONN_ARG;
+	}
+	_espconn_socket_close(conn, 0);
+	_espconn_socket_queue(espconn, ESPCONN_SOCKET_CALLBACK_DISCONNECT, 0);
+	return ESPCONN_OK;
+}
+
+sint8 espconn_abort(struct espconn* espconn)
+{
+	ESPCONN_SOCKET_CONN* conn = _espconn_socket_find(espconn);
+
+	if(!_espconn_socket_api(conn, 0))
+	{
+		return ESPCONN_ARG;
+	}
+	if(conn->state == ESPCONN_SOCKET_IDLE)
+	{
+		espconn_socket_stats.bad_abort++;
+		return ESPCONN_ARG;
+	}
+	_espconn_socket_close(conn, 1);
+	_espconn_socket_queue(espconn, ESPCONN_SOCKET_CALLBACK_DISCONNECT, 0);
+	return ESPCONN_OK;
+}
+
+static sint8 _espconn_socket_sent(struct espconn* espconn, uint8* psent, uint16 length, uint8_t secure)
+{
+	ESPCONN_SOCKET_CONN* conn = _espconn_socket_find(espconn);
+
+	if(!_espconn_socket_api(conn, secure))
+	{
+		return ESPCONN_ARG;
+	}
+	if(conn->state != ESPCONN_SOCKET_CONNECTED || length > ESPCONN_SOCKET_SEND_BUFFER)
+	{
+		espconn_socket_stats.bad_send++;
+		return ESPCONN_ARG;
+	}
+	if(conn->sending)
+	{
+		espconn_socket_stats.send_busy++;
+		return ESPCONN_MAXNUM;
+	}
+	if(espconn_socket_sent_hook != NULL)
+	{
+		(*espconn_socket_sent_hook)(espconn, psent, length);
+	}
+	//COPIED, AS THE SDK COPIES INTO ITS OWN BUFFERS
+	memcpy(conn->out, psent, length);
+	conn->out_length = length;
+	conn->out_written = 0;
+	conn->sending = 1;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_connect(struct espconn* espconn)
+{
+	return _espconn_socket_connect(espconn, 0);
+}
+
+sint8 espconn_disconnect(struct espconn* espconn)
+{
+	return _espconn_socket_disconnect(espconn, 0);
+}
+
+sint8 espconn_sent(struct espconn* espconn, uint8* psent, uint16 length)
+{
+	return _espconn_socket_sent(espconn, psent, length, 0);
+}
+
+uint32 espconn_port(void)
+{
+	static uint32 port = 49152;
+
+	return port++;
+}
+
+sint8 espconn_regist_connectcb(struct espconn* espconn, espconn_connect_callback connect_cb)
+{
+	espconn->proto.tcp->connect_callback = connect_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_disconcb(struct espconn* espconn, espconn_connect_callback discon_cb)
+{
+	espconn->proto.tcp->disconnect_callback = discon_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_reconcb(struct espconn* espconn, espconn_reconnect_callback recon_cb)
+{
+	espconn->proto.tcp->reconnect_callback = recon_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_recvcb(struct espconn* espconn, espconn_recv_callback recv_cb)
+{
+	espconn->recv_callback = recv_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_sentcb(struct espconn* espconn, espconn_sent_callback sent_cb)
+{
+	espconn->sent_callback = sent_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_recv_hold(struct espconn* pespconn)
+{
+	_espconn_socket_find(pespconn)->held = 1;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_recv_unhold(struct espconn* pespconn)
+{
+	_espconn_socket_find(pespconn)->held = 0;
+	return ESPCONN_OK;
+}
+
+err_t espconn_gethostbyname(struct espconn* pespconn, const char* hostname, ip_addr_t* addr, dns_found_callback found)
+{
+	//EVERY NAME IS 10.0.0.1, KNOWN AT ONCE
+	IP4_ADDR(addr, 10, 0, 0, 1);
+	return ESPCONN_OK;
+}
+
+void espconn_dns_setserver(char numdns, ip_addr_t* dnsserver)
+{
+}
+
+sint8 espconn_secure_connect(struct espconn* espconn)
+{
+	return _espconn_socket_connect(espconn, 1);
+}
+
+sint8 espconn_secure_disconnect(struct espconn* espconn)
+{
+	return _espconn_socket_disconnect(espconn, 1);
+}
+
+sint8 espconn_secure_sent(struct espconn* espconn, uint8* psent, uint16 length)
+{
+	return _espconn_socket_sent(espconn, psent, length, 1);
+}
+
+bool espconn_secure_set_size(uint8 level, uint16 size)
+{
+	return true;
+}
+
+//POLLING///////////////////////////////////////////////
+
+static uint32_t _espconn_socket_service(ESPCONN_SOCKET_CONN* conn, short revents)
+{
+	//HANDLE WHAT poll FOUND ON ONE SOCKET. RETURNS THE NUMBER OF EVENTS
+	char buffer[ESPCONN_SOCKET_SEGMENT];
+	struct espconn* espconn = conn->espconn;
+	socklen_t length = sizeof(int);
+	ssize_t n;
+	int err = 0;
+
+	if(conn->state == ESPCONN_SOCKET_CONNECTING)
+	{
+		getsockopt(conn->fd, SOL_SOCKET, SO_ERROR, &err, &length);
+		if(err != 0)
+		{
+			_espconn_socket_close(conn, 0);
+			espconn_socket_stats.connect_failures++;
+			(*espconn->proto.tcp->reconnect_callback)(espconn, ESPCONN_CONN);
+			return 1;
+		}
+		conn->state = ESPCONN_SOCKET_CONNECTED;
+		espconn_socket_stats.handshakes += conn->secure;
+		(*espconn->proto.tcp->connect_callback)(espconn);
+		return 1;
+	}
+
+	//SENT DATA FIRST. A REPLY CAN NOT COME BEFORE ITS REQUEST HAS GONE
+	if(conn->sending && (revents & POLLOUT))
+	{
+		if(conn->out_written < conn->out_length)
+		{
+			n = send(conn->fd, conn->out + conn->out_written, conn->out_length - conn->out_written, MSG_NOSIGNAL);
+			if(n > 0)
+			{
+				conn->out_written += n;
+				espconn_socket_stats.bytes_sent += n;
+			}
+		}
+		if(conn->out_written == conn->out_length)
+		{
+			conn->sending = 0;
+			if(espconn->sent_callback != NULL)
+			{
+				(*espconn->sent_callback)(espconn);
+			}
+			return 1;
+		}
+	}
+
+	if(!conn->held && (revents & (POLLIN | POLLHUP | POLLERR)))
+	{
+		n = recv(conn->fd, buffer, sizeof(buffer), 0);
+		if(n > 0)
+		{
+			espconn_socket_stats.bytes_received += n;
+			(*espconn->recv_callback)(espconn, buffer, (unsigned short)n);
+			return 1;
+		}
+		if(n == 0)
+		{
+			_espconn_socket_close(conn, 0);
+			(*espconn->proto.tcp->disconnect_callback)(espconn);
+			return 1;
+		}
+		if(errno != EAGAIN && errno != EWOULDBLOCK)
+		{
+			_espconn_socket_close(conn, 0);
+			espconn_socket_stats.resets++;
+			(*espconn->proto.tcp->reconnect_callback)(espconn, ESPCONN_RST);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+uint32_t espconn_socket_poll(void)
+{
+	//RUN THE QUEUED CALLBACKS AND SERVICE EVERY SOCKET THAT IS READY, WITHOUT WAITING
+	//RETURNS THE NUMBER OF CALLBACKS MADE. 0 = NOTHING HAPPENED
+	struct pollfd fds[ESPCONN_SOCKET_MAX_CONNS];
+	ESPCONN_SOCKET_CONN* conns[ESPCONN_SOCKET_MAX_CONNS];
+	uint32_t generations[ESPCONN_SOCKET_MAX_CONNS];
+	ESPCONN_SOCKET_CALLBACK cb;
+	uint32_t events = 0;
+	uint8_t queued = _espconn_socket_callback_count;
+	int count = 0;
+	int i;
+
+	//ONLY THOSE QUEUED BEFORE THIS POLL. CALLBACKS QUEUE MORE
+	while(queued-- != 0)
+	{
+		cb = _espconn_socket_callbacks[_espconn_socket_callback_head];
+		_espconn_socket_callback_head = (_espconn_socket_callback_head + 1) % ESPCONN_SOCKET_MAX_CALLBACKS;
+		_espconn_socket_callback_count--;
+		_espconn_socket_call(&cb);
+		events++;
+	}
+
+	for(i = 0; i < ESPCONN_SOCKET_MAX_CONNS; i++)
+	{
+		ESPCONN_SOCKET_CONN* conn = &_espconn_socket_conns[i];
+
+		if(conn->fd < 0 || conn->espconn == NULL)
+		{
+			continue;
+		}
+		fds[count].fd = conn->fd;
+		fds[count].events = (conn->state == ESPCONN_SOCKET_CONNECTING || conn->sending) ? POLLOUT : 0;
+		if(conn->state == ESPCONN_SOCKET_CONNECTED && !conn->held)
+		{
+			fds[count].events |= POLLIN;
+		}
+		fds[count].revents = 0;
+		generations[count] = conn->generation;
+		conns[count++] = conn;
+	}
+	if(count == 0 || poll(fds, count, 0) <= 0)
+	{
+		return events;
+	}
+
+	for(i = 0; i < count; i++)
+	{
+		//A CALLBACK OF AN EARLIER SOCKET MAY HAVE CLOSED OR REOPENED THIS ONE
+		if(fds[i].revents == 0 || conns[i]->fd < 0 || conns[i]->generation != generations[i])
+		{
+			continue;
+		}
+		events += _espconn_socket_service(conns[i], fds[i].revents);
+	}
+	return events;
+}
@@ -0,0 +1,65 @@
+//ESP8266_TCP_GET HOST HARNESS
+//espconn STAND-INS ON REAL LOOPBACK TCP SOCKETS
+//
+//EVERY espconn GETS A NONBLOCKING SOCKET ON espconn_connect. espconn_socket_poll LOOKS
+//AT THE SOCKETS WITHOUT WAITING AND CALLS THE CALLBACKS THE LIBRARY REGISTERED, THE WAY
+//THE SDK DOES: LATER, NEVER FROM INSIDE THE espconn CALL THAT CAUSED THEM
+//	CONNECTED						connect_callback
+//	CONNECT FAILED					reconnect_callback(ESPCONN_CONN)
+//	DATA (UP TO ONE 1460 BYTE READ)	recv_callback
+//	ALL SENT DATA WRITTEN			sent_callback
+//	PEER CLOSED						disconnect_callback
+//	PEER RESET						reconnect_callback(ESPCONN_RST)
+//	espconn_disconnect / _abort		disconnect_callback
+//
+//A CALL THE SDK WOULD REFUSE (SENDING ON, CLOSING OR ABORTING AN espconn THAT IS NOT
+//CONNECTED, CONNECTING ONE THAT IS BUSY, SENDING BEFORE THE sent_callback) IS COUNTED
+//IN ESPCONN_SOCKET_STATS AND FAILS AS ON THE DEVICE
+//
+//espconn_secure_* STAND IN FOR THE SDK TLS CLIENT. NO TLS IS SPOKEN: THE SDK ENCRYPTS
+//BELOW THE espconn API, SO THE LIBRARY NEVER SEES A TLS RECORD. WHAT IS KEPT ARE THE
+//RULES OF THE SECURE API: ONE SECURE CONNECTION AT A TIME, AND NO PLAIN CALL ON A
+//SECURE espconn OR SECURE CALL ON A PLAIN ONE. espconn_secure_disconnect ALSO ENDS A
+//CONNECT IN PROGRESS (THERE IS NO SECURE ABORT). EVERY SECURE CONNECT THAT SUCCEEDS
+//COUNTS AS A FULL HANDSHAKE
+
+#ifndef _ESPCONN_SOCKET_H_
+#define _ESPCONN_SOCKET_H_
+
+#include "espconn.h"
+
+#define ESPCONN_SOCKET_MAX_CONNS		16
+#define ESPCONN_SOCKET_MAX_CALLBACKS	32
+#define ESPCONN_SOCKET_SEGMENT			1460
+#define ESPCONN_SOCKET_SEND_BUFFER		4096
+
+typedef struct
+{
+	uint32_t connects;
+	uint32_t connect_failures;
+	uint32_t resets;
+	uint32_t bytes_received;
+	uint32_t bytes_sent;
+	uint32_t open; //SOCKETS OPEN NOW
+	uint32_t handshakes; //SECURE CONNECTS THAT SUCCEEDED
+
+	//CALLS THE SDK WOULD REFUSE
+	uint32_t bad_connect;
+	uint32_t bad_send;
+	uint32_t bad_disconnect;
+	uint32_t bad_abort;
+	uint32_t send_busy;
+	uint32_t bad_secure; //A SECOND SECURE CONNECTION, OR THE WRONG API FOR THE espconn
+}ESPCONN_SOCKET_STATS;
+
+extern ESPCONN_SOCKET_STATS espconn_socket_stats;
+
+//TCP PORT ON 127.0.0.1 AN espconn_connect TO ip:port GOES TO. SET BY THE HARNESS
+extern uint16_t (*espconn_socket_route)(struct espconn* espconn, uint32_t ip, int port);
+
+//CALLED WITH EVERY BUFFER PASSED TO espconn_sent. OPTIONAL
+extern void (*espconn_socket_sent_hook)(struct espconn* espconn, uint8* data, uint16 length);
+
+uint32_t espconn_socket_poll(void);
+
+#endif
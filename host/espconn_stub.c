@@ -0,0 +1,112 @@
+//ESP8266_TCP_GET HOST HARNESS
+//RECORDING espconn STAND-INS (SEE espconn_stub.h)
+
+#include "espconn_stub.h"
+
+ESPCONN_STUB espconn_stub;
+uint32_t espconn_stub_host_ip = 0x0100000a;
+
+sint8 espconn_connect(struct espconn* espconn)
+{
+	espconn_stub.connecting = espconn;
+	espconn_stub.connects++;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_disconnect(struct espconn* espconn)
+{
+	espconn_stub.disconnects++;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_abort(struct espconn* espconn)
+{
+	espconn_stub.aborts++;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_sent(struct espconn* espconn, uint8* psent, uint16 length)
+{
+	espconn_stub.sends++;
+	espconn_stub.bytes_sent += length;
+	return ESPCONN_OK;
+}
+
+uint32 espconn_port(void)
+{
+	static uint32 port = 49152;
+
+	return port++;
+}
+
+sint8 espconn_regist_connectcb(struct espconn* espconn, espconn_connect_callback connect_cb)
+{
+	espconn->proto.tcp->connect_callback = connect_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_disconcb(struct espconn* espconn, espconn_connect_callback discon_cb)
+{
+	espconn->proto.tcp->disconnect_callback = discon_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_reconcb(struct espconn* espconn, espconn_reconnect_callback recon_cb)
+{
+	espconn->proto.tcp->reconnect_callback = recon_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_recvcb(struct espconn* espconn, espconn_recv_callback recv_cb)
+{
+	espconn->recv_callback = recv_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_regist_sentcb(struct espconn* espconn, espconn_sent_callback sent_cb)
+{
+	espconn->sent_callback = sent_cb;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_recv_hold(struct espconn* pespconn)
+{
+	espconn_stub.holds++;
+	return ESPCONN_OK;
+}
+
+sint8 espconn_recv_unhold(struct espconn* pespconn)
+{
+	espconn_stub.unholds++;
+	return ESPCONN_OK;
+}
+
+err_t espconn_gethostbyname(struct espconn* pespconn, const char* hostname, ip_addr_t* addr, dns_found_callback found)
+{
+	addr->addr = espconn_stub_host_ip;
+	return ESPCONN_OK;
+}
+
+void espconn_dns_setserver(char numdns, ip_addr_t* dnsserver)
+{
+}
+
+sint8 espconn_secure_connect(struct espconn* espconn)
+{
+	return espconn_connect(espconn);
+}
+
+sint8 espconn_secure_disconnect(struct espconn* espconn)
+{
+	return espconn_disconnect(espconn);
+}
+
+sint8 espconn_secure_sent(struct espconn* espconn, uint8* psent, uint16 length)
+{
+	return espconn_sent(espconn, psent, length);
+}
+
+bool espconn_secure_set_size(uint8 level, uint16 size)
+{
+	return true;
+}
@@ -0,0 +1,27 @@
+//ESP8266_TCP_GET HOST HARNESS
+//espconn STAND-INS THAT PUT NOTHING ON THE WIRE. THEY RECORD WHAT THE LIBRARY ASKED
+//FOR, AND THE HARNESS PLAYS THE SDK'S PART BY CALLING THE LIBRARY CALLBACKS ITSELF
+
+#ifndef _ESPCONN_STUB_H_
+#define _ESPCONN_STUB_H_
+
+#include "espconn.h"
+
+typedef struct
+{
+	struct espconn* connecting; //LAST espconn PASSED TO espconn_connect. CLEARED BY THE HARNESS
+	uint32_t connects;
+	uint32_t disconnects;
+	uint32_t aborts;
+	uint32_t sends;
+	uint32_t bytes_sent;
+	uint32_t holds;
+	uint32_t unholds;
+}ESPCONN_STUB;
+
+extern ESPCONN_STUB espconn_stub;
+
+//ADDRESS espconn_gethostbyname ANSWERS WITH AT ONCE (DEFAULT 10.0.0.1)
+extern uint32_t espconn_stub_host_ip;
+
+#endif
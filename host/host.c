@@ -0,0 +1,343 @@
+//ESP8266_TCP_GET HOST HARNESS
+//VIRTUAL CLOCK, os_timer, system_os_task, os_zalloc, RTC MEMORY AND os_random STAND-INS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "osapi.h"
+#include "mem.h"
+#include "ip_addr.h"
+#include "user_interface.h"
+#include "host.h"
+
+//ARMED TIMERS. THE DUE TIMES ARE 64 BIT, SO THEY ARE KEPT HERE AND NOT IN os_timer_t
+typedef struct
+{
+	volatile os_timer_t* timer;
+	uint64_t due_us;
+	uint32_t period_ms;
+}HOST_TIMER;
+
+//ONE TASK AND ITS EVENT QUEUE PER PRIORITY, AS system_os_task SETS THEM UP
+typedef struct
+{
+	os_task_t task;
+	os_event_t* queue;
+	uint8_t length;
+	uint8_t head;
+	uint8_t count;
+}HOST_TASK;
+
+//RTC MEMORY. THE USER AREA IS BLOCKS 64 TO 191 OF 4 BYTES
+#define HOST_RTC_FIRST_USER_BLOCK	64
+#define HOST_RTC_BLOCKS				192
+
+HOST_HEAP host_heap;
+
+static uint64_t _host_time_us;
+static HOST_TIMER _host_timers[HOST_MAX_TIMERS];
+static uint8_t _host_timer_count;
+static HOST_TASK _host_tasks[HOST_TASK_PRIORITIES];
+static uint8_t _host_rtc[HOST_RTC_BLOCKS * 4];
+static uint32_t _host_random_state = 1;
+
+//HEAP//////////////////////////////////////////////////
+
+void* os_zalloc(size_t size)
+{
+	//SIZE IS KEPT IN FRONT OF THE BLOCK FOR os_free
+	size_t* block = (size_t*)calloc(1, sizeof(size_t) * 2 + size);
+
+	if(block == NULL)
+	{
+		return NULL;
+	}
+	block[0] = size;
+	host_heap.bytes += size;
+	host_heap.blocks++;
+	host_heap.calls++;
+	if(host_heap.bytes > host_heap.peak)
+	{
+		host_heap.peak = host_heap.bytes;
+	}
+	return block + 2;
+}
+
+void os_free(void* p)
+{
+	size_t* block = (size_t*)p;
+
+	if(block == NULL)
+	{
+		return;
+	}
+	block -= 2;
+	host_heap.bytes -= block[0];
+	host_heap.blocks--;
+	free(block);
+}
+
+void host_heap_mark(void)
+{
+	//START COUNTING PEAK AND CALLS FROM HERE
+	host_heap.peak = host_heap.bytes;
+	host_heap.calls = 0;
+}
+
+//VIRTUAL CLOCK AND TIMERS//////////////////////////////
+
+uint64_t host_time_us(void)
+{
+	return _host_time_us;
+}
+
+void host_set_time_us(uint64_t time_us)
+{
+	//FOR THE START OF A RUN (FOR EXAMPLE JUST BEFORE THE 32 BIT WRAP), OR TO MOVE THE
+	//CLOCK PAST A DUE TIMER SO IT FIRES LATE, AS AN os_timer ON A BUSY DEVICE DOES
+	_host_time_us = time_us;
+}
+
+uint32_t system_get_time(void)
+{
+	return (uint32_t)_host_time_us;
+}
+
+static int _host_timer_find(volatile os_timer_t* ptimer)
+{
+	int i;
+
+	for(i = 0; i < _host_timer_count; i++)
+	{
+		if(_host_timers[i].timer == ptimer)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+void os_timer_setfn(volatile os_timer_t* ptimer, os_timer_func_t* pfunction, void* parg)
+{
+	ptimer->timer_func = pfunction;
+	ptimer->timer_arg = parg;
+}
+
+void os_timer_disarm(volatile os_timer_t* ptimer)
+{
+	int i = _host_timer_find(ptimer);
+
+	if(i >= 0)
+	{
+		_host_timers[i] = _host_timers[--_host_timer_count];
+	}
+}
+
+void os_timer_arm(volatile os_timer_t* ptimer, uint32_t milliseconds, bool repeat_flag)
+{
+	//RE-ARMING AN ARMED TIMER MOVES IT, AS ON THE DEVICE
+	int i = _host_timer_find(ptimer);
+
+	if(i < 0)
+	{
+		if(_host_timer_count == HOST_MAX_TIMERS)
+		{
+			fprintf(stderr, "host: more than %d os_timers armed\n", HOST_MAX_TIMERS);
+			abort();
+		}
+		i = _host_timer_count++;
+	}
+	_host_timers[i].timer = ptimer;
+	_host_timers[i].due_us = _host_time_us + (uint64_t)milliseconds * 1000;
+	_host_timers[i].period_ms = repeat_flag ? milliseconds : 0;
+	ptimer->timer_expire = (uint32_t)_host_timers[i].due_us;
+	ptimer->timer_period = _host_timers[i].period_ms;
+}
+
+uint8_t host_next_timer(uint64_t* due_us)
+{
+	//EARLIEST ARMED TIMER. 0 IF NONE IS ARMED
+	int i;
+
+	if(_host_timer_count == 0)
+	{
+		return 0;
+	}
+	*due_us = _host_timers[0].due_us;
+	for(i = 1; i < _host_timer_count; i++)
+	{
+		if(_host_timers[i].due_us < *due_us)
+		{
+			*due_us = _host_timers[i].due_us;
+		}
+	}
+	return 1;
+}
+
+static void _host_fire_timer(uint64_t due_us)
+{
+	//FIRE THE FIRST TIMER DUE AT due_us
+	int i;
+	volatile os_timer_t* ptimer;
+
+	for(i = 0; i < _host_timer_count; i++)
+	{
+		if(_host_timers[i].due_us == due_us)
+		{
+			break;
+		}
+	}
+	ptimer = _host_timers[i].timer;
+	if(_host_timers[i].period_ms != 0)
+	{
+		_host_timers[i].due_us += (uint64_t)_host_timers[i].period_ms * 1000;
+	}
+	else
+	{
+		_host_timers[i] = _host_timers[--_host_timer_count];
+	}
+	(*ptimer->timer_func)(ptimer->timer_arg);
+}
+
+void host_run_until(uint64_t time_us)
+{
+	//RUN THE POSTED TASKS AND EVERY TIMER DUE UP TO time_us, IN ORDER
+	uint64_t due_us;
+
+	host_run_tasks();
+	while(host_next_timer(&due_us) && due_us <= time_us)
+	{
+		if(due_us > _host_time_us)
+		{
+			_host_time_us = due_us;
+		}
+		_host_fire_timer(due_us);
+		host_run_tasks();
+	}
+	if(time_us > _host_time_us)
+	{
+		_host_time_us = time_us;
+	}
+}
+
+void host_run_for(uint32_t ms)
+{
+	host_run_until(_host_time_us + (uint64_t)ms * 1000);
+}
+
+//TASKS/////////////////////////////////////////////////
+
+bool system_os_task(os_task_t task, uint8_t prio, os_event_t* queue, uint8_t qlen)
+{
+	if(prio >= HOST_TASK_PRIORITIES || queue == NULL || qlen == 0)
+	{
+		return false;
+	}
+	_host_tasks[prio].task = task;
+	_host_tasks[prio].queue = queue;
+	_host_tasks[prio].length = qlen;
+	_host_tasks[prio].head = 0;
+	_host_tasks[prio].count = 0;
+	return true;
+}
+
+bool system_os_post(uint8_t prio, os_signal_t sig, os_param_t par)
+{
+	//FAILS WHEN THE QUEUE OF THE PRIORITY IS FULL, AS ON THE DEVICE
+	HOST_TASK* t;
+
+	if(prio >= HOST_TASK_PRIORITIES || _host_tasks[prio].task == NULL)
+	{
+		return false;
+	}
+	t = &_host_tasks[prio];
+	if(t->count == t->length)
+	{
+		return false;
+	}
+	t->queue[(t->head + t->count) % t->length].sig = sig;
+	t->queue[(t->head + t->count) % t->length].par = par;
+	t->count++;
+	return true;
+}
+
+uint8_t host_run_tasks(void)
+{
+	//RUN POSTED EVENTS, HIGHEST PRIORITY FIRST, UNTIL ALL QUEUES ARE EMPTY
+	//RETURNS 1 IF ANY EVENT RAN
+	uint8_t ran = 0;
+	int prio;
+	os_event_t e;
+
+	for(prio = HOST_TASK_PRIORITIES - 1; prio >= 0; prio--)
+	{
+		HOST_TASK* t = &_host_tasks[prio];
+
+		if(t->count != 0)
+		{
+			e = t->queue[t->head];
+			t->head = (t->head + 1) % t->length;
+			t->count--;
+			(*t->task)(&e);
+			ran = 1;
+			prio = HOST_TASK_PRIORITIES;
+		}
+	}
+	return ran;
+}
+
+//RTC MEMORY////////////////////////////////////////////
+
+bool system_rtc_mem_read(uint8_t src_addr, void* des_addr, uint16_t load_size)
+{
+	if(src_addr < HOST_RTC_FIRST_USER_BLOCK || (uint32_t)src_addr * 4 + load_size > sizeof(_host_rtc))
+	{
+		return false;
+	}
+	memcpy(des_addr, &_host_rtc[src_addr * 4], load_size);
+	return true;
+}
+
+bool system_rtc_mem_write(uint8_t des_addr, const void* src_addr, uint16_t save_size)
+{
+	if(des_addr < HOST_RTC_FIRST_USER_BLOCK || (uint32_t)des_addr * 4 + save_size > sizeof(_host_rtc))
+	{
+		return false;
+	}
+	memcpy(&_host_rtc[des_addr * 4], src_addr, save_size);
+	return true;
+}
+
+//MISC//////////////////////////////////////////////////
+
+void host_seed(uint32_t seed)
+{
+	_host_random_state = (seed != 0) ? seed : 1;
+}
+
+uint32_t host_random(void)
+{
+	//XORSHIFT32. THE SAME SEED GIVES THE SAME RUN ON EVERY HOST
+	_host_random_state ^= _host_random_state << 13;
+	_host_random_state ^= _host_random_state >> 17;
+	_host_random_state ^= _host_random_state << 5;
+	return _host_random_state;
+}
+
+unsigned long os_random(void)
+{
+	return host_random();
+}
+
+uint32_t ipaddr_addr(const char* cp)
+{
+	unsigned int a, b, c, d;
+	char end;
+
+	if(sscanf(cp, "%u.%u.%u.%u%c", &a, &b, &c, &d, &end) != 4 || a > 255 || b > 255 || c > 255 || d > 255)
+	{
+		return IPADDR_NONE;
+	}
+	return a | (b << 8) | (c << 16) | ((uint32_t)d << 24);
+}
@@ -0,0 +1,43 @@
+//ESP8266_TCP_GET HOST HARNESS
+//SDK STAND-INS SHARED BY THE HOST PROGRAMS (bench, wheel_test, soak)
+//
+//TIME IS VIRTUAL. IT ONLY MOVES WHEN A HARNESS CALLS host_run_until / host_run_for,
+//WHICH FIRE THE ARMED os_timers AND RUN THE POSTED TASKS IN ORDER. system_get_time
+//RETURNS THE LOW 32 BITS OF THE CLOCK, SO LONG RUNS CROSS ITS WRAP AS A DEVICE DOES
+//
+//THE espconn FUNCTIONS ARE NOT HERE. EACH HARNESS LINKS THE SET IT NEEDS:
+//espconn_stub.c (NOTHING ON THE WIRE) OR espconn_socket.c (LOOPBACK SOCKETS)
+
+#ifndef _HOST_H_
+#define _HOST_H_
+
+#include "c_types.h"
+#include "os_type.h"
+
+#define HOST_MAX_TIMERS			16
+#define HOST_TASK_PRIORITIES	3
+
+//os_zalloc / os_free ACCOUNTING
+typedef struct
+{
+	uint32_t bytes; //BYTES ALLOCATED NOW
+	uint32_t peak; //HIGHEST bytes SINCE THE LAST host_heap_mark
+	uint32_t blocks; //BLOCKS ALLOCATED NOW
+	uint32_t calls; //os_zalloc CALLS SINCE THE LAST host_heap_mark
+}HOST_HEAP;
+
+extern HOST_HEAP host_heap;
+
+void host_heap_mark(void);
+
+uint64_t host_time_us(void);
+void host_set_time_us(uint64_t time_us);
+uint8_t host_next_timer(uint64_t* due_us);
+uint8_t host_run_tasks(void);
+void host_run_until(uint64_t time_us);
+void host_run_for(uint32_t ms);
+
+void host_seed(uint32_t seed);
+uint32_t host_random(void);
+
+#endif
@@ -0,0 +1,23 @@
+//HOST STAND-IN FOR THE ESP8266 NONOS SDK c_types.h
+//ONLY WHAT ESP8266_TCP_GET.c USES
+
+#ifndef _HOST_C_TYPES_H_
+#define _HOST_C_TYPES_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef int8_t sint8;
+typedef int16_t sint16;
+typedef int32_t sint32;
+
+//FLASH / RODATA PLACEMENT MEANS NOTHING ON A HOST
+#define ICACHE_FLASH_ATTR
+#define ICACHE_RODATA_ATTR
+#define LOCAL static
+
+#endif
@@ -0,0 +1,110 @@
+//HOST STAND-IN FOR THE ESP8266 NONOS SDK espconn.h
+//THE FUNCTIONS ARE IMPLEMENTED PER HARNESS (espconn_stub.c, espconn_socket.c)
+
+#ifndef _HOST_ESPCONN_H_
+#define _HOST_ESPCONN_H_
+
+#include "c_types.h"
+#include "ip_addr.h"
+
+typedef sint8 err_t;
+
+typedef void (*espconn_connect_callback)(void* arg);
+typedef void (*espconn_reconnect_callback)(void* arg, sint8 err);
+typedef void (*espconn_recv_callback)(void* arg, char* pdata, unsigned short len);
+typedef void (*espconn_sent_callback)(void* arg);
+typedef void (*dns_found_callback)(const char* name, ip_addr_t* ipaddr, void* callback_arg);
+
+#define ESPCONN_OK			0
+#define ESPCONN_MEM			-1
+#define ESPCONN_TIMEOUT		-3
+#define ESPCONN_RTE			-4
+#define ESPCONN_INPROGRESS	-5
+#define ESPCONN_MAXNUM		-7
+#define ESPCONN_ABRT		-8
+#define ESPCONN_RST			-9
+#define ESPCONN_CLSD		-10
+#define ESPCONN_CONN		-11
+#define ESPCONN_ARG			-12
+#define ESPCONN_IF			-14
+#define ESPCONN_ISCONN		-15
+
+#define ESPCONN_CLIENT		1
+
+enum espconn_type
+{
+	ESPCONN_INVALID = 0,
+	ESPCONN_TCP = 0x10,
+	ESPCONN_UDP = 0x20
+};
+
+enum espconn_state
+{
+	ESPCONN_NONE,
+	ESPCONN_WAIT,
+	ESPCONN_LISTEN,
+	ESPCONN_CONNECT,
+	ESPCONN_WRITE,
+	ESPCONN_READ,
+	ESPCONN_CLOSE
+};
+
+typedef struct _esp_tcp
+{
+	int remote_port;
+	int local_port;
+	uint8 local_ip[4];
+	uint8 remote_ip[4];
+	espconn_connect_callback connect_callback;
+	espconn_reconnect_callback reconnect_callback;
+	espconn_connect_callback disconnect_callback;
+	espconn_connect_callback write_finish_fn;
+}esp_tcp;
+
+typedef struct _esp_udp
+{
+	int remote_port;
+	int local_port;
+	uint8 local_ip[4];
+	uint8 remote_ip[4];
+}esp_udp;
+
+struct espconn
+{
+	enum espconn_type type;
+	enum espconn_state state;
+	union
+	{
+		esp_tcp* tcp;
+		esp_udp* udp;
+	}proto;
+	espconn_recv_callback recv_callback;
+	espconn_sent_callback sent_callback;
+	uint8 link_cnt;
+	void* reverse;
+};
+
+sint8 espconn_connect(struct espconn* espconn);
+sint8 espconn_disconnect(struct espconn* espconn);
+sint8 espconn_abort(struct espconn* espconn);
+sint8 espconn_sent(struct espconn* espconn, uint8* psent, uint16 length);
+uint32 espconn_port(void);
+
+sint8 espconn_regist_connectcb(struct espconn* espconn, espconn_connect_callback connect_cb);
+sint8 espconn_regist_disconcb(struct espconn* espconn, espconn_connect_callback discon_cb);
+sint8 espconn_regist_reconcb(struct espconn* espconn, espconn_reconnect_callback recon_cb);
+sint8 espconn_regist_recvcb(struct espconn* espconn, espconn_recv_callback recv_cb);
+sint8 espconn_regist_sentcb(struct espconn* espconn, espconn_sent_callback sent_cb);
+
+sint8 espconn_recv_hold(struct espconn* pespconn);
+sint8 espconn_recv_unhold(struct espconn* pespconn);
+
+err_t espconn_gethostbyname(struct espconn* pespconn, const char* hostname, ip_addr_t* addr, dns_found_callback found);
+void espconn_dns_setserver(char numdns, ip_addr_t* dnsserver);
+
+sint8 espconn_secure_connect(struct espconn* espconn);
+sint8 espconn_secure_disconnect(struct espconn* espconn);
+sint8 espconn_secure_sent(struct espconn* espconn, uint8* psent, uint16 length);
+bool espconn_secure_set_size(uint8 level, uint16 size);
+
+#endif
@@ -0,0 +1,9 @@
+//HOST STAND-IN FOR THE ESP8266 NONOS SDK ets_sys.h
+
+#ifndef _HOST_ETS_SYS_H_
+#define _HOST_ETS_SYS_H_
+
+#include "c_types.h"
+#include "os_type.h"
+
+#endif
@@ -0,0 +1,21 @@
+//HOST STAND-IN FOR THE lwip ip_addr.h OF THE ESP8266 NONOS SDK
+
+#ifndef _HOST_IP_ADDR_H_
+#define _HOST_IP_ADDR_H_
+
+#include "c_types.h"
+
+typedef struct ip_addr
+{
+	uint32_t addr;
+}ip_addr_t;
+
+#define IP4_ADDR(ipaddr, a, b, c, d) \
+	(ipaddr)->addr = ((uint32_t)((d) & 0xff) << 24) | ((uint32_t)((c) & 0xff) << 16) | \
+						((uint32_t)((b) & 0xff) << 8) | (uint32_t)((a) & 0xff)
+
+#define IPADDR_NONE		((uint32_t)0xffffffffUL)
+
+uint32_t ipaddr_addr(const char* cp);
+
+#endif
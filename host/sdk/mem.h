@@ -0,0 +1,12 @@
+//HOST STAND-IN FOR THE ESP8266 NONOS SDK mem.h
+//ALLOCATIONS ARE COUNTED BY host.c (HOST_HEAP)
+
+#ifndef _HOST_MEM_H_
+#define _HOST_MEM_H_
+
+#include "c_types.h"
+
+void* os_zalloc(size_t size);
+void os_free(void* p);
+
+#endif
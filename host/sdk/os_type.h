@@ -0,0 +1,31 @@
+//HOST STAND-IN FOR THE ESP8266 NONOS SDK os_type.h
+//SAME LAYOUT AS THE SDK. THE HOST TIMER LIST (host.c) KEEPS ITS OWN DUE TIMES
+
+#ifndef _HOST_OS_TYPE_H_
+#define _HOST_OS_TYPE_H_
+
+#include "c_types.h"
+
+typedef uint32_t os_signal_t;
+typedef uint32_t os_param_t;
+
+typedef struct
+{
+	os_signal_t sig;
+	os_param_t par;
+}os_event_t;
+
+typedef void (*os_task_t)(os_event_t* e);
+
+typedef void os_timer_func_t(void* timer_arg);
+
+typedef struct _os_timer_t
+{
+	struct _os_timer_t* timer_next;
+	uint32_t timer_expire;
+	uint32_t timer_period;
+	os_timer_func_t* timer_func;
+	void* timer_arg;
+}os_timer_t;
+
+#endif
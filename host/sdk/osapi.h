@@ -0,0 +1,33 @@
+//HOST STAND-IN FOR THE ESP8266 NONOS SDK osapi.h
+//THE os_timer FUNCTIONS ARE IMPLEMENTED ON THE VIRTUAL CLOCK IN host.c
+
+#ifndef _HOST_OSAPI_H_
+#define _HOST_OSAPI_H_
+
+#include <stdio.h>
+#include <string.h>
+#include "c_types.h"
+#include "os_type.h"
+
+#define os_memcmp		memcmp
+#define os_memcpy		memcpy
+#define os_memmove		memmove
+#define os_memset		memset
+#define os_strcat		strcat
+#define os_strcmp		strcmp
+#define os_strcpy		strcpy
+#define os_strlen		strlen
+#define os_strncmp		strncmp
+#define os_strncpy		strncpy
+#define os_strstr		strstr
+#define os_sprintf		sprintf
+#define os_printf		printf
+
+//THE LIBRARY KEEPS ITS TIMERS volatile, AS THE SDK MACROS ALLOW
+void os_timer_setfn(volatile os_timer_t* ptimer, os_timer_func_t* pfunction, void* parg);
+void os_timer_arm(volatile os_timer_t* ptimer, uint32_t milliseconds, bool repeat_flag);
+void os_timer_disarm(volatile os_timer_t* ptimer);
+
+unsigned long os_random(void);
+
+#endif
@@ -0,0 +1,23 @@
+//HOST STAND-IN FOR THE ESP8266 NONOS SDK user_interface.h
+//system_get_time IS THE LOW 32 BITS OF THE VIRTUAL CLOCK, SO IT WRAPS AS ON THE DEVICE
+
+#ifndef _HOST_USER_INTERFACE_H_
+#define _HOST_USER_INTERFACE_H_
+
+#include "c_types.h"
+#include "os_type.h"
+
+#define USER_TASK_PRIO_0	0
+#define USER_TASK_PRIO_1	1
+#define USER_TASK_PRIO_2	2
+#define USER_TASK_PRIO_MAX	3
+
+uint32_t system_get_time(void);
+
+bool system_os_task(os_task_t task, uint8_t prio, os_event_t* queue, uint8_t qlen);
+bool system_os_post(uint8_t prio, os_signal_t sig, os_param_t par);
+
+bool system_rtc_mem_read(uint8_t src_addr, void* des_addr, uint16_t load_size);
+bool system_rtc_mem_write(uint8_t des_addr, const void* src_addr, uint16_t save_size);
+
+#endif
@@ -0,0 +1,1186 @@
+//ESP8266_TCP_GET HOST HARNESS
+//SOAK AND FAULT INJECTION
+//
+//RUNS INSTANCES OF THE LIBRARY FOR A NUMBER OF CYCLES AGAINST A SERVER IN THIS PROCESS,
+//OVER REAL LOOPBACK SOCKETS (espconn_socket.c). A FAULT SCRIPT (faults.txt) DECIDES
+//HOW EACH CONNECT AND EACH REQUEST IS ANSWERED
+//
+//TIME IS VIRTUAL (host.c). IT MOVES ON TO THE NEXT DEADLINE OR SCRIPTED DELAY ONLY WHEN
+//NO SOCKET HAS ANYTHING TO DO AND NO TASK IS POSTED, SO DAYS OF CYCLES RUN IN MINUTES.
+//THE CLOCK STARTS JUST BEFORE system_get_time WRAPS, AND WRAPS AGAIN EVERY 71 MINUTES
+//
+//INVARIANTS
+//	THE LIBRARY NEVER MAKES AN espconn CALL THE SDK WOULD REFUSE (espconn_socket.h)
+//	EVERY REQUEST SENT GETS EXACTLY ONE DATA READY CALLBACK
+//	A 200 REPLY YIELDS THE VALUE THE SERVER PUT IN IT. ANY STATUS BUT 2XX / 304 YIELDS NONE
+//	AN INSTANCE ALWAYS HAS A DEADLINE PENDING (ESP8266_TCP_GET_GetDeadlines), A SERVER
+//	ACTION PENDING ON ITS CONNECTION, OR A PLACE IN THE SLOT QUEUE. OTHERWISE IT IS STUCK
+//	NO CYCLE TAKES LONGER THAN SOAK_LONG_CYCLE_MS
+//	os_zalloc IS NOT CALLED AFTER INITIALIZATION, AND NO SOCKET IS LEFT OPEN AFTER STOP
+//	NO INSTANCE ENDS IN ESP8266_TCP_GET_STATE_ERROR. INSTANCE 0 GAINS AND LOSES A
+//	SUBSCRIBER EVERY SOAK_CHECK_MS, AND EACH CHANGE BUILDS ITS EXTRACTOR AGAIN. WITHOUT
+//	THE SUBSCRIBER IT HAS AS MUCH ARENA FREE AS IT HAD RIGHT AFTER SETUP
+//
+//usage: soak [-c cycles] [-f fault_script] [-s seed] [-d]
+//	-d	DEFERRED PROCESSING (ESP8266_TCP_GET_SetDeferredProcessing)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "ESP8266_TCP_GET.h"
+#include "host.h"
+#include "espconn_socket.h"
+
+#define SOAK_INSTANCES			5
+#define SOAK_MAX_CONNECT_RULES	8
+#define SOAK_MAX_RULES			32
+#define SOAK_MAX_ACTIONS		8
+#define SOAK_MAX_SERVER_CONNS	32
+#define SOAK_REQUEST_SIZE		1024
+#define SOAK_REPLY_SIZE			12000
+#define SOAK_DEFAULT_CYCLES		100000
+#define SOAK_CHECK_MS			60000
+#define SOAK_LONG_CYCLE_MS		120000
+#define SOAK_DRAIN_MS			60000
+#define SOAK_GIVE_UP			20 //STUCK INSTANCES OR LONG CYCLES
+#define SOAK_HISTOGRAM			24
+#define SOAK_START_US			(0x100000000ULL - 30000000ULL)
+
+typedef enum
+{
+	SOAK_CONNECT_ACCEPT,
+	SOAK_CONNECT_REFUSE,
+	SOAK_CONNECT_STALL
+} SOAK_CONNECT;
+
+typedef enum
+{
+	SOAK_ACTION_DELAY, //a TO b ms
+	SOAK_ACTION_SEG, //a BYTES PER WRITE
+	SOAK_ACTION_PAD, //a BYTES OF FILLER IN THE BODY
+	SOAK_ACTION_CUT, //STOP THE NEXT REPLY AFTER a BYTES
+	SOAK_ACTION_REPLY, //STATUS a, FRAMING b
+	SOAK_ACTION_CLOSE,
+	SOAK_ACTION_RESET,
+	SOAK_ACTION_STALL,
+	SOAK_ACTION_KEEP
+} SOAK_ACTION_TYPE;
+
+typedef enum
+{
+	SOAK_FRAMING_LENGTH,
+	SOAK_FRAMING_CHUNKED,
+	SOAK_FRAMING_CLOSE
+} SOAK_FRAMING;
+
+typedef struct
+{
+	SOAK_ACTION_TYPE type;
+	uint32_t a;
+	uint32_t b;
+}SOAK_ACTION;
+
+typedef struct
+{
+	uint32_t weight;
+	SOAK_CONNECT kind;
+	uint32_t uses;
+}SOAK_CONNECT_RULE;
+
+typedef struct
+{
+	uint32_t weight;
+	uint16_t line;
+	uint8_t action_count;
+	SOAK_ACTION actions[SOAK_MAX_ACTIONS];
+	uint32_t uses;
+}SOAK_RULE;
+
+typedef enum
+{
+	SOAK_SERVER_FREE,
+	SOAK_SERVER_REQUEST, //READING A REQUEST
+	SOAK_SERVER_RUN, //NEXT ACTION OF THE RULE
+	SOAK_SERVER_WAIT, //DELAY UNTIL wake_us
+	SOAK_SERVER_SEND, //WRITING THE REPLY, ONE SEGMENT PER STEP
+	SOAK_SERVER_STALLED //NOTHING MORE UNTIL THE CLIENT CLOSES
+} SOAK_SERVER_STATE;
+
+typedef struct
+{
+	int fd;
+	SOAK_SERVER_STATE state;
+	char request[SOAK_REQUEST_SIZE];
+	uint16_t request_length;
+	int instance;
+	uint32_t if_none_match;
+	const SOAK_RULE* rule;
+	uint8_t action;
+	uint64_t wake_us;
+	uint16_t seg;
+	uint32_t pad;
+	uint32_t cut;
+	SOAK_FRAMING framing;
+	char reply[SOAK_REPLY_SIZE];
+	uint32_t reply_length;
+	uint32_t reply_sent;
+}SOAK_SERVER_CONN;
+
+typedef struct
+{
+	ESP8266_TCP_GET tcp_get;
+	ESP8266_TCP_GET_EXTRACTED_DATA field;
+	ESP8266_TCP_GET_USER_DATA_CONTAINER container;
+	uint32_t seq; //VALUE OF THE LAST 200 REPLY SERVED
+	uint8_t seq_complete; //THAT REPLY WAS SENT WHOLE
+	uint8_t outstanding; //REQUEST SENT, DATA READY CALLBACK NOT CALLED YET
+	uint64_t request_us;
+	uint32_t busy_cycles;
+	uint64_t busy_since_us;
+}SOAK_INSTANCE;
+
+typedef struct
+{
+	uint32_t requests;
+	uint32_t callbacks_ok;
+	uint32_t callbacks_failed;
+	uint32_t missed; //A REQUEST WITHOUT A DATA READY CALLBACK
+	uint32_t extra; //A DATA READY CALLBACK WITHOUT A REQUEST
+	uint32_t wrong_value;
+	uint32_t stuck;
+	uint32_t long_cycles;
+	uint32_t replies;
+	uint32_t subscriber_changes;
+	uint32_t arena_lost; //ARENA BYTES NOT GIVEN BACK BY AN UNSUBSCRIBE, MOST SEEN
+	uint32_t histogram[SOAK_HISTOGRAM]; //REQUEST SENT TO DATA READY, log2 ms
+}SOAK_STATS;
+
+static SOAK_CONNECT_RULE _soak_connect_rules[SOAK_MAX_CONNECT_RULES];
+static uint8_t _soak_connect_rule_count;
+static uint32_t _soak_connect_weight;
+static SOAK_RULE _soak_rules[SOAK_MAX_RULES];
+static uint8_t _soak_rule_count;
+static uint32_t _soak_rule_weight;
+
+static SOAK_SERVER_CONN _soak_server[SOAK_MAX_SERVER_CONNS];
+static int _soak_listener = -1;
+static uint16_t _soak_port_accept;
+static uint16_t _soak_port_refuse;
+static uint16_t _soak_port_stall;
+
+static SOAK_INSTANCE _soak_instances[SOAK_INSTANCES];
+static SOAK_STATS _soak_stats;
+static ESP8266_TCP_GET_SUBSCRIBER _soak_subscriber;
+static ESP8266_TCP_GET_EXTRACTED_DATA _soak_subscriber_field;
+static ESP8266_TCP_GET_USER_DATA_CONTAINER _soak_subscriber_container;
+static uint8_t _soak_subscribed;
+static uint32_t _soak_arena_free; //INSTANCE 0 ARENA NOT HELD BY PERSISTENT BLOCKS OR TABLES, AFTER SETUP
+
+//FAULT SCRIPT//////////////////////////////////////////
+
+static void _soak_script_error(const char* path, uint16_t line, const char* message)
+{
+	fprintf(stderr, "%s:%u: %s\n", path, line, message);
+	exit(2);
+}
+
+static uint32_t _soak_number(const char* path, uint16_t line, const char* token)
+{
+	char* end;
+	unsigned long value;
+
+	if(token == NULL)
+	{
+		_soak_script_error(path, line, "number missing");
+	}
+	value = strtoul(token, &end, 10);
+	if(*end != '\0' && *end != '-')
+	{
+		_soak_script_error(path, line, "bad number");
+	}
+	return (uint32_t)value;
+}
+
+static void _soak_load_script(const char* path)
+{
+	FILE* f = fopen(path, "r");
+	char text[256];
+	char* token;
+	char* hash;
+	uint16_t line = 0;
+
+	if(f == NULL)
+	{
+		fprintf(stderr, "soak: can not open %s\n", path);
+		exit(2);
+	}
+	while(fgets(text, sizeof(text), f) != NULL)
+	{
+		line++;
+		hash = strchr(text, '#');
+		if(hash != NULL)
+		{
+			*hash = '\0';
+		}
+		token = strtok(text, " \t\r\n");
+		if(token == NULL)
+		{
+			continue;
+		}
+
+		if(strcmp(token, "connect") == 0)
+		{
+			SOAK_CONNECT_RULE* rule;
+
+			if(_soak_connect_rule_count == SOAK_MAX_CONNECT_RULES)
+			{
+				_soak_script_error(path, line, "too many connect rules");
+			}
+			rule = &_soak_connect_rules[_soak_connect_rule_count++];
+			rule->weight = _soak_number(path, line, strtok(NULL, " \t\r\n"));
+			token = strtok(NULL, " \t\r\n");
+			if(token != NULL && strcmp(token, "accept") == 0)
+			{
+				rule->kind = SOAK_CONNECT_ACCEPT;
+			}
+			else if(token != NULL && strcmp(token, "refuse") == 0)
+			{
+				rule->kind = SOAK_CONNECT_REFUSE;
+			}
+			else if(token != NULL && strcmp(token, "stall") == 0)
+			{
+				rule->kind = SOAK_CONNECT_STALL;
+			}
+			else
+			{
+				_soak_script_error(path, line, "connect needs accept, refuse or stall");
+			}
+			_soak_connect_weight += rule->weight;
+			continue;
+		}
+
+		{
+			SOAK_RULE* rule;
+
+			if(_soak_rule_count == SOAK_MAX_RULES)
+			{
+				_soak_script_error(path, line, "too many rules");
+			}
+			rule = &_soak_rules[_soak_rule_count++];
+			rule->line = line;
+			rule->weight = _soak_number(path, line, token);
+			_soak_rule_weight += rule->weight;
+			while((token = strtok(NULL, " \t\r\n")) != NULL)
+			{
+				SOAK_ACTION* action;
+
+				if(rule->action_count == SOAK_MAX_ACTIONS)
+				{
+					_soak_script_error(path, line, "too many actions");
+				}
+				action = &rule->actions[rule->action_count++];
+				if(strcmp(token, "delay") == 0)
+				{
+					token = strtok(NULL, " \t\r\n");
+					action->type = SOAK_ACTION_DELAY;
+					action->a = _soak_number(path, line, token);
+					action->b = (strchr(token, '-') != NULL) ? _soak_number(path, line, strchr(token, '-') + 1) : action->a;
+					if(action->b < action->a)
+					{
+						_soak_script_error(path, line, "bad delay range");
+					}
+				}
+				else if(strcmp(token, "seg") == 0 || strcmp(token, "pad") == 0 || strcmp(token, "cut") == 0)
+				{
+					action->type = (token[0] == 's') ? SOAK_ACTION_SEG : (token[0] == 'p') ? SOAK_ACTION_PAD : SOAK_ACTION_CUT;
+					action->a = _soak_number(path, line, strtok(NULL, " \t\r\n"));
+					if((action->type == SOAK_ACTION_SEG && (action->a == 0 || action->a > ESPCONN_SOCKET_SEGMENT)) ||
+						(action->type == SOAK_ACTION_PAD && action->a > SOAK_REPLY_SIZE - 1000))
+					{
+						_soak_script_error(path, line, "seg or pad out of range");
+					}
+				}
+				else if(strcmp(token, "reply") == 0)
+				{
+					action->type = SOAK_ACTION_REPLY;
+					action->a = _soak_number(path, line, strtok(NULL, " \t\r\n"));
+					token = strtok(NULL, " \t\r\n");
+					if(token != NULL && strcmp(token, "length") == 0)
+					{
+						action->b = SOAK_FRAMING_LENGTH;
+					}
+					else if(token != NULL && strcmp(token, "chunked") == 0)
+					{
+						action->b = SOAK_FRAMING_CHUNKED;
+					}
+					else if(token != NULL && strcmp(token, "close") == 0)
+					{
+						action->b = SOAK_FRAMING_CLOSE;
+					}
+					else
+					{
+						_soak_script_error(path, line, "reply needs length, chunked or close");
+					}
+				}
+				else if(strcmp(token, "close") == 0)
+				{
+					action->type = SOAK_ACTION_CLOSE;
+				}
+				else if(strcmp(token, "reset") == 0)
+				{
+					action->type = SOAK_ACTION_RESET;
+				}
+				else if(strcmp(token, "stall") == 0)
+				{
+					action->type = SOAK_ACTION_STALL;
+				}
+				else if(strcmp(token, "keep") == 0)
+				{
+					action->type = SOAK_ACTION_KEEP;
+				}
+				else
+				{
+					_soak_script_error(path, line, "unknown action");
+				}
+			}
+		}
+	}
+	fclose(f);
+	if(_soak_rule_weight == 0 || _soak_connect_weight == 0)
+	{
+		fprintf(stderr, "%s: needs connect rules and reply rules with a weight\n", path);
+		exit(2);
+	}
+}
+
+//SERVER////////////////////////////////////////////////
+
+static int _soak_socket(uint8_t do_listen, int backlog, uint16_t* port)
+{
+	//TCP SOCKET ON 127.0.0.1 AND A PORT OF THE KERNEL'S CHOICE
+	struct sockaddr_in address;
+	socklen_t length = sizeof(address);
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if(fd < 0 || bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+		(do_listen && listen(fd, backlog) != 0))
+	{
+		perror("soak: server socket");
+		exit(2);
+	}
+	getsockname(fd, (struct sockaddr*)&address, &length);
+	*port = ntohs(address.sin_port);
+	return fd;
+}
+
+static void _soak_server_start(void)
+{
+	//accept : THE SERVER
+	//refuse : A PORT THAT IS BOUND BUT NOT LISTENING. THE SYN GETS A RST
+	//stall : A LISTENER THAT NEVER ACCEPTS, WITH ITS ONE QUEUE PLACE TAKEN. SYNs ARE DROPPED
+	struct sockaddr_in address;
+	int tarpit;
+	int filler;
+
+	_soak_listener = _soak_socket(1, 128, &_soak_port_accept);
+	fcntl(_soak_listener, F_SETFL, O_NONBLOCK);
+	_soak_socket(0, 0, &_soak_port_refuse);
+	tarpit = _soak_socket(1, 0, &_soak_port_stall);
+	filler = socket(AF_INET, SOCK_STREAM, 0);
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons(_soak_port_stall);
+	if(tarpit < 0 || connect(filler, (struct sockaddr*)&address, sizeof(address)) != 0)
+	{
+		perror("soak: tarpit");
+		exit(2);
+	}
+}
+
+static uint16_t _soak_route(struct espconn* espconn, uint32_t ip, int port)
+{
+	//PICK THE CONNECT RULE FOR THIS ATTEMPT
+	uint32_t pick = host_random() % _soak_connect_weight;
+	uint8_t i;
+
+	for(i = 0; pick >= _soak_connect_rules[i].weight; i++)
+	{
+		pick -= _soak_connect_rules[i].weight;
+	}
+	_soak_connect_rules[i].uses++;
+	switch(_soak_connect_rules[i].kind)
+	{
+		case SOAK_CONNECT_REFUSE:
+			return _soak_port_refuse;
+		case SOAK_CONNECT_STALL:
+			return _soak_port_stall;
+		default:
+			return _soak_port_accept;
+	}
+}
+
+static void _soak_server_close(SOAK_SERVER_CONN* conn, uint8_t reset)
+{
+	struct linger linger = {1, 0};
+
+	if(reset)
+	{
+		setsockopt(conn->fd, SOL_SOCKET, SO_LINGER, &linger, sizeof(linger));
+	}
+	close(conn->fd);
+	conn->state = SOAK_SERVER_FREE;
+}
+
+static void _soak_server_request(SOAK_SERVER_CONN* conn)
+{
+	//A WHOLE REQUEST HAS COME. PICK THE RULE THAT ANSWERS IT
+	const char* etag = strstr(conn->request, "If-None-Match: \"");
+	uint32_t pick = host_random() % _soak_rule_weight;
+	uint8_t i;
+
+	conn->instance = -1;
+	if(sscanf(conn->request, "GET /data/%d ", &conn->instance) != 1 || conn->instance < 0 ||
+		conn->instance >= SOAK_INSTANCES)
+	{
+		conn->instance = -1;
+	}
+	conn->if_none_match = (etag != NULL) ? (uint32_t)strtoul(etag + 16, NULL, 10) : 0;
+
+	for(i = 0; pick >= _soak_rules[i].weight; i++)
+	{
+		pick -= _soak_rules[i].weight;
+	}
+	conn->rule = &_soak_rules[i];
+	_soak_rules[i].uses++;
+	conn->action = 0;
+	conn->seg = ESPCONN_SOCKET_SEGMENT;
+	conn->pad = 100;
+	conn->cut = 0;
+	conn->framing = SOAK_FRAMING_LENGTH;
+	conn->state = SOAK_SERVER_RUN;
+}
+
+static void _soak_server_reply(SOAK_SERVER_CONN* conn, uint16_t status, SOAK_FRAMING framing)
+{
+	//BUILD THE REPLY. A 200 CARRIES THE NEXT VALUE OF THE INSTANCE AS "seq" AND AS ITS
+	//ETAG. A 304 IS ONLY SENT IF THE REQUEST HAS THE CURRENT ETAG, OTHERWISE A 200 IS
+	SOAK_INSTANCE* inst = (conn->instance >= 0) ? &_soak_instances[conn->instance] : NULL;
+	char body[SOAK_REPLY_SIZE];
+	uint32_t body_length;
+	uint32_t n;
+	uint32_t offset;
+	uint32_t chunk;
+	const char* reason;
+
+	if(status == 304 && (inst == NULL || inst->seq == 0 || conn->if_none_match != inst->seq))
+	{
+		status = 200;
+	}
+	if(status == 200 && inst != NULL)
+	{
+		inst->seq++;
+		inst->seq_complete = 0;
+		body_length = sprintf(body, "{\"seq\":%u,\"pad\":\"", inst->seq);
+	}
+	else
+	{
+		body_length = sprintf(body, "{\"error\":%u,\"pad\":\"", status);
+	}
+	memset(body + body_length, 'x', conn->pad);
+	body_length += conn->pad;
+	body_length += sprintf(body + body_length, "\"}");
+
+	reason = (status == 200) ? "OK" : (status == 304) ? "Not Modified" : (status == 503) ? "Service Unavailable" : "Status";
+	n = sprintf(conn->reply, "%s %u %s\r\nServer: soak\r\n", (framing == SOAK_FRAMING_CLOSE) ? "HTTP/1.0" : "HTTP/1.1",
+				status, reason);
+	if(inst != NULL && (status == 200 || status == 304))
+	{
+		n += sprintf(conn->reply + n, "ETag: \"%u\"\r\n", inst->seq);
+	}
+	if(status == 304)
+	{
+		n += sprintf(conn->reply + n, "\r\n");
+	}
+	else if(framing == SOAK_FRAMING_LENGTH)
+	{
+		n += sprintf(conn->reply + n, "Content-Length: %u\r\n\r\n", body_length);
+		memcpy(conn->reply + n, body, body_length);
+		n += body_length;
+	}
+	else if(framing == SOAK_FRAMING_CHUNKED)
+	{
+		n += sprintf(conn->reply + n, "Transfer-Encoding: chunked\r\n\r\n");
+		for(offset = 0; offset < body_length; offset += chunk)
+		{
+			chunk = 1 + host_random() % 300;
+			chunk = (chunk > body_length - offset) ? body_length - offset : chunk;
+			n += sprintf(conn->reply + n, "%x\r\n", chunk);
+			memcpy(conn->reply + n, body + offset, chunk);
+			n += chunk;
+			n += sprintf(conn->reply + n, "\r\n");
+		}
+		n += sprintf(conn->reply + n, "0\r\n\r\n");
+	}
+	else
+	{
+		n += sprintf(conn->reply + n, "\r\n");
+		memcpy(conn->reply + n, body, body_length);
+		n += body_length;
+	}
+	conn->reply_length = n;
+	conn->reply_sent = 0;
+	conn->framing = framing;
+	_soak_stats.replies++;
+}
+
+static uint32_t _soak_server_run(SOAK_SERVER_CONN* conn)
+{
+	//CARRY OUT ACTIONS UNTIL ONE HAS TO WAIT
+	const SOAK_ACTION* action;
+
+	while(conn->action < conn->rule->action_count)
+	{
+		action = &conn->rule->actions[conn->action++];
+		switch(action->type)
+		{
+			case SOAK_ACTION_DELAY:
+				conn->wake_us = host_time_us() + 1000ULL * (action->a + host_random() % (action->b - action->a + 1));
+				conn->state = SOAK_SERVER_WAIT;
+				return 1;
+
+			case SOAK_ACTION_SEG:
+				conn->seg = (uint16_t)action->a;
+				break;
+
+			case SOAK_ACTION_PAD:
+				conn->pad = action->a;
+				break;
+
+			case SOAK_ACTION_CUT:
+				conn->cut = action->a;
+				break;
+
+			case SOAK_ACTION_REPLY:
+				_soak_server_reply(conn, (uint16_t)action->a, (SOAK_FRAMING)action->b);
+				conn->state = SOAK_SERVER_SEND;
+				return 1;
+
+			case SOAK_ACTION_CLOSE:
+				_soak_server_close(conn, 0);
+				return 1;
+
+			case SOAK_ACTION_RESET:
+				_soak_server_close(conn, 1);
+				return 1;
+
+			case SOAK_ACTION_STALL:
+				conn->state = SOAK_SERVER_STALLED;
+				return 1;
+
+			case SOAK_ACTION_KEEP:
+				conn->state = SOAK_SERVER_REQUEST;
+				conn->request_length = 0;
+				return 1;
+		}
+	}
+
+	//END OF THE RULE. A BODY FRAMED BY THE CLOSE ENDS WITH IT
+	if(conn->framing == SOAK_FRAMING_CLOSE)
+	{
+		_soak_server_close(conn, 0);
+	}
+	else
+	{
+		conn->state = SOAK_SERVER_REQUEST;
+		conn->request_length = 0;
+	}
+	return 1;
+}
+
+static uint32_t _soak_server_conn_step(SOAK_SERVER_CONN* conn)
+{
+	char buffer[512];
+	uint32_t limit;
+	uint32_t n;
+	ssize_t r;
+
+	switch(conn->state)
+	{
+		case SOAK_SERVER_REQUEST:
+			r = recv(conn->fd, conn->request + conn->request_length, SOAK_REQUEST_SIZE - 1 - conn->request_length, 0);
+			if(r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			{
+				return 0;
+			}
+			if(r <= 0 || conn->request_length + r == SOAK_REQUEST_SIZE - 1)
+			{
+				_soak_server_close(conn, 0);
+				return 1;
+			}
+			conn->request_length += r;
+			conn->request[conn->request_length] = '\0';
+			if(strstr(conn->request, "\r\n\r\n") != NULL)
+			{
+				_soak_server_request(conn);
+			}
+			return 1;
+
+		case SOAK_SERVER_RUN:
+			return _soak_server_run(conn);
+
+		case SOAK_SERVER_WAIT:
+			if(host_time_us() >= conn->wake_us)
+			{
+				return _soak_server_run(conn);
+			}
+			//FREE THE PLACE AS SOON AS THE CLIENT GIVES UP
+			r = recv(conn->fd, buffer, sizeof(buffer), MSG_PEEK);
+			if(r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+			{
+				_soak_server_close(conn, 0);
+				return 1;
+			}
+			return 0;
+
+		case SOAK_SERVER_SEND:
+			limit = (conn->cut != 0 && conn->cut < conn->reply_length) ? conn->cut : conn->reply_length;
+			n = (limit - conn->reply_sent < conn->seg) ? limit - conn->reply_sent : conn->seg;
+			r = send(conn->fd, conn->reply + conn->reply_sent, n, MSG_NOSIGNAL);
+			if(r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			{
+				return 0;
+			}
+			if(r < 0)
+			{
+				_soak_server_close(conn, 0);
+				return 1;
+			}
+			conn->reply_sent += r;
+			if(conn->reply_sent == limit)
+			{
+				if(limit == conn->reply_length && conn->instance >= 0)
+				{
+					_soak_instances[conn->instance].seq_complete = 1;
+				}
+				conn->cut = 0;
+				conn->state = SOAK_SERVER_RUN;
+			}
+			return 1;
+
+		case SOAK_SERVER_STALLED:
+			r = recv(conn->fd, buffer, sizeof(buffer), 0);
+			if(r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			{
+				return 0;
+			}
+			if(r <= 0)
+			{
+				_soak_server_close(conn, 0);
+			}
+			return 1;
+
+		default:
+			return 0;
+	}
+}
+
+static uint32_t _soak_server_step(void)
+{
+	//ACCEPT NEW CONNECTIONS AND MOVE EVERY CONNECTION ON BY ONE STEP
+	//RETURNS THE NUMBER OF THINGS DONE. 0 = THE SERVER IS WAITING
+	uint32_t events = 0;
+	int fd;
+	int i;
+
+	while((fd = accept(_soak_listener, NULL, NULL)) >= 0)
+	{
+		for(i = 0; i < SOAK_MAX_SERVER_CONNS && _soak_server[i].state != SOAK_SERVER_FREE; i++)
+		{
+		}
+		if(i == SOAK_MAX_SERVER_CONNS)
+		{
+			fprintf(stderr, "soak: more than %d server connections\n", SOAK_MAX_SERVER_CONNS);
+			exit(2);
+		}
+		fcntl(fd, F_SETFL, O_NONBLOCK);
+		_soak_server[i].fd = fd;
+		_soak_server[i].state = SOAK_SERVER_REQUEST;
+		_soak_server[i].request_length = 0;
+		_soak_server[i].instance = -1;
+		events++;
+	}
+	for(i = 0; i < SOAK_MAX_SERVER_CONNS; i++)
+	{
+		if(_soak_server[i].state != SOAK_SERVER_FREE)
+		{
+			events += _soak_server_conn_step(&_soak_server[i]);
+		}
+	}
+	return events;
+}
+
+static uint8_t _soak_server_next_wake(uint64_t* wake_us)
+{
+	//EARLIEST DELAY IN PROGRESS. 0 IF NONE
+	uint8_t found = 0;
+	int i;
+
+	for(i = 0; i < SOAK_MAX_SERVER_CONNS; i++)
+	{
+		if(_soak_server[i].state == SOAK_SERVER_WAIT && (!found || _soak_server[i].wake_us < *wake_us))
+		{
+			*wake_us = _soak_server[i].wake_us;
+			found = 1;
+		}
+	}
+	return found;
+}
+
+static uint8_t _soak_server_busy(int instance)
+{
+	//THE SERVER STILL HAS SOMETHING TO DO FOR THE INSTANCE
+	int i;
+
+	for(i = 0; i < SOAK_MAX_SERVER_CONNS; i++)
+	{
+		if(_soak_server[i].instance == instance &&
+			(_soak_server[i].state == SOAK_SERVER_RUN || _soak_server[i].state == SOAK_SERVER_WAIT ||
+				_soak_server[i].state == SOAK_SERVER_SEND))
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//CLIENT SIDE///////////////////////////////////////////
+
+static int _soak_instance_of(ESP8266_TCP_GET* tcp_get)
+{
+	return (int)((SOAK_INSTANCE*)tcp_get - _soak_instances);
+}
+
+static void _soak_sent_hook(struct espconn* espconn, uint8* data, uint16 length)
+{
+	//A REQUEST LEAVES. ITS DATA READY CALLBACK IS DUE
+	SOAK_INSTANCE* inst = &_soak_instances[_soak_instance_of((ESP8266_TCP_GET*)espconn->reverse)];
+
+	if(length < 4 || memcmp(data, "GET ", 4) != 0)
+	{
+		return;
+	}
+	_soak_stats.requests++;
+	if(inst->outstanding)
+	{
+		_soak_stats.missed++;
+	}
+	inst->outstanding = 1;
+	inst->request_us = host_time_us();
+}
+
+static void _soak_data_ready_cb(ESP8266_TCP_GET* tcp_get, ESP8266_TCP_GET_USER_DATA_CONTAINER* container)
+{
+	SOAK_INSTANCE* inst = &_soak_instances[_soak_instance_of(tcp_get)];
+	uint64_t ms = (host_time_us() - inst->request_us) / 1000;
+	uint16_t status_code = ESP8266_TCP_GET_GetReplyStatusCode(tcp_get);
+	uint8_t bucket = 0;
+
+	if(!inst->outstanding)
+	{
+		_soak_stats.extra++;
+		return;
+	}
+	inst->outstanding = 0;
+	while(bucket < SOAK_HISTOGRAM - 1 && (1ULL << bucket) <= ms)
+	{
+		bucket++;
+	}
+	_soak_stats.histogram[bucket]++;
+
+	if(container == NULL)
+	{
+		_soak_stats.callbacks_failed++;
+		return;
+	}
+	_soak_stats.callbacks_ok++;
+	if(status_code != 304 && (status_code < 200 || status_code >= 300))
+	{
+		//ANY OTHER STATUS IS REPORTED AS A FAILED REPLY
+		_soak_stats.wrong_value++;
+		if(_soak_stats.wrong_value <= 5)
+		{
+			printf("WRONG VALUE instance %d got its container for a %u reply\n", _soak_instance_of(tcp_get), status_code);
+		}
+		return;
+	}
+	if(status_code != 200)
+	{
+		return;
+	}
+	if(inst->field.data_found ? ((uint32_t)strtoul(inst->field.extracted_data, NULL, 10) != inst->seq) : inst->seq_complete)
+	{
+		_soak_stats.wrong_value++;
+		if(_soak_stats.wrong_value <= 5)
+		{
+			printf("WRONG VALUE instance %d got \"%s\" (found %u) served %u\n", _soak_instance_of(tcp_get),
+					inst->field.extracted_data, inst->field.data_found, inst->seq);
+		}
+	}
+}
+
+static void _soak_setup(uint8_t deferred)
+{
+	//FIVE INSTANCES SHARING TWO CONNECTION SLOTS
+	//0 : PLAIN, CONDITIONAL GET
+	//1 : KEEP-ALIVE, CONDITIONAL GET
+	//2 : TWO MORE ADDRESSES TO FAIL OVER TO
+	//3, 4 : TLS (KEEP-ALIVE TURNED ON BY ESP8266_TCP_GET_SetSecure). THEY TAKE TURNS ON
+	//THE ONE SECURE CONNECTION THE SDK ALLOWS
+	ip_addr_t address;
+	char path[16];
+	int i;
+
+	ESP8266_TCP_GET_SetDebug(0);
+	ESP8266_TCP_GET_SetMaxConcurrentConnections(2);
+	if(deferred)
+	{
+		ESP8266_TCP_GET_SetDeferredProcessing(USER_TASK_PRIO_1, 8, 3000);
+	}
+	for(i = 0; i < SOAK_INSTANCES; i++)
+	{
+		SOAK_INSTANCE* inst = &_soak_instances[i];
+
+		sprintf(path, "/data/%d", i);
+		ESP8266_TCP_GET_Initialize(&inst->tcp_get, "example.com", NULL, (i >= 3) ? 443 : 80, path, 1000);
+		ESP8266_TCP_GET_Intialize_Request_Buffer(&inst->tcp_get, 256);
+		ESP8266_TCP_GET_SetIntervalBounds(&inst->tcp_get, 500, 2000);
+		if(i == 1)
+		{
+			ESP8266_TCP_GET_SetKeepAlive(&inst->tcp_get, 1, 1500);
+		}
+		if(i >= 3)
+		{
+			ESP8266_TCP_GET_SetSecure(&inst->tcp_get, 1, 0);
+		}
+		if(i != 2)
+		{
+			ESP8266_TCP_GET_SetConditionalGet(&inst->tcp_get, 1);
+		}
+		else
+		{
+			IP4_ADDR(&address, 10, 0, 0, 2);
+			ESP8266_TCP_GET_AddServerAddress(&inst->tcp_get, &address);
+			IP4_ADDR(&address, 10, 0, 0, 3);
+			ESP8266_TCP_GET_AddServerAddress(&inst->tcp_get, &address);
+			ESP8266_TCP_GET_SetConnectTimeout(&inst->tcp_get, 4000, 500);
+		}
+		strcpy(inst->field.extracted_data_start_match_string, "\"seq\":");
+		inst->field.extracted_data_offset_from_match_string = 6;
+		inst->field.extracted_data_terminating_char = ',';
+		inst->container.tcp_reply_extracted_data_count = 1;
+		inst->container.tcp_reply_extracted_data = &inst->field;
+		ESP8266_TCP_GET_Initialize_UserDataContainer(&inst->tcp_get, &inst->container);
+		if(i == 0)
+		{
+			//A PERSISTENT ARENA BLOCK TAKEN AFTER THE EXTRACTOR IS BUILT, AS AN UPLOAD QUEUE
+			//OR A LARGER REQUEST BUFFER SET UP AFTER THE CONTAINER WOULD BE
+			ESP8266_TCP_GET_Intialize_Request_Buffer(&inst->tcp_get, 320);
+		}
+		ESP8266_TCP_GET_SetCallbackFunctions(&inst->tcp_get, NULL, NULL, NULL, NULL, _soak_data_ready_cb);
+		ESP8266_TCP_GET_ResolveHostName(&inst->tcp_get, NULL);
+		ESP8266_TCP_GET_StartDataAcqusition(&inst->tcp_get);
+	}
+
+	strcpy(_soak_subscriber_field.extracted_data_start_match_string, "\"pad\":\"");
+	_soak_subscriber_field.extracted_data_offset_from_match_string = 7;
+	_soak_subscriber_field.extracted_data_terminating_char = '"';
+	_soak_subscriber_container.tcp_reply_extracted_data_count = 1;
+	_soak_subscriber_container.tcp_reply_extracted_data = &_soak_subscriber_field;
+	_soak_arena_free = _soak_instances[0].tcp_get.arena.tables - _soak_instances[0].tcp_get.arena.persistent;
+}
+
+static void _soak_churn(void)
+{
+	//SUBSCRIBE OR UNSUBSCRIBE A SECOND CONTAINER ON INSTANCE 0
+	ESP8266_TCP_GET* tcp_get = &_soak_instances[0].tcp_get;
+	uint32_t arena_free;
+
+	if(_soak_subscribed)
+	{
+		ESP8266_TCP_GET_Unsubscribe(tcp_get, &_soak_subscriber);
+	}
+	else
+	{
+		//THE EXTRACTOR IS REBUILT WITHOUT THE SUBSCRIBER BY NOW, UNLESS A REPLY IS STILL HOLDING IT
+		arena_free = tcp_get->arena.tables - tcp_get->arena.persistent;
+		if(!tcp_get->recompile_pending && arena_free < _soak_arena_free &&
+				_soak_arena_free - arena_free > _soak_stats.arena_lost)
+		{
+			_soak_stats.arena_lost = _soak_arena_free - arena_free;
+		}
+		ESP8266_TCP_GET_Subscribe(tcp_get, &_soak_subscriber, &_soak_subscriber_container, 5000, NULL);
+	}
+	_soak_subscribed = !_soak_subscribed;
+	_soak_stats.subscriber_changes++;
+}
+
+static uint32_t _soak_cycles(void)
+{
+	uint32_t cycles = 0;
+	int i;
+
+	for(i = 0; i < SOAK_INSTANCES; i++)
+	{
+		cycles += _soak_instances[i].tcp_get.stats.cycles;
+	}
+	return cycles;
+}
+
+static void _soak_check(void)
+{
+	//STUCK AND LONG CYCLE CHECKS. ONLY WHEN NOTHING IS HAPPENING ON THE SOCKETS
+	ESP8266_TCP_GET_DEADLINE deadlines[32];
+	uint8_t count = ESP8266_TCP_GET_GetDeadlines(deadlines, 32, NULL);
+	uint64_t now = host_time_us();
+	uint8_t has_deadline;
+	uint8_t d;
+	int i;
+
+	for(i = 0; i < SOAK_INSTANCES; i++)
+	{
+		SOAK_INSTANCE* inst = &_soak_instances[i];
+		ESP8266_TCP_GET* tcp_get = &inst->tcp_get;
+
+		has_deadline = 0;
+		for(d = 0; d < count; d++)
+		{
+			has_deadline |= (deadlines[d].tcp_get == tcp_get);
+		}
+		if(!has_deadline && !_soak_server_busy(i) && !tcp_get->waiting_for_slot)
+		{
+			_soak_stats.stuck++;
+			if(_soak_stats.stuck <= 5)
+			{
+				printf("STUCK instance %d at %llus: cycle_active %u reply_pending %u connected %u slot %u\n", i,
+						(unsigned long long)(now / 1000000), tcp_get->cycle_active, tcp_get->reply_pending,
+						tcp_get->connected, tcp_get->holds_slot);
+			}
+		}
+
+		if(!(tcp_get->cycle_active || tcp_get->reply_pending) || tcp_get->stats.cycles != inst->busy_cycles)
+		{
+			inst->busy_since_us = now;
+			inst->busy_cycles = tcp_get->stats.cycles;
+		}
+		else if(now - inst->busy_since_us > SOAK_LONG_CYCLE_MS * 1000ULL)
+		{
+			_soak_stats.long_cycles++;
+			if(_soak_stats.long_cycles <= 5)
+			{
+				printf("LONG CYCLE instance %d at %llus\n", i, (unsigned long long)(now / 1000000));
+			}
+			inst->busy_since_us = now;
+		}
+	}
+}
+
+static uint8_t _soak_run(uint32_t cycles, uint64_t until_us)
+{
+	//RUN UNTIL THE INSTANCES HAVE DONE cycles CYCLES (0 = ANY) OR THE CLOCK REACHES until_us
+	//RETURNS 0 IF NOTHING IS LEFT TO HAPPEN
+	uint64_t next_check = host_time_us() + SOAK_CHECK_MS * 1000ULL;
+	uint64_t next;
+	uint64_t wake = 0;
+	uint8_t has_timer;
+	uint8_t has_wake;
+	uint8_t quiet = 0;
+
+	while((cycles == 0 || _soak_cycles() < cycles) && host_time_us() < until_us)
+	{
+		if(_soak_server_step() + espconn_socket_poll() + host_run_tasks() != 0)
+		{
+			quiet = 0;
+			continue;
+		}
+
+		//LOOK ONCE MORE BEFORE TIME MOVES, FOR LOOPBACK DATA STILL ON ITS WAY
+		if(++quiet < 2)
+		{
+			continue;
+		}
+		quiet = 0;
+
+		if(host_time_us() >= next_check)
+		{
+			_soak_check();
+			_soak_churn();
+			next_check = host_time_us() + SOAK_CHECK_MS * 1000ULL;
+			if(_soak_stats.stuck + _soak_stats.long_cycles >= SOAK_GIVE_UP)
+			{
+				printf("GIVING UP after %u stuck instances or long cycles\n", SOAK_GIVE_UP);
+				return 1;
+			}
+		}
+		has_timer = host_next_timer(&next);
+		has_wake = _soak_server_next_wake(&wake);
+		if(!has_timer && !has_wake && cycles != 0)
+		{
+			return 0;
+		}
+		if(!has_timer || next > until_us)
+		{
+			next = until_us;
+		}
+		if(has_wake && wake < next)
+		{
+			next = wake;
+		}
+		host_run_until(next);
+	}
+	return 1;
+}
+
+static void _soak_usage(void)
+{
+	fprintf(stderr, "usage: soak [-c cycles] [-f fault_script] [-s seed] [-d]\n");
+	exit(2);
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t cycles = SOAK_DEFAULT_CYCLES;
+	const char* script = "faults.txt";
+	uint32_t seed = 1;
+	uint8_t deferred = 0;
+	uint32_t heap_bytes;
+	uint32_t failures;
+	uint32_t errors = 0;
+	uint32_t handshakes = 0;
+	uint32_t tls_open = 0;
+	uint64_t start;
+	int i;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-d") == 0)
+		{
+			deferred = 1;
+		}
+		else if(i + 1 < argc && strcmp(argv[i], "-c") == 0)
+		{
+			cycles = (uint32_t)atol(argv[++i]);
+		}
+		else if(i + 1 < argc && strcmp(argv[i], "-f") == 0)
+		{
+			script = argv[++i];
+		}
+		else if(i + 1 < argc && strcmp(argv[i], "-s") == 0)
+		{
+			seed = (uint32_t)atol(argv[++i]);
+		}
+		else
+		{
+			_soak_usage();
+		}
+	}
+
+	_soak_load_script(script);
+	_soak_server_start();
+	host_seed(seed);
+	host_set_time_us(SOAK_START_US);
+	start = host_time_us();
+	espconn_socket_route = _soak_route;
+	espconn_socket_sent_hook = _soak_sent_hook;
+
+	_soak_setup(deferred);
+	heap_bytes = host_heap.bytes;
+	host_heap_mark();
+
+	if(!_soak_run(cycles, (uint64_t)-1))
+	{
+		_soak_stats.stuck++;
+		printf("NOTHING SCHEDULED at %llus\n", (unsigned long long)(host_time_us() / 1000000));
+	}
+
+	//STOP, LET THE LAST CYCLES END, THEN EVERY SOCKET MUST BE CLOSED
+	for(i = 0; i < SOAK_INSTANCES; i++)
+	{
+		ESP8266_TCP_GET_StopDataAcquisition(&_soak_instances[i].tcp_get);
+	}
+	_soak_run(0, host_time_us() + SOAK_DRAIN_MS * 1000ULL);
+
+	printf("%u cycles in %llu s of virtual time (seed %u%s)\n", _soak_cycles(),
+			(unsigned long long)((host_time_us() - start) / 1000000), seed, deferred ? ", deferred" : "");
+	printf("requests %u, data ready %u ok + %u failed, replies %u\n", _soak_stats.requests, _soak_stats.callbacks_ok,
+			_soak_stats.callbacks_failed, _soak_stats.replies);
+	printf("connects %u, failed %u, resets %u\n", espconn_socket_stats.connects, espconn_socket_stats.connect_failures,
+			espconn_socket_stats.resets);
+	printf("\nrequest sent to data ready (virtual ms):\n");
+	for(i = 0; i < SOAK_HISTOGRAM; i++)
+	{
+		if(_soak_stats.histogram[i] != 0)
+		{
+			printf("  %s%-8llu %u\n", (i == SOAK_HISTOGRAM - 1) ? ">=" : "< ",
+					(i == SOAK_HISTOGRAM - 1) ? (1ULL << (i - 1)) : (1ULL << i), _soak_stats.histogram[i]);
+		}
+	}
+	printf("\ninstance  cycles      ok  timeouts  conn_to  errors  failovers  arena_hw\n");
+	for(i = 0; i < SOAK_INSTANCES; i++)
+	{
+		ESP8266_TCP_GET* tcp_get = &_soak_instances[i].tcp_get;
+
+		printf("%8d %7u %7u %9u %8u %7u %10u %9u\n", i, tcp_get->stats.cycles, tcp_get->stats.cycles_ok,
+				tcp_get->stats.timeouts, tcp_get->stats.connect_timeouts, tcp_get->stats.connection_errors,
+				tcp_get->stats.failovers, ESP8266_TCP_GET_GetArenaHighWaterMark(tcp_get));
+	}
+	printf("\nfault rules used:");
+	for(i = 0; i < _soak_connect_rule_count; i++)
+	{
+		printf(" connect:%u", _soak_connect_rules[i].uses);
+	}
+	for(i = 0; i < _soak_rule_count; i++)
+	{
+		printf(" line%u:%u", _soak_rules[i].line, _soak_rules[i].uses);
+	}
+	printf("\n\n");
+
+	printf("INVARIANTS\n");
+	printf("  refused espconn calls    connect %u, send %u, send before sent cb %u, disconnect %u, abort %u, secure %u\n",
+			espconn_socket_stats.bad_connect, espconn_socket_stats.bad_send, espconn_socket_stats.send_busy,
+			espconn_socket_stats.bad_disconnect, espconn_socket_stats.bad_abort, espconn_socket_stats.bad_secure);
+	printf("  requests without data ready %u, data ready without request %u\n", _soak_stats.missed, _soak_stats.extra);
+	printf("  wrong values %u\n", _soak_stats.wrong_value);
+	printf("  stuck %u, long cycles %u\n", _soak_stats.stuck, _soak_stats.long_cycles);
+	printf("  os_zalloc after init %u (%d bytes), sockets open after stop %u\n", host_heap.calls,
+			(int)(host_heap.bytes - heap_bytes), espconn_socket_stats.open);
+	for(i = 0; i < SOAK_INSTANCES; i++)
+	{
+		errors += (ESP8266_TCP_GET_GetState(&_soak_instances[i].tcp_get) == ESP8266_TCP_GET_STATE_ERROR);
+		handshakes += _soak_instances[i].tcp_get.stats.tls_full_handshakes;
+		tls_open += _soak_instances[i].tcp_get.stats.tls_cycles_on_open_connection;
+	}
+	printf("  TLS handshakes %u (library counted %u), cycles on an open TLS connection %u\n",
+			espconn_socket_stats.handshakes, handshakes, tls_open);
+	printf("  instances in error state %u, arena bytes lost %u (after %u subscriber changes)\n", errors,
+			_soak_stats.arena_lost, _soak_stats.subscriber_changes);
+
+	failures = espconn_socket_stats.bad_connect + espconn_socket_stats.bad_send + espconn_socket_stats.send_busy +
+				espconn_socket_stats.bad_disconnect + espconn_socket_stats.bad_abort + espconn_socket_stats.bad_secure + _soak_stats.missed +
+				_soak_stats.extra + _soak_stats.wrong_value + _soak_stats.stuck + _soak_stats.long_cycles +
+				host_heap.calls + (host_heap.bytes != heap_bytes) + espconn_socket_stats.open + errors +
+				(_soak_stats.arena_lost != 0) + (handshakes != espconn_socket_stats.handshakes) +
+				(tls_open == 0);
+	printf("%s\n", (failures == 0) ? "PASS" : "FAIL");
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+//ESP8266_TCP_GET HOST HARNESS
+//RANDOMIZED ARM / CANCEL TEST OF THE TIMER WHEEL
+//
+//WHEEL_TEST_TIMERS TIMERS ARE ARMED, RE-ARMED AND CANCELLED AT RANDOM, WITH DELAYS FROM
+//0 ms TO 20 HOURS, WHILE THE VIRTUAL CLOCK (host.c) MOVES IN RANDOM STEPS. THE WHEEL'S
+//os_timer SOMETIMES FIRES LATE, AS IT DOES ON A BUSY DEVICE. THE TIMER CALLBACKS ALSO
+//ARM AND CANCEL OTHER TIMERS. THE CLOCK STARTS JUST BEFORE system_get_time WRAPS
+//
+//CHECKS
+//	A TIMER FIRES ONLY IF IT IS PENDING, AND NOT BEFORE ITS DELAY
+//	IT FIRES NO LATER THAN ITS DELAY + ITS SLACK (1/16 OF THE DELAY, AT MOST 1 s) +
+//	TWO TICKS + THE LATENESS OF THE os_timer
+//	A TIMER IS PENDING (pprev != NULL) EXACTLY WHEN THE TEST EXPECTS IT TO BE, AND
+//	ESP8266_TCP_GET_GetDeadlines LISTS THEM ALL
+//	WHILE A TIMER IS PENDING THE os_timer IS ARMED, FOR AT MOST
+//	ESP8266_TCP_GET_WHEEL_MAX_SLEEP_MS
+//	AT THE END EVERY PENDING TIMER FIRES
+//
+//usage: wheel_test [-n steps] [-s seed]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ESP8266_TCP_GET.h"
+#include "host.h"
+
+#define WHEEL_TEST_TIMERS			200
+#define WHEEL_TEST_DEFAULT_STEPS	1000000
+#define WHEEL_TEST_MAX_LATE_US		3000 //LATENESS OF THE os_timer
+#define WHEEL_TEST_START_US			(0x100000000ULL - 30000000ULL)
+
+typedef struct
+{
+	ESP8266_TCP_GET_TIMER timer;
+	uint8_t pending;
+	uint32_t delay_ms;
+	uint64_t due_us;
+}WHEEL_TEST_TIMER;
+
+typedef struct
+{
+	uint32_t arms;
+	uint32_t cancels;
+	uint32_t fired;
+	uint32_t early;
+	uint32_t late;
+	uint32_t not_pending; //FIRED WITHOUT BEING PENDING
+	uint32_t mismatch; //pprev DISAGREES WITH THE TEST
+	uint32_t deadlines; //ESP8266_TCP_GET_GetDeadlines MISSES OR ADDS A TIMER
+	uint32_t os_timer; //os_timer OFF OR ARMED TOO LONG WITH TIMERS PENDING
+	uint32_t never_fired;
+	int64_t late_max_us; //LATEST FIRING PAST THE DELAY
+}WHEEL_TEST_STATS;
+
+static WHEEL_TEST_TIMER _wheel_test_timers[WHEEL_TEST_TIMERS];
+static WHEEL_TEST_STATS _wheel_test_stats;
+
+static void _wheel_test_error(uint32_t* counter, const char* what, int i)
+{
+	(*counter)++;
+	if(*counter <= 5)
+	{
+		printf("%s: timer %d, delay %u ms, due %llu us, now %llu us\n", what, i, _wheel_test_timers[i].delay_ms,
+				(unsigned long long)_wheel_test_timers[i].due_us, (unsigned long long)host_time_us());
+	}
+}
+
+static void _wheel_test_arm(int i, uint32_t ms)
+{
+	_esp8266_tcp_get_timer_arm(&_wheel_test_timers[i].timer, ms);
+	_wheel_test_timers[i].pending = 1;
+	_wheel_test_timers[i].delay_ms = ms;
+	_wheel_test_timers[i].due_us = host_time_us() + (uint64_t)ms * 1000;
+	_wheel_test_stats.arms++;
+}
+
+static void _wheel_test_cancel(int i)
+{
+	_esp8266_tcp_get_timer_cancel(&_wheel_test_timers[i].timer);
+	_wheel_test_timers[i].pending = 0;
+	_wheel_test_stats.cancels++;
+}
+
+static uint32_t _wheel_test_delay(void)
+{
+	//HALF SHORT, THE REST UP TO A MINUTE, AN HOUR OR 20 HOURS
+	uint32_t pick = host_random() % 10;
+
+	if(pick < 5)
+	{
+		return host_random() % 2000;
+	}
+	if(pick < 8)
+	{
+		return host_random() % 60000;
+	}
+	if(pick < 9)
+	{
+		return host_random() % 3600000;
+	}
+	return host_random() % (20 * 3600000);
+}
+
+static void _wheel_test_fire(void* arg)
+{
+	int i = (int)(intptr_t)arg;
+	WHEEL_TEST_TIMER* t = &_wheel_test_timers[i];
+	uint64_t slack_ms;
+	int64_t late_us;
+
+	if(!t->pending)
+	{
+		_wheel_test_error(&_wheel_test_stats.not_pending, "FIRED NOT PENDING", i);
+		return;
+	}
+	t->pending = 0;
+	_wheel_test_stats.fired++;
+
+	slack_ms = t->delay_ms >> ESP8266_TCP_GET_WHEEL_SLACK_SHIFT;
+	slack_ms = (slack_ms > ESP8266_TCP_GET_WHEEL_MAX_SLACK_MS) ? ESP8266_TCP_GET_WHEEL_MAX_SLACK_MS : slack_ms;
+	late_us = (int64_t)(host_time_us() - t->due_us);
+	if(late_us < -(int64_t)ESP8266_TCP_GET_WHEEL_TICK_MS * 1000)
+	{
+		_wheel_test_error(&_wheel_test_stats.early, "EARLY", i);
+	}
+	if(late_us > (int64_t)((slack_ms + 2 * ESP8266_TCP_GET_WHEEL_TICK_MS) * 1000 + WHEEL_TEST_MAX_LATE_US))
+	{
+		_wheel_test_error(&_wheel_test_stats.late, "LATE", i);
+	}
+	if(late_us > _wheel_test_stats.late_max_us)
+	{
+		_wheel_test_stats.late_max_us = late_us;
+	}
+
+	//CALLBACKS ARM AND CANCEL TIMERS TOO
+	if(host_random() % 3 == 0)
+	{
+		_wheel_test_arm(host_random() % WHEEL_TEST_TIMERS, host_random() % 5000);
+	}
+	if(host_random() % 4 == 0)
+	{
+		_wheel_test_cancel(host_random() % WHEEL_TEST_TIMERS);
+	}
+}
+
+static void _wheel_test_step(void)
+{
+	//MOVE THE CLOCK UP TO 3 s. IF THE WHEEL'S os_timer IS DUE BY THEN, FIRE IT,
+	//SOMETIMES A LITTLE LATE
+	uint64_t step_us = (uint64_t)(host_random() % 3000) * 1000;
+	uint64_t due_us;
+
+	if(host_next_timer(&due_us) && due_us <= host_time_us() + step_us)
+	{
+		due_us += host_random() % (WHEEL_TEST_MAX_LATE_US + 1);
+		host_set_time_us((due_us > host_time_us()) ? due_us : host_time_us());
+		host_run_until(host_time_us());
+	}
+	else
+	{
+		host_run_until(host_time_us() + step_us);
+	}
+}
+
+static void _wheel_test_check(void)
+{
+	ESP8266_TCP_GET_DEADLINE deadlines[WHEEL_TEST_TIMERS + 1];
+	uint8_t count = ESP8266_TCP_GET_GetDeadlines(deadlines, WHEEL_TEST_TIMERS + 1, NULL);
+	uint32_t pending = 0;
+	uint64_t due_us;
+	int i;
+
+	for(i = 0; i < WHEEL_TEST_TIMERS; i++)
+	{
+		if(_wheel_test_timers[i].pending != (_wheel_test_timers[i].timer.pprev != NULL))
+		{
+			_wheel_test_error(&_wheel_test_stats.mismatch, "PENDING MISMATCH", i);
+			_wheel_test_timers[i].pending = (_wheel_test_timers[i].timer.pprev != NULL);
+		}
+		pending += _wheel_test_timers[i].pending;
+	}
+	if(count != pending)
+	{
+		_wheel_test_stats.deadlines++;
+		if(_wheel_test_stats.deadlines <= 5)
+		{
+			printf("GetDeadlines LISTS %u, %u PENDING\n", count, pending);
+		}
+	}
+	if(pending != 0 && (!host_next_timer(&due_us) ||
+		due_us > host_time_us() + (uint64_t)ESP8266_TCP_GET_WHEEL_MAX_SLEEP_MS * 1000))
+	{
+		_wheel_test_stats.os_timer++;
+		if(_wheel_test_stats.os_timer <= 5)
+		{
+			printf("%u PENDING, os_timer OFF OR ARMED BEYOND THE LONGEST SLEEP\n", pending);
+		}
+	}
+}
+
+static void _wheel_test_usage(void)
+{
+	fprintf(stderr, "usage: wheel_test [-n steps] [-s seed]\n");
+	exit(2);
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t steps = WHEEL_TEST_DEFAULT_STEPS;
+	uint32_t seed = 1;
+	uint32_t step;
+	uint32_t pick;
+	uint32_t wakes;
+	uint32_t failures;
+	uint64_t due_us;
+	int i;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(i + 1 < argc && strcmp(argv[i], "-n") == 0)
+		{
+			steps = (uint32_t)atol(argv[++i]);
+		}
+		else if(i + 1 < argc && strcmp(argv[i], "-s") == 0)
+		{
+			seed = (uint32_t)atol(argv[++i]);
+		}
+		else
+		{
+			_wheel_test_usage();
+		}
+	}
+
+	host_seed(seed);
+	host_set_time_us(WHEEL_TEST_START_US);
+	for(i = 0; i < WHEEL_TEST_TIMERS; i++)
+	{
+		_esp8266_tcp_get_timer_setup(&_wheel_test_timers[i].timer, _wheel_test_fire, (void*)(intptr_t)i,
+										ESP8266_TCP_GET_DEADLINE_CYCLE);
+	}
+
+	//40% ARM, 15% CANCEL, 45% MOVE THE CLOCK
+	for(step = 0; step < steps; step++)
+	{
+		pick = host_random() % 100;
+		if(pick < 40)
+		{
+			_wheel_test_arm(host_random() % WHEEL_TEST_TIMERS, _wheel_test_delay());
+		}
+		else if(pick < 55)
+		{
+			_wheel_test_cancel(host_random() % WHEEL_TEST_TIMERS);
+		}
+		else
+		{
+			_wheel_test_step();
+		}
+		_wheel_test_check();
+	}
+
+	//DRAIN. EVERY PENDING TIMER MUST FIRE
+	while(host_next_timer(&due_us))
+	{
+		host_run_until(due_us);
+	}
+	for(i = 0; i < WHEEL_TEST_TIMERS; i++)
+	{
+		if(_wheel_test_timers[i].pending)
+		{
+			_wheel_test_error(&_wheel_test_stats.never_fired, "NEVER FIRED", i);
+		}
+	}
+
+	ESP8266_TCP_GET_GetDeadlines(NULL, 0, &wakes);
+	printf("%u steps over %llu s of virtual time (seed %u)\n", steps,
+			(unsigned long long)((host_time_us() - WHEEL_TEST_START_US) / 1000000), seed);
+	printf("arms %u, cancels %u, fired %u, wheel wake-ups %u, latest firing %lld us past the delay\n",
+			_wheel_test_stats.arms, _wheel_test_stats.cancels, _wheel_test_stats.fired, wakes,
+			(long long)_wheel_test_stats.late_max_us);
+	printf("early %u, late %u, fired not pending %u, pending mismatch %u, GetDeadlines %u, os_timer %u, never fired %u\n",
+			_wheel_test_stats.early, _wheel_test_stats.late, _wheel_test_stats.not_pending, _wheel_test_stats.mismatch,
+			_wheel_test_stats.deadlines, _wheel_test_stats.os_timer, _wheel_test_stats.never_fired);
+
+	failures = _wheel_test_stats.early + _wheel_test_stats.late + _wheel_test_stats.not_pending +
+				_wheel_test_stats.mismatch + _wheel_test_stats.deadlines + _wheel_test_stats.os_timer +
+				_wheel_test_stats.never_fired;
+	printf("%s\n", (failures == 0) ? "PASS" : "FAIL");
+	return (failures == 0) ? 0 : 1;
+}
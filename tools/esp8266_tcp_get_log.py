@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""
+ESP8266 TCP GET LOG DECODER
+
+Turns the binary log records of the library (ESP8266_TCP_GET_SetLogDrain,
+ESP8266_TCP_GET_ReadLog) back into text. The event texts come from the
+ESP8266_TCP_GET_LOG_EVENT enum in ESP8266_TCP_GET.h, so the decoder always
+matches the header it is given.
+
+    python tools/esp8266_tcp_get_log.py capture.bin
+    python tools/esp8266_tcp_get_log.py --serial /dev/ttyUSB0 --baud 115200
+
+FRAME
+-----
+    A5 5A  time (4)  event (1)  instance (1)  a (2)  b (4)  checksum (1)
+
+Little endian. time is system_get_time() in us. instance is the order of
+ESP8266_TCP_GET_Initialize from 1 (0 = not about an instance). The checksum
+is the low byte of the sum of the 12 record bytes. Bytes outside frames
+(other UART output of the application) are skipped, so the log can share the
+UART with os_printf.
+
+OUTPUT
+------
+    <seconds>  #<instance>  <event text>
+
+{a} and {b} in the event text are the record numbers, {sa} is a as a signed number and
+{ip} is b as an IP address.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+SYNC = b'\xa5\x5a'
+FRAME_SIZE = 15
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'ESP8266_TCP_GET.h')
+
+EVENT = re.compile(r'^\s*ESP8266_TCP_GET_LOG_EVENT_(\w+)\s*=\s*(\d+)\s*,?\s*//(.*?)\s*$')
+
+
+def load_events(path):
+    #EVENT NUMBER TO (NAME, TEXT) FROM THE HEADER ENUM
+    events = {}
+    with open(path, 'r') as f:
+        for line in f:
+            m = EVENT.match(line)
+            if m:
+                events[int(m.group(2))] = (m.group(1), m.group(3))
+    if not events:
+        raise IOError('no ESP8266_TCP_GET_LOG_EVENT entries in %s' % path)
+    return events
+
+
+def ip(value):
+    return '%d.%d.%d.%d' % (value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, value >> 24)
+
+
+def text(events, event, a, b):
+    if event not in events:
+        return 'UNKNOWN EVENT %d (a = %d, b = %d)' % (event, a, b)
+    sa = a - 0x10000 if a & 0x8000 else a
+    out = events[event][1]
+    out = out.replace('{sa}', str(sa)).replace('{ip}', ip(b))
+    return out.replace('{a}', str(a)).replace('{b}', str(b))
+
+
+def frames(data):
+    #(RECORD, BAD FRAMES) FOR EVERY FRAME IN data. RETURNS THE UNUSED TAIL
+    records = []
+    bad = 0
+    i = 0
+    while True:
+        i = data.find(SYNC, i)
+        if i < 0 or len(data) - i < FRAME_SIZE:
+            break
+        body = data[i + 2:i + FRAME_SIZE - 1]
+        if sum(bytearray(body)) & 0xFF != bytearray(data)[i + FRAME_SIZE - 1]:
+            bad += 1
+            i += 1
+            continue
+        records.append(struct.unpack('<IBBHI', body))
+        i += FRAME_SIZE
+    tail = data[i:] if i >= 0 else data[-1:]
+    return records, bad, tail
+
+
+def decode(events, chunks, out):
+    pending = b''
+    bad = 0
+    for chunk in chunks:
+        records, errors, pending = frames(pending + chunk)
+        bad += errors
+        for (time, event, instance, a, b) in records:
+            out.write('%11.6f  #%d  %s\n' % (time / 1e6, instance, text(events, event, a, b)))
+        out.flush()
+    return bad
+
+
+def read_file(path):
+    with open(path, 'rb') as f:
+        while True:
+            chunk = f.read(4096)
+            if not chunk:
+                return
+            yield chunk
+
+
+def read_serial(port, baud):
+    import serial
+    with serial.Serial(port, baud, timeout=0.1) as s:
+        while True:
+            chunk = s.read(256)
+            if chunk:
+                yield chunk
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode ESP8266 TCP GET binary log records')
+    parser.add_argument('capture', nargs='?', help='captured UART bytes (default: stdin)')
+    parser.add_argument('--serial', help='read a serial port instead (needs pyserial)')
+    parser.add_argument('--baud', type=int, default=115200, help='serial port baud rate')
+    parser.add_argument('--header', default=HEADER, help='ESP8266_TCP_GET.h the firmware was built with')
+    args = parser.parse_args()
+
+    try:
+        events = load_events(args.header)
+    except IOError as e:
+        sys.stderr.write('error: %s\n' % e)
+        return 1
+
+    if args.serial:
+        chunks = read_serial(args.serial, args.baud)
+    elif args.capture:
+        chunks = read_file(args.capture)
+    else:
+        chunks = read_file(sys.stdin.fileno())
+
+    try:
+        bad = decode(events, chunks, sys.stdout)
+    except KeyboardInterrupt:
+        return 0
+    except IOError as e:
+        sys.stderr.write('error: %s\n' % e)
+        return 1
+    if bad:
+        sys.stderr.write('%d bad frames skipped\n' % bad)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
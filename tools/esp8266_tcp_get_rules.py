@@ -0,0 +1,456 @@
+#!/usr/bin/env python3
+"""
+ESP8266 TCP GET RULE COMPILER
+
+Turns a rule file into a C header with the extractor automaton, rules and
+match strings as const ICACHE_RODATA_ATTR tables (ESP8266_TCP_GET_RULE_TABLE),
+plus the RAM result arrays and user data containers that go with them.
+
+    python tools/esp8266_tcp_get_rules.py weather.rules -o user/weather_rules.h
+
+RULE FILE
+---------
+One statement per line. '#' starts a comment. Strings are in double quotes
+with C escapes (\\r \\n \\t \\0 \\" \\\\ \\xHH).
+
+    container <name> [terminator "<chars>"] [double-buffer]
+    field <name> "<match string>" [offset <n>] [length <n>] [until "<char>"] [on-change]
+
+The first container is the main container, the others are subscribers in
+the order they are passed to ESP8266_TCP_GET_Subscribe. Only the first
+container can have a terminator (the packet terminating chars).
+
+offset  : data offset from the start of the match string. Default = length
+          of the match string (data right after it)
+length  : fixed data length. Default 0 = data runs till the until char
+until   : data terminating char. Default "\\0" = data runs to the end of the reply
+on-change : only call the data ready callback if this field changed
+"""
+
+import argparse
+import os
+import re
+import sys
+
+RULE_TABLE_VERSION = 1
+AC_NO_PATTERN = 0xFF
+FNV_OFFSET_BASIS = 2166136261
+FNV_PRIME = 16777619
+DATA_SIZE = 50
+TERMINATOR_SIZE = 10
+
+TOKEN = re.compile(r'"((?:[^"\\]|\\.)*)"|(\S+)')
+
+
+class RuleError(Exception):
+    pass
+
+
+class Field(object):
+    def __init__(self, name, match, offset, length, until, on_change):
+        self.name = name
+        self.match = match
+        self.offset = offset
+        self.length = length
+        self.until = until
+        self.on_change = on_change
+
+
+class Container(object):
+    def __init__(self, name, terminator, double_buffer):
+        self.name = name
+        self.terminator = terminator
+        self.double_buffer = double_buffer
+        self.fields = []
+
+
+def unescape(text):
+    #C STYLE ESCAPES TO BYTES
+    out = bytearray()
+    i = 0
+    while i < len(text):
+        c = text[i]
+        if c != '\\':
+            out += c.encode('latin-1')
+            i += 1
+            continue
+        i += 1
+        if i >= len(text):
+            raise RuleError('trailing backslash')
+        c = text[i]
+        if c == 'x':
+            digits = re.match(r'[0-9a-fA-F]{1,2}', text[i + 1:])
+            if digits is None:
+                raise RuleError('bad \\x escape')
+            out.append(int(digits.group(0), 16))
+            i += 1 + len(digits.group(0))
+            continue
+        simple = {'r': 13, 'n': 10, 't': 9, '0': 0, '"': 34, '\\': 92}
+        if c not in simple:
+            raise RuleError('unknown escape \\%s' % c)
+        out.append(simple[c])
+        i += 1
+    return bytes(out)
+
+
+def tokenize(line):
+    #LIST OF (IS_STRING, VALUE)
+    tokens = []
+    for m in TOKEN.finditer(line):
+        if m.group(1) is not None:
+            tokens.append((True, unescape(m.group(1))))
+        elif m.group(2).startswith('#'):
+            break
+        else:
+            tokens.append((False, m.group(2)))
+    return tokens
+
+
+def c_name(name):
+    if not re.match(r'^[A-Za-z_][A-Za-z0-9_]*$', name):
+        raise RuleError('"%s" is not a C identifier' % name)
+    return name
+
+
+def number(tokens, i, limit):
+    if i >= len(tokens) or tokens[i][0]:
+        raise RuleError('number expected')
+    try:
+        value = int(tokens[i][1], 0)
+    except ValueError:
+        raise RuleError('"%s" is not a number' % tokens[i][1])
+    if value < 0 or value > limit:
+        raise RuleError('%d out of range 0-%d' % (value, limit))
+    return value
+
+
+def string(tokens, i):
+    if i >= len(tokens) or not tokens[i][0]:
+        raise RuleError('quoted string expected')
+    return tokens[i][1]
+
+
+def parse(path):
+    containers = []
+    with open(path, 'r', encoding='latin-1') as f:
+        for line_number, line in enumerate(f, 1):
+            try:
+                tokens = tokenize(line.strip())
+                if not tokens:
+                    continue
+                if tokens[0][0]:
+                    raise RuleError('statement expected')
+                keyword = tokens[0][1]
+
+                if keyword == 'container':
+                    if len(tokens) < 2 or tokens[1][0]:
+                        raise RuleError('container name expected')
+                    container = Container(c_name(tokens[1][1]), b'', False)
+                    i = 2
+                    while i < len(tokens):
+                        option = tokens[i][1]
+                        if option == 'terminator':
+                            if containers:
+                                raise RuleError('only the first (main) container has a terminator')
+                            container.terminator = string(tokens, i + 1)
+                            if len(container.terminator) > TERMINATOR_SIZE - 1 or b'\0' in container.terminator:
+                                raise RuleError('terminator is 1 to %d chars' % (TERMINATOR_SIZE - 1))
+                            i += 2
+                        elif option == 'double-buffer':
+                            container.double_buffer = True
+                            i += 1
+                        else:
+                            raise RuleError('unknown container option "%s"' % option)
+                    if any(c.name == container.name for c in containers):
+                        raise RuleError('container "%s" defined twice' % container.name)
+                    containers.append(container)
+
+                elif keyword == 'field':
+                    if not containers:
+                        raise RuleError('field before the first container')
+                    if len(tokens) < 3 or tokens[1][0]:
+                        raise RuleError('field name and match string expected')
+                    name = c_name(tokens[1][1])
+                    match = string(tokens, 2)
+                    if len(match) > DATA_SIZE - 1 or b'\0' in match:
+                        raise RuleError('match string is up to %d chars' % (DATA_SIZE - 1))
+                    field = Field(name, match, len(match), 0, 0, False)
+                    i = 3
+                    while i < len(tokens):
+                        option = tokens[i][1]
+                        if option == 'offset':
+                            field.offset = number(tokens, i + 1, 255)
+                            i += 2
+                        elif option == 'length':
+                            field.length = number(tokens, i + 1, DATA_SIZE - 1)
+                            i += 2
+                        elif option == 'until':
+                            until = string(tokens, i + 1)
+                            if len(until) != 1:
+                                raise RuleError('until takes one char')
+                            field.until = until[0]
+                            i += 2
+                        elif option == 'on-change':
+                            field.on_change = True
+                            i += 1
+                        else:
+                            raise RuleError('unknown field option "%s"' % option)
+                    if any(x.name == name for x in containers[-1].fields):
+                        raise RuleError('field "%s" defined twice' % name)
+                    containers[-1].fields.append(field)
+
+                else:
+                    raise RuleError('unknown statement "%s"' % keyword)
+            except RuleError as e:
+                raise RuleError('%s:%d: %s' % (path, line_number, e))
+
+    if not containers:
+        raise RuleError('%s: no containers' % path)
+    if sum(len(c.fields) for c in containers) > AC_NO_PATTERN - 1:
+        raise RuleError('%s: more than %d fields' % (path, AC_NO_PATTERN - 1))
+    return containers
+
+
+def json_path_hash(path):
+    #SAME AS _esp8266_tcp_get_json_path_hash
+    def segment(parent, value):
+        return ((parent ^ value) * FNV_PRIME) & 0xFFFFFFFF
+
+    h = FNV_OFFSET_BASIS
+    i = 0
+    while i < len(path):
+        c = path[i]
+        if c == ord('.'):
+            i += 1
+        elif c == ord('['):
+            index = 0
+            i += 1
+            while i < len(path) and ord('0') <= path[i] <= ord('9'):
+                index = (index * 10 + path[i] - ord('0')) & 0xFFFF
+                i += 1
+            if i < len(path) and path[i] == ord(']'):
+                i += 1
+            h = segment(h, ((index + 1) * 0x9E3779B9) & 0xFFFFFFFF)
+        else:
+            key = FNV_OFFSET_BASIS
+            while i < len(path) and path[i] not in (ord('.'), ord('[')):
+                key = ((key ^ path[i]) * FNV_PRIME) & 0xFFFFFFFF
+                i += 1
+            h = segment(h, key)
+    return h
+
+
+def build(patterns):
+    #AHO-CORASICK AUTOMATON, BUILT THE SAME WAY AS _esp8266_tcp_get_extractor_build
+    #NODE = [CHILD, SIBLING, FAIL, OUTPUT, CHAR, PATTERN]
+    nodes = [[0, 0, 0, 0, 0, AC_NO_PATTERN]]
+    pattern_next = []
+
+    for p, pattern in enumerate(patterns):
+        pattern_next.append(AC_NO_PATTERN)
+        if not pattern:
+            continue
+        u = 0
+        for c in pattern:
+            v = nodes[u][0]
+            while v != 0 and nodes[v][4] != c:
+                v = nodes[v][1]
+            if v == 0:
+                v = len(nodes)
+                nodes.append([0, nodes[u][0], 0, 0, c, AC_NO_PATTERN])
+                nodes[u][0] = v
+            u = v
+        pattern_next[p] = nodes[u][5]
+        nodes[u][5] = p
+
+    def child(node, c):
+        v = nodes[node][0]
+        while v != 0 and nodes[v][4] != c:
+            v = nodes[v][1]
+        return v
+
+    queue = []
+    v = nodes[0][0]
+    while v != 0:
+        nodes[v][2] = 0
+        nodes[v][3] = v if nodes[v][5] != AC_NO_PATTERN else 0
+        queue.append(v)
+        v = nodes[v][1]
+    head = 0
+    while head < len(queue):
+        u = queue[head]
+        head += 1
+        v = nodes[u][0]
+        while v != 0:
+            f = nodes[u][2]
+            while True:
+                w = child(f, nodes[v][4])
+                if w != 0 or f == 0:
+                    break
+                f = nodes[f][2]
+            nodes[v][2] = w
+            nodes[v][3] = v if nodes[v][5] != AC_NO_PATTERN else nodes[w][3]
+            queue.append(v)
+            v = nodes[v][1]
+
+    if len(nodes) > 0xFFFF:
+        raise RuleError('automaton has more than 65535 nodes')
+    return nodes, pattern_next
+
+
+def c_string(data):
+    out = ''
+    for b in bytearray(data):
+        if b == 34 or b == 92:
+            out += '\\' + chr(b)
+        elif 32 <= b < 127:
+            out += chr(b)
+        else:
+            out += '\\%03o' % b
+    return out
+
+
+def c_char(b):
+    if b == 39 or b == 92:
+        return "'\\%s'" % chr(b)
+    if 32 <= b < 127:
+        return "'%s'" % chr(b)
+    return "'\\x%02X'" % b
+
+
+def emit(containers, source, prefix):
+    fields = [f for c in containers for f in c.fields]
+    patterns = [f.match for f in fields] + [containers[0].terminator]
+    nodes, pattern_next = build(patterns)
+
+    #MATCH STRINGS, NULL TERMINATED, PACKED 4 CHARS PER WORD (LITTLE ENDIAN)
+    strings = bytearray()
+    offsets = []
+    for pattern in patterns:
+        at = bytes(strings).find(pattern + b'\0')
+        if at < 0:
+            at = len(strings)
+            strings += pattern + b'\0'
+        offsets.append(at)
+    if len(strings) > 0xFFFF:
+        raise RuleError('match strings take more than 65535 bytes')
+    while len(strings) % 4 != 0:
+        strings.append(0)
+    words = [strings[i] | (strings[i + 1] << 8) | (strings[i + 2] << 16) | (strings[i + 3] << 24)
+             for i in range(0, len(strings), 4)]
+
+    guard = '_%s_H_' % prefix.upper()
+    out = []
+    out.append('//GENERATED BY tools/esp8266_tcp_get_rules.py FROM %s. DO NOT EDIT' % os.path.basename(source))
+    out.append('//INCLUDE IN ONE SOURCE FILE ONLY')
+    out.append('')
+    out.append('#ifndef %s' % guard)
+    out.append('#define %s' % guard)
+    out.append('')
+    out.append('#include "ESP8266_TCP_GET.h"')
+    out.append('')
+
+    for container in containers:
+        for i, field in enumerate(container.fields):
+            out.append('#define %s_%s_%s\t%d' % (prefix.upper(), container.name.upper(), field.name.upper(), i))
+    out.append('')
+
+    out.append('//LINKS = CHILD | SIBLING << 16, FAIL = FAIL | OUTPUT << 16, MATCH = CHAR | PATTERN << 8')
+    out.append('static const ESP8266_TCP_GET_AC_NODE %s_nodes[%d] ICACHE_RODATA_ATTR STORE_ATTR =' % (prefix, len(nodes)))
+    out.append('{')
+    for n, node in enumerate(nodes):
+        out.append('\t{0x%08X, 0x%08X, 0x%08X}, //%d' % (node[0] | (node[1] << 16), node[2] | (node[3] << 16),
+                                                      node[4] | (node[5] << 8), n))
+    out.append('};')
+    out.append('')
+
+    out.append('//MATCH = STRING OFFSET | LENGTH << 16 | NEXT PATTERN << 24, DATA = OFFSET | LENGTH << 8 | UNTIL << 16')
+    out.append('static const ESP8266_TCP_GET_RULE %s_rules[%d] ICACHE_RODATA_ATTR STORE_ATTR =' % (prefix, len(patterns)))
+    out.append('{')
+    for p, pattern in enumerate(patterns):
+        field = fields[p] if p < len(fields) else None
+        data = (field.offset | (field.length << 8) | (field.until << 16)) if field is not None else 0
+        out.append('\t{0x%08X, 0x%08X, 0x%08X}, //"%s"' % (offsets[p] | (len(pattern) << 16) | (pattern_next[p] << 24),
+                                                       data, json_path_hash(pattern), c_string(pattern)))
+    out.append('};')
+    out.append('')
+
+    out.append('static const uint32_t %s_strings[%d] ICACHE_RODATA_ATTR STORE_ATTR =' % (prefix, len(words)))
+    out.append('{')
+    for i in range(0, len(words), 6):
+        out.append('\t' + ' '.join('0x%08X,' % w for w in words[i:i + 6]))
+    out.append('};')
+    out.append('')
+
+    out.append('static const ESP8266_TCP_GET_RULE_TABLE %s_rule_table ICACHE_RODATA_ATTR STORE_ATTR =' % prefix)
+    out.append('{')
+    out.append('\t%s_nodes,' % prefix)
+    out.append('\t%s_rules,' % prefix)
+    out.append('\t%s_strings,' % prefix)
+    out.append('\t%d,' % len(nodes))
+    out.append('\t%d,' % len(fields))
+    out.append('\t%d' % RULE_TABLE_VERSION)
+    out.append('};')
+    out.append('')
+
+    #RESULT STATE IN RAM. WITHOUT ESP8266_TCP_GET_FLASH_RULES THE RULES ARE ALSO
+    #WRITTEN INTO THE RAM STRUCTURES SO THE CONTAINERS WORK WITHOUT THE TABLE TOO
+    for container in containers:
+        arrays = ['%s_%s_data' % (prefix, container.name)]
+        if container.double_buffer:
+            arrays.append('%s_%s_back_data' % (prefix, container.name))
+        for array in arrays:
+            out.append('static ESP8266_TCP_GET_EXTRACTED_DATA %s[%d] =' % (array, max(len(container.fields), 1)))
+            out.append('{')
+            if not container.fields:
+                out.append('\t{0}')
+            for field in container.fields:
+                out.append('\t{')
+                out.append('#ifndef ESP8266_TCP_GET_FLASH_RULES')
+                out.append('\t\t.extracted_data_start_match_string = "%s",' % c_string(field.match))
+                out.append('\t\t.extracted_data_offset_from_match_string = %d,' % field.offset)
+                out.append('\t\t.extracted_data_char_len = %d,' % field.length)
+                out.append('\t\t.extracted_data_terminating_char = %s,' % c_char(field.until))
+                out.append('#endif')
+                out.append('\t\t.notify_only_on_change = %d' % (1 if field.on_change else 0))
+                out.append('\t},')
+            out.append('};')
+            out.append('')
+        out.append('static ESP8266_TCP_GET_USER_DATA_CONTAINER %s_%s =' % (prefix, container.name))
+        out.append('{')
+        if container is containers[0]:
+            out.append('#ifndef ESP8266_TCP_GET_FLASH_RULES')
+            out.append('\t.tcp_reply_packet_terminating_chars = "%s",' % c_string(container.terminator))
+            out.append('#endif')
+        out.append('\t.tcp_reply_extracted_data_count = %d,' % len(container.fields))
+        out.append('\t.tcp_reply_extracted_data = %s,' % arrays[0])
+        out.append('\t.tcp_reply_back_data = %s' % (arrays[1] if container.double_buffer else 'NULL'))
+        out.append('};')
+        out.append('')
+
+    out.append('#endif')
+    return '\r\n'.join(out) + '\r\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compile an ESP8266 TCP GET rule file into flash tables')
+    parser.add_argument('rules', help='rule file')
+    parser.add_argument('-o', '--output', required=True, help='generated C header')
+    parser.add_argument('-p', '--prefix', help='C name prefix (default: output file name)')
+    args = parser.parse_args()
+
+    prefix = args.prefix or os.path.splitext(os.path.basename(args.output))[0]
+    try:
+        containers = parse(args.rules)
+        header = emit(containers, args.rules, c_name(prefix))
+    except (RuleError, IOError) as e:
+        sys.stderr.write('error: %s\n' % e)
+        return 1
+
+    with open(args.output, 'wb') as f:
+        f.write(header.encode('latin-1'))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())